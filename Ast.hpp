@@ -3,8 +3,12 @@
 #include <iostream>
 #include <unordered_map>
 #include <vector>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
 #include "RegisterManager.hpp"
 #include "SymbolTable.hpp"
+#include "MipsRuntime.hpp"
 
 struct CodePlace
 {
@@ -12,11 +16,209 @@ struct CodePlace
     std::string place;
 };
 
+// Traslada las variables de un cuerpo clonado al marco de otra función
+struct VarRemap
+{
+    std::string sourceFunction;
+    std::string functionName;
+    std::string prefix;
+    std::unordered_map<std::string, std::string> names;
+
+    std::string rename(const std::string &varName) const
+    {
+        auto it = names.find(varName);
+        if (it != names.end())
+        {
+            return it->second;
+        }
+        if (SymbolTable::isGlobal(sourceFunction, varName))
+        {
+            return varName;
+        }
+        return prefix + varName;
+    }
+
+    std::string map(const std::string &varName) const
+    {
+        std::string mapped = rename(varName);
+        if (!SymbolTable::isGlobal(functionName, mapped))
+        {
+            SymbolTable::setVarOffset(functionName, mapped);
+        }
+        return mapped;
+    }
+};
+
+// Operando de memoria de una variable escalar: local en el marco o global en .data
+inline std::string varOperand(VarRef ref)
+{
+    if (SymbolTable::isGlobal(ref))
+    {
+        return SymbolTable::getGlobalLabel(ref);
+    }
+    return std::to_string(SymbolTable::getVarOffset(ref)) + "($sp)";
+}
+
+// Marco de la función cuyo código se está generando. De abajo hacia arriba:
+// argumentos salientes (5.º en adelante), locales, $ra y temporales preservados.
+struct FrameInfo
+{
+    // Se sustituye por la liberación del marco cuando se conoce su tamaño final
+    static constexpr const char *EPILOGUE_MARK = "# epilogue\n";
+
+    std::string functionName;
+    std::string entryLabel;
+    std::string exitLabel;
+    std::vector<VarRef> params;
+    int raOffset = 0;
+    int saveOffset = 0;
+    int maxSavedTemps = 0;
+    // Valores que esperan en el área de saveOffset mientras se evalúa otra
+    // expresión; las llamadas guardan sus temporales después de ellos
+    int spilled = 0;
+    bool hasCalls = false;
+    // Ramas menos ejecutadas según el perfil; van después del jr $ra
+    std::string coldCode;
+};
+
+inline FrameInfo &currentFrame()
+{
+    static FrameInfo frame;
+    return frame;
+}
+
+// Guarda en el marco un temporal que debe sobrevivir a la evaluación de otra
+// expresión cuando no alcanzan los registros, y lo libera. Las ranuras se
+// ocupan como una pila: quien guarda restablece frame.spilled al terminar
+inline std::string spillTemp(const std::string &reg, int &slot)
+{
+    FrameInfo &frame = currentFrame();
+    slot = frame.saveOffset + 4 * frame.spilled++;
+    frame.maxSavedTemps = std::max(frame.maxSavedTemps, frame.spilled);
+    freeTempRegister(reg);
+    return "sw " + reg + ", " + std::to_string(slot) + "($sp)\n";
+}
+
+inline std::string reloadTemp(std::string &reg, int slot)
+{
+    reg = allocateTempRegister();
+    return "lw " + reg + ", " + std::to_string(slot) + "($sp)\n";
+}
+
+// Opciones de generación elegidas desde la línea de comandos
+struct CodeGenOptions
+{
+    static constexpr const char *BOUNDS_FAIL_LABEL = "__bounds_fail";
+
+    bool boundsCheck = false;
+    // Con --instrument, archivo donde el programa deja sus contadores al terminar
+    bool instrument = false;
+    std::string profileFile = "minicpp.prof";
+};
+
+inline CodeGenOptions &codeGenOptions()
+{
+    static CodeGenOptions options;
+    return options;
+}
+
+// Lo que el código generado pidió del runtime de E/S
+struct RuntimeUsage
+{
+    bool io = false;
+    std::vector<std::string> strings; // literales de cout, en .data como __str_N
+};
+
+inline RuntimeUsage &runtimeUsage()
+{
+    static RuntimeUsage usage;
+    return usage;
+}
+
+// Punto del programa fuente que cuenta --instrument: "function f", "if f n" o
+// "while f n", con n el orden del if o while dentro de f. Sus contadores son
+// los de __prof_counts desde first: la entrada a la función; la rama then y
+// la else; o las veces que se llega al ciclo y las vueltas que da.
+struct ProfileSite
+{
+    std::string label;
+    int first;
+    int counters;
+    std::vector<long long> counts; // leídos con --profile-use; vacío si no aparecen
+};
+
+inline std::vector<ProfileSite> &profileSites()
+{
+    static std::vector<ProfileSite> sites;
+    return sites;
+}
+
+// Incrementa un contador del sitio (sin --instrument o sin sitio, nada).
+// $v1 está libre entre sentencias
+inline std::string profileIncrement(int site, int counter = 0)
+{
+    if (!codeGenOptions().instrument || site < 0)
+    {
+        return "";
+    }
+    std::string slot = "__prof_counts+" + std::to_string(4 * (profileSites()[site].first + counter));
+    return "lw $v1, " + slot + "\naddi $v1, $v1, 1\nsw $v1, " + slot + "\n";
+}
+
+// Valor registrado de un contador del sitio, o -1 si no hay perfil para él
+inline long long profileCount(int site, int counter)
+{
+    if (site < 0 || site >= static_cast<int>(profileSites().size()))
+    {
+        return -1;
+    }
+    const std::vector<long long> &counts = profileSites()[site].counts;
+    return counter < static_cast<int>(counts.size()) ? counts[counter] : -1;
+}
+
+// Llamada a una rutina de MipsRuntime. No toca los temporales, así que solo
+// obliga a la función a guardar $ra
+inline std::string runtimeCall(const char *routine)
+{
+    currentFrame().hasCalls = true;
+    runtimeUsage().io = true;
+    return "jal " + std::string(routine) + "\n";
+}
+
 class AstNode
 {
 public:
     virtual ~AstNode() = default;
     virtual CodePlace generateCode() = 0;
+    virtual AstNode *clone(const VarRemap *remap = nullptr) const = 0;
+    virtual void forEachChild(const std::function<void(AstNode *&)> &/*fn*/) {}
+    virtual void setTailPosition() {}
+
+    // Temporales que ocupa a la vez la evaluación del subárbol (numeración de
+    // Sethi-Ullman). Por omisión, el mayor de sus hijos y al menos el resultado
+    virtual int registerNeed()
+    {
+        int need = 1;
+        forEachChild([&](AstNode *&child)
+        {
+            if (child)
+            {
+                need = std::max(need, child->registerNeed());
+            }
+        });
+        return need;
+    }
+
+    // Si evaluar el subárbol llama a alguna función
+    virtual bool hasCalls()
+    {
+        bool calls = false;
+        forEachChild([&](AstNode *&child)
+        {
+            calls = calls || (child && child->hasCalls());
+        });
+        return calls;
+    }
 };
 
 class BinaryExpr : public AstNode
@@ -32,6 +234,94 @@ public:
         delete left;
         delete right;
     }
+
+    AstNode *getLeft() const { return left; }
+    AstNode *getRight() const { return right; }
+
+    void forEachChild(const std::function<void(AstNode *&)> &fn) override
+    {
+        fn(left);
+        fn(right);
+    }
+
+    // Se calcula una vez, al generar código, cuando el árbol ya no cambia
+    int registerNeed() override
+    {
+        if (need == 0)
+        {
+            int leftNeed = left->registerNeed();
+            int rightNeed = right->registerNeed();
+            need = leftNeed == rightNeed ? leftNeed + 1 : std::max(leftNeed, rightNeed);
+            calls = left->hasCalls() || right->hasCalls();
+        }
+        return need;
+    }
+
+    bool hasCalls() override
+    {
+        registerNeed();
+        return calls;
+    }
+
+protected:
+    template <typename T>
+    AstNode *cloneAs(const VarRemap *remap) const
+    {
+        return new T(left->clone(remap), right->clone(remap));
+    }
+
+    // Evalúa primero el operando que necesita más temporales, así el otro se
+    // calcula con uno solo ocupado. Con llamadas solo se invierte el orden si
+    // el operando que se adelanta no cambia por ellas. Si el segundo necesita
+    // más temporales de los libres, el primero espera en el marco. Los
+    // registros de ambos quedan libres para el resultado.
+    std::string generateOperands(CodePlace &leftCode, CodePlace &rightCode)
+    {
+        bool rightFirst = right->registerNeed() > left->registerNeed() &&
+                          (!hasCalls() || isStableAcross(left, right) || isStableAcross(right, left));
+        AstNode *second = rightFirst ? left : right;
+        CodePlace &firstCode = rightFirst ? rightCode : leftCode;
+        CodePlace &secondCode = rightFirst ? leftCode : rightCode;
+
+        firstCode = (rightFirst ? right : left)->generateCode();
+        std::string code = firstCode.code;
+
+        FrameInfo &frame = currentFrame();
+        int mark = frame.spilled;
+        int slot = -1;
+        if (static_cast<size_t>(second->registerNeed()) > freeTempRegisterCount())
+        {
+            code += spillTemp(firstCode.place, slot);
+        }
+        secondCode = second->generateCode();
+        code += secondCode.code;
+        if (slot >= 0)
+        {
+            code += reloadTemp(firstCode.place, slot);
+            frame.spilled = mark;
+        }
+
+        freeTempRegister(leftCode.place);
+        freeTempRegister(rightCode.place);
+        return code;
+    }
+
+    // Si las llamadas de other no pueden cambiar el valor de node: node no
+    // llama a nada y solo lee constantes y escalares locales que other no pasa
+    // por referencia
+    static bool isStableAcross(AstNode *node, AstNode *other)
+    {
+        std::vector<VarRef> passed;
+        collectReferenceArgs(other, passed);
+        return readsOnlyLocals(node, passed);
+    }
+
+    static void collectReferenceArgs(AstNode *node, std::vector<VarRef> &passed);
+    static bool readsOnlyLocals(AstNode *node, const std::vector<VarRef> &passed);
+
+private:
+    int need = 0;
+    bool calls = false;
 };
 
 class AddExpr : public BinaryExpr
@@ -39,16 +329,17 @@ class AddExpr : public BinaryExpr
 public:
     using BinaryExpr::BinaryExpr;
 
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        return cloneAs<AddExpr>(remap);
+    }
+
     CodePlace generateCode() override
     {
-        CodePlace result;
-        CodePlace leftCode = left->generateCode();
-        CodePlace rightCode = right->generateCode();
+        CodePlace result, leftCode, rightCode;
+        result.code = generateOperands(leftCode, rightCode);
         result.place = allocateTempRegister();
-        result.code = leftCode.code + rightCode.code +
-                      "add " + result.place + ", " + leftCode.place + ", " + rightCode.place + "\n";
-        freeTempRegister(leftCode.place);
-        freeTempRegister(rightCode.place);
+        result.code += "add " + result.place + ", " + leftCode.place + ", " + rightCode.place + "\n";
         return result;
     }
 };
@@ -58,16 +349,17 @@ class SubExpr : public BinaryExpr
 public:
     using BinaryExpr::BinaryExpr;
 
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        return cloneAs<SubExpr>(remap);
+    }
+
     CodePlace generateCode() override
     {
-        CodePlace result;
-        CodePlace leftCode = left->generateCode();
-        CodePlace rightCode = right->generateCode();
+        CodePlace result, leftCode, rightCode;
+        result.code = generateOperands(leftCode, rightCode);
         result.place = allocateTempRegister();
-        result.code = leftCode.code + rightCode.code +
-                      "sub " + result.place + ", " + leftCode.place + ", " + rightCode.place + "\n";
-        freeTempRegister(leftCode.place);
-        freeTempRegister(rightCode.place);
+        result.code += "sub " + result.place + ", " + leftCode.place + ", " + rightCode.place + "\n";
         return result;
     }
 };
@@ -77,17 +369,18 @@ class MulExpr : public BinaryExpr
 public:
     using BinaryExpr::BinaryExpr;
 
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        return cloneAs<MulExpr>(remap);
+    }
+
     CodePlace generateCode() override
     {
-        CodePlace result;
-        CodePlace leftCode = left->generateCode();
-        CodePlace rightCode = right->generateCode();
+        CodePlace result, leftCode, rightCode;
+        result.code = generateOperands(leftCode, rightCode);
         result.place = allocateTempRegister();
-        result.code = leftCode.code + rightCode.code +
-                      "mult " + leftCode.place + ", " + rightCode.place + "\n";
+        result.code += "mult " + leftCode.place + ", " + rightCode.place + "\n";
         result.code += "mflo " + result.place + "\n";
-        freeTempRegister(leftCode.place);
-        freeTempRegister(rightCode.place);
         return result;
     }
 };
@@ -97,17 +390,18 @@ class DivExpr : public BinaryExpr
 public:
     using BinaryExpr::BinaryExpr;
 
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        return cloneAs<DivExpr>(remap);
+    }
+
     CodePlace generateCode() override
     {
-        CodePlace result;
-        CodePlace leftCode = left->generateCode();
-        CodePlace rightCode = right->generateCode();
+        CodePlace result, leftCode, rightCode;
+        result.code = generateOperands(leftCode, rightCode);
         result.place = allocateTempRegister();
-        result.code = leftCode.code + rightCode.code +
-                      "div " + leftCode.place + ", " + rightCode.place + "\n";
+        result.code += "div " + leftCode.place + ", " + rightCode.place + "\n";
         result.code += "mflo " + result.place + "\n";
-        freeTempRegister(leftCode.place);
-        freeTempRegister(rightCode.place);
         return result;
     }
 };
@@ -119,6 +413,13 @@ class ValueExpr : public AstNode
 public:
     ValueExpr(double value) : value(value) {}
 
+    double getValue() const { return value; }
+
+    AstNode *clone(const VarRemap *) const override
+    {
+        return new ValueExpr(value);
+    }
+
     CodePlace generateCode() override
     {
         CodePlace result;
@@ -132,11 +433,32 @@ class VariableExpr : public AstNode
 {
     std::string functionName; 
     std::string varName;      
+    VarRef ref;
 
 public:
     
     VariableExpr(const std::string &functionName, const std::string &varName)
-        : functionName(functionName), varName(varName) {}
+        : functionName(functionName), varName(varName), ref(SymbolTable::resolve(functionName, varName)) {}
+
+    const std::string &getVarName() const { return varName; }
+    VarRef getVarRef() const { return ref; }
+    void setVarRef(VarRef binding) { ref = binding; }
+
+    bool isReference() const { return SymbolTable::isReference(ref); }
+
+    bool isFrameAddress() const
+    {
+        return !isReference() && !SymbolTable::isGlobal(ref);
+    }
+
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        if (remap)
+        {
+            return new VariableExpr(remap->functionName, remap->map(varName));
+        }
+        return new VariableExpr(functionName, varName);
+    }
 
     CodePlace generateCode() override
     {
@@ -144,11 +466,32 @@ public:
         result.place = allocateTempRegister();
 
         
-        int offset = SymbolTable::getVarOffset(functionName, varName);
+        result.code = "lw " + result.place + ", " + varOperand(ref) + "\n";
+        if (isReference())
+        {
+            result.code += "lw " + result.place + ", 0(" + result.place + ")\n";
+        }
 
-        
-        result.code = "lw " + result.place + ", " + std::to_string(offset) + "($sp)\n";
+        return result;
+    }
 
+    CodePlace generateAddress()
+    {
+        CodePlace result;
+        result.place = allocateTempRegister();
+        if (SymbolTable::isGlobal(ref))
+        {
+            result.code = "la " + result.place + ", " + SymbolTable::getGlobalLabel(ref) + "\n";
+        }
+        else if (isReference())
+        {
+            result.code = "lw " + result.place + ", " + varOperand(ref) + "\n";
+        }
+        else
+        {
+            int offset = SymbolTable::getVarOffset(ref);
+            result.code = "addi " + result.place + ", $sp, " + std::to_string(offset) + "\n";
+        }
         return result;
     }
 };
@@ -159,27 +502,59 @@ class AssignExpr : public AstNode
     std::string functionName; 
     std::string varName;      
     AstNode *expr;            
+    VarRef ref;
 
 public:
     
     AssignExpr(const std::string &functionName, const std::string &varName, AstNode *expr)
-        : functionName(functionName), varName(varName), expr(expr)
+        : functionName(functionName), varName(varName), expr(expr), ref(SymbolTable::resolve(functionName, varName))
     {
         
-        SymbolTable::setVarOffset(functionName, varName);
+        if (!SymbolTable::isGlobal(ref))
+        {
+            SymbolTable::allocate(ref);
+        }
     }
 
     ~AssignExpr() { delete expr; }
 
+    const std::string &getVarName() const { return varName; }
+    VarRef getVarRef() const { return ref; }
+    AstNode *getExpr() const { return expr; }
+
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        if (remap)
+        {
+            return new AssignExpr(remap->functionName, remap->map(varName), expr->clone(remap));
+        }
+        return new AssignExpr(functionName, varName, expr->clone());
+    }
+
+    void forEachChild(const std::function<void(AstNode *&)> &fn) override
+    {
+        fn(expr);
+    }
+
     CodePlace generateCode() override
     {
         CodePlace result = expr->generateCode();
 
         
-        int offset = SymbolTable::getVarOffset(functionName, varName);
+        std::string operand = varOperand(ref);
 
         
-        result.code += "sw " + result.place + ", " + std::to_string(offset) + "($sp)\n";
+        if (SymbolTable::isReference(ref))
+        {
+            std::string address = allocateTempRegister();
+            result.code += "lw " + address + ", " + operand + "\n";
+            result.code += "sw " + result.place + ", 0(" + address + ")\n";
+            freeTempRegister(address);
+        }
+        else
+        {
+            result.code += "sw " + result.place + ", " + operand + "\n";
+        }
 
         return result;
     }
@@ -194,14 +569,25 @@ public:
     PrintStmt(AstNode *expr) : expr(expr) {}
     ~PrintStmt() { delete expr; }
 
+    AstNode *getExpr() const { return expr; }
+
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        return new PrintStmt(expr->clone(remap));
+    }
+
+    void forEachChild(const std::function<void(AstNode *&)> &fn) override
+    {
+        fn(expr);
+    }
+
     CodePlace generateCode() override
     {
         
         CodePlace result = expr->generateCode();
  
         result.code += "move $a0, " + result.place + "\n";
-        result.code += "li $v0, 1\n";
-        result.code += "syscall\n";
+        result.code += runtimeCall(MipsRuntime::PRINT_INT);
 
         return result;
     }
@@ -209,37 +595,232 @@ public:
 
 class ProgramNode : public AstNode
 {
+    std::vector<AstNode *> globals;
     std::vector<AstNode *> statements;
 
 public:
     ~ProgramNode()
     {
+        for (AstNode *global : globals)
+        {
+            delete global;
+        }
         for (AstNode *stmt : statements)
         {
             delete stmt;
         }
     }
 
+    void addGlobal(AstNode *decl)
+    {
+        globals.push_back(decl);
+    }
+
+    std::vector<AstNode *> &getGlobals() { return globals; }
+
     void addFunction(AstNode *func)
     {
         statements.push_back(func);  
     }
-    
+
+    std::vector<AstNode *> &getFunctions() { return statements; }
+
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        ProgramNode *copy = new ProgramNode();
+        for (AstNode *global : globals)
+        {
+            copy->addGlobal(global->clone(remap));
+        }
+        for (AstNode *stmt : statements)
+        {
+            copy->addFunction(stmt->clone(remap));
+        }
+        return copy;
+    }
+
+    void forEachChild(const std::function<void(AstNode *&)> &fn) override
+    {
+        for (AstNode *&global : globals)
+        {
+            fn(global);
+        }
+        for (AstNode *&stmt : statements)
+        {
+            fn(stmt);
+        }
+    }
 
     CodePlace generateCode() override
     {
         CodePlace result;
         
-        result.code = ".text\n";
-        result.code += "jal main\n";
+        // Las funciones van primero: así se sabe si usan el runtime de E/S
+        runtimeUsage() = RuntimeUsage();
+        std::string functions;
         for (auto &stmt : statements)
         {
             CodePlace stmtCode = stmt->generateCode();
-            result.code += stmtCode.code;
+            functions += stmtCode.code;
         }
 
+        result.code = dataCode(globals);
+        result.code += ".text\n";
+        result.code += "jal main\n";
+        result.code += exitCode();
+        result.code += functions;
+        result.code += supportCode();
+
         return result;
     }
+
+    // Las piezas que rodean a las funciones; --stream (StreamCompiler) las
+    // escribe después de la última función, cuando runtimeUsage ya está completo.
+
+    // Sección .data con los globales, los búferes y las cadenas; vacía si no hace falta
+    static std::string dataCode(const std::vector<AstNode *> &globals)
+    {
+        std::string code;
+        RuntimeUsage &usage = runtimeUsage();
+        bool instrument = codeGenOptions().instrument;
+        bool boundsCheck = codeGenOptions().boundsCheck;
+        if (globals.empty() && !boundsCheck && !usesRuntime())
+        {
+            return code;
+        }
+
+        code = ".data\n";
+        for (auto &global : globals)
+        {
+            code += global->generateCode().code;
+        }
+        if (usesRuntime())
+        {
+            code += MipsRuntime::data();
+        }
+        if (instrument)
+        {
+            int counters = profileSites().empty() ? 0 : profileSites().back().first + profileSites().back().counters;
+            code += "__prof_counts: .space " + std::to_string(4 * std::max(counters, 1)) + "\n";
+            code += "__prof_file: .asciiz " + MipsRuntime::quote(codeGenOptions().profileFile) + "\n";
+            for (size_t i = 0; i < profileSites().size(); ++i)
+            {
+                code += "__prof_site_" + std::to_string(i) + ": .asciiz " +
+                        MipsRuntime::quote(profileSites()[i].label) + "\n";
+            }
+        }
+        if (boundsCheck)
+        {
+            code += "__bounds_msg: .asciiz \"Error: array index out of bounds\\n\"\n";
+        }
+        for (size_t i = 0; i < usage.strings.size(); ++i)
+        {
+            code += "__str_" + std::to_string(i) + ": .asciiz " + MipsRuntime::quote(usage.strings[i]) + "\n";
+        }
+        return code;
+    }
+
+    // Lo que sigue al regreso de main: volcar el perfil y la salida, y terminar
+    static std::string exitCode()
+    {
+        std::string code;
+        if (codeGenOptions().instrument)
+        {
+            code += "jal __prof_dump\n";
+        }
+        if (usesRuntime())
+        {
+            code += "jal " + std::string(MipsRuntime::FLUSH) + "\n";
+        }
+        code += "li $v0, 10\n";
+        code += "syscall\n";
+        return code;
+    }
+
+    // Rutinas al final de .text: el fallo de --bounds-check, el runtime de E/S y el volcado del perfil
+    static std::string supportCode()
+    {
+        std::string code;
+        if (codeGenOptions().boundsCheck)
+        {
+            code += std::string(CodeGenOptions::BOUNDS_FAIL_LABEL) + ":\n";
+            if (usesRuntime())
+            {
+                code += "jal " + std::string(MipsRuntime::FLUSH) + "\n";
+            }
+            code += "la $a0, __bounds_msg\n";
+            code += "li $v0, 4\n";
+            code += "syscall\n";
+            code += "li $a0, 1\n";
+            code += "li $v0, 17\n";
+            code += "syscall\n";
+        }
+        if (usesRuntime())
+        {
+            code += MipsRuntime::code();
+        }
+        if (codeGenOptions().instrument)
+        {
+            code += profileDumpCode();
+        }
+        return code;
+    }
+
+private:
+    // Los contadores se escriben con las rutinas de salida del runtime
+    static bool usesRuntime()
+    {
+        return runtimeUsage().io || codeGenOptions().instrument;
+    }
+
+    // Escribe en el archivo de perfil una línea por sitio: la etiqueta y sus
+    // contadores separados por espacios. Si el archivo no se puede crear, los
+    // contadores salen por la salida estándar
+    static std::string profileDumpCode()
+    {
+        std::string code = "__prof_dump:\n";
+        code += "addi $sp, $sp, -4\n";
+        code += "sw $ra, 0($sp)\n";
+        code += "jal " + std::string(MipsRuntime::FLUSH) + "\n";
+        code += "la $a0, __prof_file\n";
+        code += "li $a1, 577\n"; // O_WRONLY | O_CREAT | O_TRUNC
+        code += "li $a2, 420\n"; // 0644
+        code += "li $v0, 13\n";
+        code += "syscall\n";
+        code += "slt $v1, $v0, $zero\n";
+        code += "bnez $v1, __prof_dump_sites\n";
+        code += "sw $v0, " + std::string(MipsRuntime::OUTPUT_FD) + "\n";
+        code += "__prof_dump_sites:\n";
+
+        const std::vector<ProfileSite> &sites = profileSites();
+        for (size_t i = 0; i < sites.size(); ++i)
+        {
+            code += "la $a0, __prof_site_" + std::to_string(i) + "\n";
+            code += "jal " + std::string(MipsRuntime::PRINT_STRING) + "\n";
+            for (int counter = 0; counter < sites[i].counters; ++counter)
+            {
+                code += "li $a0, 32\n";
+                code += "jal " + std::string(MipsRuntime::PRINT_CHAR) + "\n";
+                code += "lw $a0, __prof_counts+" + std::to_string(4 * (sites[i].first + counter)) + "\n";
+                code += "jal " + std::string(MipsRuntime::PRINT_INT) + "\n";
+            }
+            code += "li $a0, 10\n";
+            code += "jal " + std::string(MipsRuntime::PRINT_CHAR) + "\n";
+        }
+
+        code += "jal " + std::string(MipsRuntime::FLUSH) + "\n";
+        code += "lw $a0, " + std::string(MipsRuntime::OUTPUT_FD) + "\n";
+        code += "li $v1, 1\n";
+        code += "beq $a0, $v1, __prof_dump_end\n";
+        code += "li $v0, 16\n";
+        code += "syscall\n";
+        code += "sw $v1, " + std::string(MipsRuntime::OUTPUT_FD) + "\n";
+        code += "__prof_dump_end:\n";
+        code += "lw $ra, 0($sp)\n";
+        code += "addi $sp, $sp, 4\n";
+        code += "jr $ra\n";
+        return code;
+    }
 };
 
 
@@ -261,26 +842,60 @@ public:
         expressions.push_back(expr);
     }
 
-    CodePlace generateCode() override
+    std::vector<AstNode *> &getExpressions() { return expressions; }
+
+    void setTailPosition() override
     {
-        CodePlace result;
-        for (auto &expr : expressions)
+        if (!expressions.empty())
         {
-            CodePlace exprCode = expr->generateCode();
-            result.code += exprCode.code;
+            expressions.back()->setTailPosition();
         }
-        return result;
     }
-};
 
-class FunctionCallExpr : public AstNode
-{
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        ExprList *copy = new ExprList();
+        for (AstNode *expr : expressions)
+        {
+            copy->addExpression(expr->clone(remap));
+        }
+        return copy;
+    }
+
+    void forEachChild(const std::function<void(AstNode *&)> &fn) override
+    {
+        for (AstNode *&expr : expressions)
+        {
+            fn(expr);
+        }
+    }
+
+    CodePlace generateCode() override
+    {
+        CodePlace result;
+        for (auto &expr : expressions)
+        {
+            CodePlace exprCode = expr->generateCode();
+            result.code += exprCode.code;
+            if (!exprCode.place.empty())
+            {
+                freeTempRegister(exprCode.place);
+            }
+        }
+        return result;
+    }
+};
+
+class FunctionCallExpr : public AstNode
+{
     std::string functionName;
+    int calleeId;
     std::vector<AstNode *> arguments;
+    bool tailCall = false;
 
 public:
     FunctionCallExpr(const std::string &functionName, std::vector<AstNode *> args)
-        : functionName(functionName), arguments(std::move(args)) {}
+        : functionName(functionName), calleeId(SymbolTable::functionId(functionName)), arguments(std::move(args)) {}
 
     ~FunctionCallExpr()
     {
@@ -290,62 +905,294 @@ public:
         }
     }
 
-    CodePlace generateCode() override
+    const std::string &getFunctionName() const { return functionName; }
+    int getCalleeId() const { return calleeId; }
+    const std::vector<AstNode *> &getArguments() const { return arguments; }
+
+    std::vector<AstNode *> releaseArguments()
     {
-        CodePlace result;
-        std::vector<std::string> argRegisters;
+        std::vector<AstNode *> args;
+        args.swap(arguments);
+        return args;
+    }
 
-        
-        for (auto &arg : arguments)
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        std::vector<AstNode *> args;
+        for (AstNode *arg : arguments)
+        {
+            args.push_back(arg->clone(remap));
+        }
+        return new FunctionCallExpr(functionName, args);
+    }
+
+    void forEachChild(const std::function<void(AstNode *&)> &fn) override
+    {
+        for (AstNode *&arg : arguments)
+        {
+            fn(arg);
+        }
+    }
+
+    void setTailPosition() override
+    {
+        tailCall = true;
+    }
+
+    bool hasCalls() override
+    {
+        return true;
+    }
+
+    // Cada argumento ya evaluado ocupa un registro mientras se evalúan los siguientes
+    int registerNeed() override
+    {
+        int need = 1;
+        for (size_t i = 0; i < arguments.size(); ++i)
+        {
+            need = std::max(need, arguments[i]->registerNeed() + static_cast<int>(i));
+        }
+        return need;
+    }
+
+    CodePlace generateCode() override
+    {
+        if (tailCall && canTailCall())
         {
-            CodePlace argCode = arg->generateCode();
-            result.code += argCode.code;
-            argRegisters.push_back(argCode.place); 
+            return generateTailCall();
         }
 
+        CodePlace result;
+        FrameInfo &frame = currentFrame();
+        std::vector<int> slots;
+        std::vector<std::string> argRegisters = generateArguments(result.code, slots);
+
         
         for (size_t i = 0; i < argRegisters.size(); ++i)
         {
             if (i < 4) 
             {
-                result.code += "move $a" + std::to_string(i) + ", " + argRegisters[i] + "\n";
+                result.code += passArgument(argRegisters[i], slots[i], "$a" + std::to_string(i));
             }
             else
             {
                 
-                result.code += "sw " + argRegisters[i] + ", " + std::to_string(i * 4) + "($sp)\n";
+                result.code += passArgument(argRegisters[i], slots[i], std::to_string((i - 4) * 4) + "($sp)");
             }
-            freeTempRegister(argRegisters[i]);
         }
 
-        
+        // Solo se preservan los temporales que siguen vivos después de la llamada,
+        // después de los valores que ya esperan en el marco
+        std::vector<std::string> live = liveTempRegisters();
+        int saveBase = frame.saveOffset + 4 * frame.spilled;
+        for (size_t i = 0; i < live.size(); ++i)
+        {
+            result.code += "sw " + live[i] + ", " + std::to_string(saveBase + 4 * i) + "($sp)\n";
+        }
+        frame.maxSavedTemps = std::max(frame.maxSavedTemps, frame.spilled + static_cast<int>(live.size()));
+        frame.hasCalls = true;
+
         result.code += "jal " + functionName + "\n";
+
+        for (size_t i = 0; i < live.size(); ++i)
+        {
+            result.code += "lw " + live[i] + ", " + std::to_string(saveBase + 4 * i) + "($sp)\n";
+        }
         
         
         result.place = allocateTempRegister();
         result.code += "move " + result.place + ", $v0\n";
 
+        return result;
+    }
+
+private:
+    // Evalúa los argumentos de izquierda a derecha. Si el siguiente necesita
+    // más temporales de los libres, los ya evaluados esperan en el marco:
+    // slots[i] es su ranura, o -1 si el argumento quedó en su registro. Las
+    // ranuras se leen enseguida, así que se liberan al volver
+    std::vector<std::string> generateArguments(std::string &code, std::vector<int> &slots)
+    {
+        FrameInfo &frame = currentFrame();
+        int mark = frame.spilled;
+        std::vector<std::string> places;
+
+        for (size_t i = 0; i < arguments.size(); ++i)
+        {
+            if (static_cast<size_t>(arguments[i]->registerNeed()) > freeTempRegisterCount())
+            {
+                for (size_t j = 0; j < i; ++j)
+                {
+                    if (slots[j] < 0)
+                    {
+                        code += spillTemp(places[j], slots[j]);
+                    }
+                }
+            }
+            CodePlace argCode = generateArgument(i);
+            code += argCode.code;
+            places.push_back(argCode.place);
+            slots.push_back(-1);
+        }
+
+        frame.spilled = mark;
+        return places;
+    }
+
+    // Lleva un argumento a dest, un registro $a o una palabra del marco. Uno
+    // que espera en el marco pasa por $v1 sin ocupar otro temporal
+    static std::string passArgument(const std::string &place, int slot, const std::string &dest)
+    {
+        bool toRegister = dest[0] == '$';
+        if (slot >= 0)
+        {
+            std::string from = std::to_string(slot) + "($sp)";
+            if (toRegister)
+            {
+                return "lw " + dest + ", " + from + "\n";
+            }
+            return "lw $v1, " + from + "\nsw $v1, " + dest + "\n";
+        }
+
+        freeTempRegister(place);
+        if (toRegister)
+        {
+            return "move " + dest + ", " + place + "\n";
+        }
+        return "sw " + place + ", " + dest + "\n";
+    }
+
+    // Los parámetros por referencia reciben la dirección de la variable
+    CodePlace generateArgument(size_t i)
+    {
+        if (!SymbolTable::isReferenceParam(calleeId, i))
+        {
+            return arguments[i]->generateCode();
+        }
+
+        VariableExpr *var = dynamic_cast<VariableExpr *>(arguments[i]);
+        if (!var)
+        {
+            throw std::runtime_error("Argument " + std::to_string(i + 1) + " of " + functionName +
+                                     " must be a variable (reference parameter)");
+        }
+        return var->generateAddress();
+    }
+
+    // Una dirección del marco actual no puede sobrevivir a su liberación
+    bool canTailCall() const
+    {
+        const FrameInfo &frame = currentFrame();
+        bool selfCall = functionName == frame.functionName && arguments.size() == frame.params.size();
+        if (!selfCall && arguments.size() > 4)
+        {
+            return false;
+        }
+        for (size_t i = 0; i < arguments.size(); ++i)
+        {
+            if (SymbolTable::isReferenceParam(calleeId, i))
+            {
+                VariableExpr *var = dynamic_cast<VariableExpr *>(arguments[i]);
+                if (!var || var->isFrameAddress())
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // La llamada en posición de cola reutiliza el marco actual en lugar de apilar otro
+    CodePlace generateTailCall()
+    {
+        CodePlace result;
+        const FrameInfo &frame = currentFrame();
+        std::vector<int> slots;
+        std::vector<std::string> argRegisters = generateArguments(result.code, slots);
+
+        bool selfCall = functionName == frame.functionName && arguments.size() == frame.params.size();
+        for (size_t i = 0; i < argRegisters.size(); ++i)
+        {
+            if (selfCall)
+            {
+                int offset = SymbolTable::getVarOffset(frame.params[i]);
+                result.code += passArgument(argRegisters[i], slots[i], std::to_string(offset) + "($sp)");
+            }
+            else
+            {
+                result.code += passArgument(argRegisters[i], slots[i], "$a" + std::to_string(i));
+            }
+        }
+
+        if (selfCall)
+        {
+            result.code += "j " + frame.entryLabel + "\n";
+        }
+        else
+        {
+            result.code += FrameInfo::EPILOGUE_MARK;
+            result.code += "j " + functionName + "\n";
+        }
+
         return result;
     }
 };
 
 
+// Variables que las llamadas del subárbol reciben por referencia
+inline void BinaryExpr::collectReferenceArgs(AstNode *node, std::vector<VarRef> &passed)
+{
+    if (FunctionCallExpr *call = dynamic_cast<FunctionCallExpr *>(node))
+    {
+        const std::vector<AstNode *> &args = call->getArguments();
+        for (size_t i = 0; i < args.size(); ++i)
+        {
+            VariableExpr *var = dynamic_cast<VariableExpr *>(args[i]);
+            if (var && SymbolTable::isReferenceParam(call->getCalleeId(), i))
+            {
+                passed.push_back(var->getVarRef());
+            }
+        }
+    }
+    node->forEachChild([&](AstNode *&child)
+    {
+        collectReferenceArgs(child, passed);
+    });
+}
+
+inline bool BinaryExpr::readsOnlyLocals(AstNode *node, const std::vector<VarRef> &passed)
+{
+    if (dynamic_cast<ValueExpr *>(node))
+    {
+        return true;
+    }
+    if (VariableExpr *var = dynamic_cast<VariableExpr *>(node))
+    {
+        VarRef ref = var->getVarRef();
+        return !SymbolTable::isGlobal(ref) && !SymbolTable::isReference(ref) &&
+               std::find(passed.begin(), passed.end(), ref) == passed.end();
+    }
+    BinaryExpr *binary = dynamic_cast<BinaryExpr *>(node);
+    return binary && readsOnlyLocals(binary->left, passed) && readsOnlyLocals(binary->right, passed);
+}
+
 class ModExpr : public BinaryExpr
 {
 public:
     using BinaryExpr::BinaryExpr;
 
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        return cloneAs<ModExpr>(remap);
+    }
+
     CodePlace generateCode() override
     {
-        CodePlace result;
-        CodePlace leftCode = left->generateCode();
-        CodePlace rightCode = right->generateCode();
+        CodePlace result, leftCode, rightCode;
+        result.code = generateOperands(leftCode, rightCode);
         result.place = allocateTempRegister();
-        result.code = leftCode.code + rightCode.code +
-                      "div " + leftCode.place + ", " + rightCode.place + "\n";
+        result.code += "div " + leftCode.place + ", " + rightCode.place + "\n";
         result.code += "mfhi " + result.place + "\n"; 
-        freeTempRegister(leftCode.place);
-        freeTempRegister(rightCode.place);
         return result;
     }
 };
@@ -355,19 +1202,17 @@ class GreaterExpr : public BinaryExpr
 public:
     using BinaryExpr::BinaryExpr;
 
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        return cloneAs<GreaterExpr>(remap);
+    }
+
     CodePlace generateCode() override
     {
-        CodePlace result;
-        CodePlace leftCode = left->generateCode();
-        CodePlace rightCode = right->generateCode();
+        CodePlace result, leftCode, rightCode;
+        result.code = generateOperands(leftCode, rightCode);
         result.place = allocateTempRegister();
-
-        
-        result.code = leftCode.code + rightCode.code +
-                      "slt " + result.place + ", " + rightCode.place + ", " + leftCode.place + "\n";
-
-        freeTempRegister(leftCode.place);
-        freeTempRegister(rightCode.place);
+        result.code += "slt " + result.place + ", " + rightCode.place + ", " + leftCode.place + "\n";
         return result;
     }
 };
@@ -377,19 +1222,17 @@ class LessExpr : public BinaryExpr
 public:
     using BinaryExpr::BinaryExpr;
 
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        return cloneAs<LessExpr>(remap);
+    }
+
     CodePlace generateCode() override
     {
-        CodePlace result;
-        CodePlace leftCode = left->generateCode();
-        CodePlace rightCode = right->generateCode();
+        CodePlace result, leftCode, rightCode;
+        result.code = generateOperands(leftCode, rightCode);
         result.place = allocateTempRegister();
-
-        
-        result.code = leftCode.code + rightCode.code +
-                      "slt " + result.place + ", " + leftCode.place + ", " + rightCode.place + "\n";
-
-        freeTempRegister(leftCode.place);
-        freeTempRegister(rightCode.place);
+        result.code += "slt " + result.place + ", " + leftCode.place + ", " + rightCode.place + "\n";
         return result;
     }
 };
@@ -399,20 +1242,18 @@ class GreaterEqualExpr : public BinaryExpr
 public:
     using BinaryExpr::BinaryExpr;
 
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        return cloneAs<GreaterEqualExpr>(remap);
+    }
+
     CodePlace generateCode() override
     {
-        CodePlace result;
-        CodePlace leftCode = left->generateCode();
-        CodePlace rightCode = right->generateCode();
+        CodePlace result, leftCode, rightCode;
+        result.code = generateOperands(leftCode, rightCode);
         result.place = allocateTempRegister();
-
-        
-        result.code = leftCode.code + rightCode.code +
-                      "slt " + result.place + ", " + leftCode.place + ", " + rightCode.place + "\n";
+        result.code += "slt " + result.place + ", " + leftCode.place + ", " + rightCode.place + "\n";
         result.code += "xori " + result.place + ", " + result.place + ", 1\n";  
-
-        freeTempRegister(leftCode.place);
-        freeTempRegister(rightCode.place);
         return result;
     }
 };
@@ -422,20 +1263,18 @@ class LessEqualExpr : public BinaryExpr
 public:
     using BinaryExpr::BinaryExpr;
 
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        return cloneAs<LessEqualExpr>(remap);
+    }
+
     CodePlace generateCode() override
     {
-        CodePlace result;
-        CodePlace leftCode = left->generateCode();
-        CodePlace rightCode = right->generateCode();
+        CodePlace result, leftCode, rightCode;
+        result.code = generateOperands(leftCode, rightCode);
         result.place = allocateTempRegister();
-
-        
-        result.code = leftCode.code + rightCode.code +
-                      "slt " + result.place + ", " + rightCode.place + ", " + leftCode.place + "\n";
+        result.code += "slt " + result.place + ", " + rightCode.place + ", " + leftCode.place + "\n";
         result.code += "xori " + result.place + ", " + result.place + ", 1\n";  
-
-        freeTempRegister(leftCode.place);
-        freeTempRegister(rightCode.place);
         return result;
     }
 };
@@ -445,20 +1284,18 @@ class NotEqualExpr : public BinaryExpr
 public:
     using BinaryExpr::BinaryExpr;
 
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        return cloneAs<NotEqualExpr>(remap);
+    }
+
     CodePlace generateCode() override
     {
-        CodePlace result;
-        CodePlace leftCode = left->generateCode();
-        CodePlace rightCode = right->generateCode();
+        CodePlace result, leftCode, rightCode;
+        result.code = generateOperands(leftCode, rightCode);
         result.place = allocateTempRegister();
-
-        
-        result.code = leftCode.code + rightCode.code +
-                      "xor " + result.place + ", " + leftCode.place + ", " + rightCode.place + "\n";
+        result.code += "xor " + result.place + ", " + leftCode.place + ", " + rightCode.place + "\n";
         result.code += "sltu " + result.place + ", $zero, " + result.place + "\n";  
-
-        freeTempRegister(leftCode.place);
-        freeTempRegister(rightCode.place);
         return result;
     }
 };
@@ -468,20 +1305,18 @@ class EqualExpr : public BinaryExpr
 public:
     using BinaryExpr::BinaryExpr;
 
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        return cloneAs<EqualExpr>(remap);
+    }
+
     CodePlace generateCode() override
     {
-        CodePlace result;
-        CodePlace leftCode = left->generateCode();
-        CodePlace rightCode = right->generateCode();
+        CodePlace result, leftCode, rightCode;
+        result.code = generateOperands(leftCode, rightCode);
         result.place = allocateTempRegister();
-
-        
-        result.code = leftCode.code + rightCode.code +
-                      "xor " + result.place + ", " + leftCode.place + ", " + rightCode.place + "\n";
+        result.code += "xor " + result.place + ", " + leftCode.place + ", " + rightCode.place + "\n";
         result.code += "sltiu " + result.place + ", " + result.place + ", 1\n";  
-
-        freeTempRegister(leftCode.place);
-        freeTempRegister(rightCode.place);
         return result;
     }
 };
@@ -491,19 +1326,17 @@ class AndExpr : public BinaryExpr
 public:
     using BinaryExpr::BinaryExpr;
 
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        return cloneAs<AndExpr>(remap);
+    }
+
     CodePlace generateCode() override
     {
-        CodePlace result;
-        CodePlace leftCode = left->generateCode();
-        CodePlace rightCode = right->generateCode();
+        CodePlace result, leftCode, rightCode;
+        result.code = generateOperands(leftCode, rightCode);
         result.place = allocateTempRegister();
-
-        
-        result.code = leftCode.code + rightCode.code +
-                      "and " + result.place + ", " + leftCode.place + ", " + rightCode.place + "\n";
-
-        freeTempRegister(leftCode.place);
-        freeTempRegister(rightCode.place);
+        result.code += "and " + result.place + ", " + leftCode.place + ", " + rightCode.place + "\n";
         return result;
     }
 };
@@ -513,19 +1346,17 @@ class OrExpr : public BinaryExpr
 public:
     using BinaryExpr::BinaryExpr;
 
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        return cloneAs<OrExpr>(remap);
+    }
+
     CodePlace generateCode() override
     {
-        CodePlace result;
-        CodePlace leftCode = left->generateCode();
-        CodePlace rightCode = right->generateCode();
+        CodePlace result, leftCode, rightCode;
+        result.code = generateOperands(leftCode, rightCode);
         result.place = allocateTempRegister();
-
-        
-        result.code = leftCode.code + rightCode.code +
-                      "or " + result.place + ", " + leftCode.place + ", " + rightCode.place + "\n";
-
-        freeTempRegister(leftCode.place);
-        freeTempRegister(rightCode.place);
+        result.code += "or " + result.place + ", " + leftCode.place + ", " + rightCode.place + "\n";
         return result;
     }
 };
@@ -537,6 +1368,21 @@ class StringLiteralExpr : public AstNode
 public:
     StringLiteralExpr(const std::string& value) : value(value) {}
 
+    // Texto sin las comillas del literal
+    std::string getText() const
+    {
+        if (!value.empty() && value.front() == '"' && value.back() == '"')
+        {
+            return value.substr(1, value.size() - 2);
+        }
+        return value;
+    }
+
+    AstNode *clone(const VarRemap *) const override
+    {
+        return new StringLiteralExpr(value);
+    }
+
     CodePlace generateCode() override
     {
         CodePlace result;
@@ -548,11 +1394,18 @@ public:
         }
 
         
-        for (char c : value)
+        // Un solo carácter no necesita la cadena en .data
+        if (value.size() == 1)
         {
-            result.code += "li $a0, " + std::to_string(static_cast<int>(c)) + "\n";  
-            result.code += "li $v0, 11\n";  
-            result.code += "syscall\n";
+            result.code += "li $a0, " + std::to_string(static_cast<int>(value[0])) + "\n";
+            result.code += runtimeCall(MipsRuntime::PRINT_CHAR);
+        }
+        else if (!value.empty())
+        {
+            std::vector<std::string> &strings = runtimeUsage().strings;
+            result.code += "la $a0, __str_" + std::to_string(strings.size()) + "\n";
+            result.code += runtimeCall(MipsRuntime::PRINT_STRING);
+            strings.push_back(value);
         }
 
 
@@ -563,12 +1416,16 @@ public:
 class EndlExpr : public AstNode
 {
 public:
+    AstNode *clone(const VarRemap *) const override
+    {
+        return new EndlExpr();
+    }
+
     CodePlace generateCode() override
     {
         CodePlace result;
         result.code = "li $a0, 10\n";  
-        result.code += "li $v0, 11\n";  
-        result.code += "syscall\n";
+        result.code += runtimeCall(MipsRuntime::PRINT_CHAR);
         return result;
     }
 };
@@ -577,9 +1434,30 @@ class VarDeclExpr : public AstNode
 {
     std::string functionName; 
     std::string varName;
+    int arraySize;
+    VarRef ref;
 
 public:
-    VarDeclExpr(const std::string&functionName,const std::string& varName) :functionName(functionName) , varName(varName) {}
+    // Un functionName vacío declara una variable global en .data
+    VarDeclExpr(const std::string&functionName,const std::string& varName, int arraySize = 0)
+        :functionName(functionName) , varName(varName), arraySize(arraySize),
+         ref(SymbolTable::declare(functionName, varName))
+    {
+        SymbolTable::allocate(ref, arraySize);
+    }
+
+    const std::string &getVarName() const { return varName; }
+    VarRef getVarRef() const { return ref; }
+    int getArraySize() const { return arraySize; }
+
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        if (remap)
+        {
+            return new VarDeclExpr(remap->functionName, remap->rename(varName), arraySize);
+        }
+        return new VarDeclExpr(functionName, varName, arraySize);
+    }
 
     CodePlace generateCode() override
     {
@@ -588,11 +1466,11 @@ public:
         result.place = "";  
 
         
-        SymbolTable::setVarOffset(functionName,varName);
-
-        
-        
-        result.code = "";  
+        if (functionName.empty())
+        {
+            result.code = SymbolTable::getGlobalLabel(ref) + ": .space " +
+                          std::to_string(4 * std::max(arraySize, 1)) + "\n";
+        }
 
         return result;
     }
@@ -603,21 +1481,43 @@ class ParamExpr : public AstNode
     std::string functionName; 
     std::string paramName;    
     bool isReference;         
+    int arraySize;
+    VarRef ref;
 
 public:
     
-    ParamExpr(const std::string& functionName, const std::string& paramName, bool isReference)
-        : functionName(functionName), paramName(paramName), isReference(isReference) {}
+    // Los parámetros arreglo se pasan por referencia a su primer elemento
+    ParamExpr(const std::string& functionName, const std::string& paramName, bool isReference, int arraySize = 0)
+        : functionName(functionName), paramName(paramName), isReference(isReference || arraySize > 0),
+          arraySize(arraySize), ref(SymbolTable::declare(functionName, paramName))
+    {
+        // El parámetro ocupa una palabra: el valor o la dirección del argumento
+        SymbolTable::allocate(ref);
+        if (this->isReference)
+        {
+            SymbolTable::setVarReference(functionName, paramName);
+        }
+        if (arraySize > 0)
+        {
+            SymbolTable::allocate(ref, arraySize);
+        }
+    }
+
+    const std::string &getParamName() const { return paramName; }
+    VarRef getVarRef() const { return ref; }
+    bool getIsReference() const { return isReference; }
+
+    AstNode *clone(const VarRemap *) const override
+    {
+        return new ParamExpr(functionName, paramName, isReference, arraySize);
+    }
 
     CodePlace generateCode() override
     {
         CodePlace result;
 
         
-        SymbolTable::setVarOffset(functionName, paramName);
-
-        
-        int offset = SymbolTable::getVarOffset(functionName, paramName);
+        int offset = SymbolTable::getVarOffset(ref);
 
         
         if (isReference)
@@ -643,7 +1543,12 @@ class TypeExpr : public AstNode
 public:
     TypeExpr(const std::string& typeName) : typeName(typeName) {}
 
-    CodePlace generateCode() override
+    AstNode *clone(const VarRemap *) const override
+    {
+        return new TypeExpr(typeName);
+    }
+
+    CodePlace generateCode() override
     {
         CodePlace result;
         result.code = "";  
@@ -662,17 +1567,22 @@ class FunctionDeclExpr : public AstNode
     std::string funcName;
     AstNode* returnType;
     AstNode* paramList;
+    std::vector<AstNode*> varDecls;
     std::vector<AstNode*> statements;
-    bool includeReturn;
+    int profileSite = -1;
 
 public:
-    FunctionDeclExpr(const std::string& name, AstNode* retType, AstNode* params, bool includeReturn = false)
-        : funcName(name), returnType(retType), paramList(params), includeReturn(includeReturn) {}
+    FunctionDeclExpr(const std::string& name, AstNode* retType, AstNode* params)
+        : funcName(name), returnType(retType), paramList(params) {}
 
     ~FunctionDeclExpr()
     {
         delete returnType;
         delete paramList;
+        for (auto decl : varDecls)
+        {
+            delete decl;
+        }
         for (auto stmt : statements)
         {
             delete stmt;
@@ -681,38 +1591,218 @@ public:
 
     void addVarDecl(AstNode* varDecl)
     {
-        
+        varDecls.push_back(varDecl);
     }
 
+    std::vector<AstNode*> &getVarDecls() { return varDecls; }
+
     void addStatement(AstNode* stmt)
     {
         statements.push_back(stmt);
     }
 
-    
-    void setIncludeReturn(bool include)
+    const std::string &getName() const { return funcName; }
+    std::vector<AstNode*> &getStatements() { return statements; }
+
+    int getProfileSite() const { return profileSite; }
+    void setProfileSite(int site) { profileSite = site; }
+
+    std::vector<ParamExpr*> getParams() const
+    {
+        std::vector<ParamExpr*> params;
+        if (ExprList* list = dynamic_cast<ExprList*>(paramList))
+        {
+            for (AstNode* param : list->getExpressions())
+            {
+                params.push_back(static_cast<ParamExpr*>(param));
+            }
+        }
+        return params;
+    }
+
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        FunctionDeclExpr* copy = new FunctionDeclExpr(funcName, returnType->clone(remap),
+                                                      paramList ? paramList->clone(remap) : nullptr);
+        for (auto decl : varDecls)
+        {
+            copy->addVarDecl(decl->clone(remap));
+        }
+        for (auto stmt : statements)
+        {
+            copy->addStatement(stmt->clone(remap));
+        }
+        copy->profileSite = profileSite;
+        return copy;
+    }
+
+    void forEachChild(const std::function<void(AstNode *&)> &fn) override
     {
-        includeReturn = include;
+        for (auto& decl : varDecls)
+        {
+            fn(decl);
+        }
+        for (auto& stmt : statements)
+        {
+            fn(stmt);
+        }
     }
 
     CodePlace generateCode() override
     {
         CodePlace result;
-        result.code = funcName + ":\n";
-        int stackSize = SymbolTable::getCurrentOffset(); 
-        result.code += "addi $sp, $sp, -" + std::to_string(stackSize) + "\n";
+        FrameInfo &frame = currentFrame();
+        frame = FrameInfo();
+        frame.functionName = funcName;
+        frame.entryLabel = funcName + "_entry";
+        frame.exitLabel = funcName + "_exit";
+
+        int outgoingSize = 0;
+        for (auto stmt : statements)
+        {
+            outgoingSize = std::max(outgoingSize, outgoingArgsSize(stmt));
+        }
+        SymbolTable::setFrameBase(funcName, outgoingSize);
+        frame.raOffset = outgoingSize + SymbolTable::getLocalsSize(funcName);
+        frame.saveOffset = frame.raOffset + 4;
+
+        for (ParamExpr* param : getParams())
+        {
+            frame.params.push_back(param->getVarRef());
+        }
 
+        if (!statements.empty())
+        {
+            statements.back()->setTailPosition();
+        }
+
+        std::string body;
         for (auto& stmt : statements)
         {
             CodePlace stmtCode = stmt->generateCode();
-            result.code += stmtCode.code;
+            body += stmtCode.code;
+            if (!stmtCode.place.empty())
+            {
+                freeTempRegister(stmtCode.place);
+            }
+        }
+
+        int stackSize = frame.hasCalls || frame.maxSavedTemps > 0 ? frame.saveOffset + 4 * frame.maxSavedTemps
+                                                                   : frame.raOffset;
+        std::string epilogue;
+        if (frame.hasCalls)
+        {
+            epilogue += "lw $ra, " + std::to_string(frame.raOffset) + "($sp)\n";
+        }
+        if (stackSize > 0)
+        {
+            epilogue += "addi $sp, $sp, " + std::to_string(stackSize) + "\n";
+        }
+
+        result.code = funcName + ":\n";
+        if (stackSize > 0)
+        {
+            result.code += "addi $sp, $sp, -" + std::to_string(stackSize) + "\n";
+        }
+        if (frame.hasCalls)
+        {
+            result.code += "sw $ra, " + std::to_string(frame.raOffset) + "($sp)\n";
         }
-        result.code += "addi $sp, $sp, " + std::to_string(stackSize) + "\n";
-        if (includeReturn)
+        for (size_t i = 0; i < frame.params.size(); ++i)
         {
-            result.code += "jr $ra\n";
+            std::string slot = std::to_string(SymbolTable::getVarOffset(frame.params[i])) + "($sp)\n";
+            if (i < 4)
+            {
+                result.code += "sw $a" + std::to_string(i) + ", " + slot;
+            }
+            else
+            {
+                result.code += "lw $v1, " + std::to_string(stackSize + 4 * (i - 4)) + "($sp)\n";
+                result.code += "sw $v1, " + slot;
+            }
+        }
+        result.code += profileIncrement(profileSite);
+        result.code += frame.entryLabel + ":\n";
+
+        std::string cold = frame.coldCode;
+        const std::string mark = FrameInfo::EPILOGUE_MARK;
+        for (std::string *code : {&body, &cold})
+        {
+            for (size_t pos = code->find(mark); pos != std::string::npos; pos = code->find(mark, pos + epilogue.size()))
+            {
+                code->replace(pos, mark.size(), epilogue);
+            }
         }
+        result.code += body;
+
+        result.code += frame.exitLabel + ":\n";
+        result.code += epilogue;
+        result.code += "jr $ra\n";
+        result.code += cold;
+
+        return result;
+    }
+
+private:
+    // Espacio para los argumentos que no caben en $a0-$a3, compartido por todas las llamadas
+    static int outgoingArgsSize(AstNode* node)
+    {
+        int size = 0;
+        if (FunctionCallExpr* call = dynamic_cast<FunctionCallExpr*>(node))
+        {
+            size = std::max(0, static_cast<int>(call->getArguments().size()) - 4) * 4;
+        }
+        node->forEachChild([&](AstNode*& child)
+        {
+            size = std::max(size, outgoingArgsSize(child));
+        });
+        return size;
+    }
+};
+
+class ReturnStmt : public AstNode
+{
+    AstNode* expr;
+    bool last = false;
+
+public:
+    ReturnStmt(AstNode* expr) : expr(expr)
+    {
+        expr->setTailPosition();
+    }
+
+    ~ReturnStmt() { delete expr; }
+
+    AstNode *getExpr() const { return expr; }
+
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        return new ReturnStmt(expr->clone(remap));
+    }
+
+    void forEachChild(const std::function<void(AstNode *&)> &fn) override
+    {
+        fn(expr);
+    }
 
+    void setTailPosition() override
+    {
+        last = true;
+    }
+
+    CodePlace generateCode() override
+    {
+        CodePlace result = expr->generateCode();
+        if (!result.place.empty())
+        {
+            result.code += "move $v0, " + result.place + "\n";
+            freeTempRegister(result.place);
+            result.place = "";
+        }
+        if (!last)
+        {
+            result.code += "j " + currentFrame().exitLabel + "\n";
+        }
         return result;
     }
 };
@@ -722,6 +1812,7 @@ class IfStmt : public AstNode
     AstNode* condition;
     AstNode* ifBody;
     AstNode* elseBody; 
+    int profileSite = -1;
 
 public:
     IfStmt(AstNode* condition, AstNode* ifBody, AstNode* elseBody = nullptr)
@@ -733,6 +1824,49 @@ public:
         if (elseBody) delete elseBody;
     }
 
+    AstNode *getCondition() const { return condition; }
+    AstNode *getIfBody() const { return ifBody; }
+    AstNode *getElseBody() const { return elseBody; }
+
+    int getProfileSite() const { return profileSite; }
+    void setProfileSite(int site) { profileSite = site; }
+
+    // Entregan una rama al quitar el if; el nodo ya no la libera
+    AstNode *releaseIfBody()
+    {
+        AstNode *body = ifBody;
+        ifBody = nullptr;
+        return body;
+    }
+
+    AstNode *releaseElseBody()
+    {
+        AstNode *body = elseBody;
+        elseBody = nullptr;
+        return body;
+    }
+
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        IfStmt *copy = new IfStmt(condition->clone(remap), ifBody->clone(remap),
+                                  elseBody ? elseBody->clone(remap) : nullptr);
+        copy->profileSite = profileSite;
+        return copy;
+    }
+
+    void forEachChild(const std::function<void(AstNode *&)> &fn) override
+    {
+        fn(condition);
+        fn(ifBody);
+        if (elseBody) fn(elseBody);
+    }
+
+    void setTailPosition() override
+    {
+        ifBody->setTailPosition();
+        if (elseBody) elseBody->setTailPosition();
+    }
+
     CodePlace generateCode() override
     {
         CodePlace result;
@@ -744,42 +1878,123 @@ public:
         static int labelCount = 0;
         std::string elseLabel = "else_" + std::to_string(labelCount);
         std::string endLabel = "end_if_" + std::to_string(labelCount);
+        std::string coldLabel = "cold_" + std::to_string(labelCount);
         labelCount++;
 
-        
-        
+        // Con --profile-use la rama más ejecutada queda como continuación
+        // directa del salto, sin saltos en su camino, y la otra se mueve al
+        // final de la función (FrameInfo::coldCode) y regresa con un j
+        long long thenCount = profileCount(profileSite, 0);
+        long long elseCount = profileCount(profileSite, 1);
+        bool known = thenCount >= 0 && elseCount >= 0;
+
         result.code = conditionCode.code;
-        result.code += "beqz " + conditionCode.place + ", " + elseLabel + "\n"; 
+        if (known && elseCount > thenCount)
+        {
+            result.code += "bnez " + conditionCode.place + ", " + coldLabel + "\n";
+            freeTempRegister(conditionCode.place);
+            result.code += generateElse();
+            result.code += endLabel + ":\n";
+            currentFrame().coldCode += coldLabel + ":\n" + generateThen() + "j " + endLabel + "\n";
+            return result;
+        }
+        if (known && thenCount > elseCount && elseBody)
+        {
+            result.code += "beqz " + conditionCode.place + ", " + coldLabel + "\n";
+            freeTempRegister(conditionCode.place);
+            result.code += generateThen();
+            result.code += endLabel + ":\n";
+            currentFrame().coldCode += coldLabel + ":\n" + generateElse() + "j " + endLabel + "\n";
+            return result;
+        }
 
         
-        CodePlace ifBodyCode = ifBody->generateCode();
-        result.code += ifBodyCode.code;
+        
+        result.code += "beqz " + conditionCode.place + ", " + elseLabel + "\n"; 
+        freeTempRegister(conditionCode.place);
+        result.code += generateThen();
 
         
         result.code += "j " + endLabel + "\n";
 
         
         result.code += elseLabel + ":\n";
-        if (elseBody)
-        {
-            CodePlace elseBodyCode = elseBody->generateCode();
-            result.code += elseBodyCode.code;
-        }
+        result.code += generateElse();
 
         
         result.code += endLabel + ":\n";
 
-        
-        freeTempRegister(conditionCode.place);
-
         return result;
     }
+
+private:
+    // Cada rama empieza con su contador de --instrument
+    std::string generateThen()
+    {
+        return profileIncrement(profileSite, 0) + ifBody->generateCode().code;
+    }
+
+    std::string generateElse()
+    {
+        std::string code = profileIncrement(profileSite, 1);
+        if (elseBody)
+        {
+            code += elseBody->generateCode().code;
+        }
+        return code;
+    }
+};
+
+// Variable de inducción de un while que el código MIPS recorre con punteros
+// (ver StrengthReduction). Cada arreglo indexado con a[counter] tiene un
+// puntero a &a[counter] que avanza 4 * step bytes junto con el incremento.
+struct InductionPlan
+{
+    VarRef counter;
+    int step = 0;
+    AstNode *increment = nullptr;  // counter = counter + step, directo en el cuerpo
+    std::vector<VarRef> arrays;
+    // Con eliminateCounter la condición counter < bound (o <=) se evalúa con
+    // el primer puntero y counter solo se escribe al salir del ciclo
+    AstNode *bound = nullptr;
+    bool inclusive = false;
+    bool eliminateCounter = false;
 };
 
+// Punteros de los ciclos cuyo cuerpo se está generando, del más externo al más interno
+struct InductionPointer
+{
+    VarRef counter;
+    VarRef array;
+    std::string reg;
+};
+
+inline std::vector<InductionPointer> &inductionPointers()
+{
+    static std::vector<InductionPointer> pointers;
+    return pointers;
+}
+
+// Dirección del primer elemento de un arreglo global, local o recibido por referencia
+inline std::string arrayBaseCode(VarRef array, const std::string &reg)
+{
+    if (SymbolTable::isGlobal(array))
+    {
+        return "la " + reg + ", " + SymbolTable::getGlobalLabel(array) + "\n";
+    }
+    if (SymbolTable::isReference(array))
+    {
+        return "lw " + reg + ", " + varOperand(array) + "\n";
+    }
+    return "addi " + reg + ", $sp, " + std::to_string(SymbolTable::getVarOffset(array)) + "\n";
+}
+
 class WhileStmt : public AstNode
 {
     AstNode* condition;
     AstNode* whileBody;
+    InductionPlan induction;
+    int profileSite = -1;
 
 public:
     WhileStmt(AstNode* condition, AstNode* whileBody)
@@ -790,6 +2005,29 @@ public:
         delete whileBody;
     }
 
+    AstNode *getCondition() const { return condition; }
+    AstNode *getBody() const { return whileBody; }
+
+    const InductionPlan &getInduction() const { return induction; }
+    void setInduction(const InductionPlan &plan) { induction = plan; }
+
+    int getProfileSite() const { return profileSite; }
+    void setProfileSite(int site) { profileSite = site; }
+
+    // El plan apunta a nodos de este ciclo, así que la copia no lo conserva
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        WhileStmt *copy = new WhileStmt(condition->clone(remap), whileBody->clone(remap));
+        copy->profileSite = profileSite;
+        return copy;
+    }
+
+    void forEachChild(const std::function<void(AstNode *&)> &fn) override
+    {
+        fn(condition);
+        fn(whileBody);
+    }
+
     CodePlace generateCode() override
     {
         CodePlace result;
@@ -800,7 +2038,13 @@ public:
         std::string endLabel = "while_end_" + std::to_string(labelCount);
         labelCount++;
 
+        if (canReduce())
+        {
+            return generateReduced(startLabel, endLabel);
+        }
+
         
+        result.code += profileIncrement(profileSite, 0);
         result.code += startLabel + ":\n";
 
         
@@ -809,6 +2053,8 @@ public:
         
         result.code += conditionCode.code;
         result.code += "beqz " + conditionCode.place + ", " + endLabel + "\n"; 
+        freeTempRegister(conditionCode.place);
+        result.code += profileIncrement(profileSite, 1);
 
         
         CodePlace whileBodyCode = whileBody->generateCode();
@@ -820,119 +2066,450 @@ public:
         
         result.code += endLabel + ":\n";
 
+        return result;
+    }
+
+private:
+    // Los punteros viven en temporales durante todo el ciclo; si no quedan
+    // suficientes para el cuerpo se genera el ciclo sin reducir
+    bool canReduce()
+    {
+        if (induction.arrays.empty())
+        {
+            return false;
+        }
+        int need = condition->registerNeed();
+        for (AstNode *stmt : static_cast<ExprList *>(whileBody)->getExpressions())
+        {
+            need = std::max(need, stmt->registerNeed());
+        }
+        int reserved = static_cast<int>(induction.arrays.size()) + (induction.eliminateCounter ? 1 : 0);
+        return reserved + need + 2 <= static_cast<int>(freeTempRegisterCount());
+    }
+
+    CodePlace generateReduced(const std::string &startLabel, const std::string &endLabel)
+    {
+        CodePlace result;
+        std::string counter = varOperand(induction.counter);
+        size_t outerPointers = inductionPointers().size();
+        result.code += profileIncrement(profileSite, 0);
+
+        std::vector<std::string> pointers;
+        for (VarRef array : induction.arrays)
+        {
+            std::string pointer = allocateTempRegister();
+            std::string base = allocateTempRegister();
+            result.code += "lw " + pointer + ", " + counter + "\n";
+            result.code += "sll " + pointer + ", " + pointer + ", 2\n";
+            result.code += arrayBaseCode(array, base);
+            result.code += "add " + pointer + ", " + pointer + ", " + base + "\n";
+            freeTempRegister(base);
+            pointers.push_back(pointer);
+            inductionPointers().push_back({induction.counter, array, pointer});
+        }
+
+        // Límite en bytes: &a[bound] para el primer arreglo
+        std::string end;
+        if (induction.eliminateCounter)
+        {
+            CodePlace boundCode = induction.bound->generateCode();
+            end = boundCode.place;
+            std::string base = allocateTempRegister();
+            result.code += boundCode.code;
+            result.code += "sll " + end + ", " + end + ", 2\n";
+            result.code += arrayBaseCode(induction.arrays[0], base);
+            result.code += "add " + end + ", " + end + ", " + base + "\n";
+            freeTempRegister(base);
+        }
+
+        result.code += startLabel + ":\n";
+        std::string test;
+        if (induction.eliminateCounter)
+        {
+            // 4 * (counter - bound), con signo aunque las direcciones crucen 2^31
+            test = allocateTempRegister();
+            result.code += "sub " + test + ", " + pointers[0] + ", " + end + "\n";
+            result.code += induction.inclusive ? "slti " + test + ", " + test + ", 1\n"
+                                               : "slt " + test + ", " + test + ", $zero\n";
+        }
+        else
+        {
+            CodePlace conditionCode = condition->generateCode();
+            result.code += conditionCode.code;
+            test = conditionCode.place;
+        }
+        result.code += "beqz " + test + ", " + endLabel + "\n";
+        freeTempRegister(test);
+        result.code += profileIncrement(profileSite, 1);
+
+        for (AstNode *stmt : static_cast<ExprList *>(whileBody)->getExpressions())
+        {
+            if (stmt == induction.increment)
+            {
+                for (const std::string &pointer : pointers)
+                {
+                    result.code += "addi " + pointer + ", " + pointer + ", " + std::to_string(4 * induction.step) + "\n";
+                }
+                if (induction.eliminateCounter)
+                {
+                    continue;
+                }
+            }
+            CodePlace stmtCode = stmt->generateCode();
+            result.code += stmtCode.code;
+            if (!stmtCode.place.empty())
+            {
+                freeTempRegister(stmtCode.place);
+            }
+        }
+
+        result.code += "j " + startLabel + "\n";
+        result.code += endLabel + ":\n";
+        inductionPointers().resize(outerPointers);
+
+        // El contador sale del primer puntero: (p - &a[0]) / 4
+        if (induction.eliminateCounter)
+        {
+            result.code += arrayBaseCode(induction.arrays[0], end);
+            result.code += "sub " + pointers[0] + ", " + pointers[0] + ", " + end + "\n";
+            result.code += "sra " + pointers[0] + ", " + pointers[0] + ", 2\n";
+            result.code += "sw " + pointers[0] + ", " + counter + "\n";
+            freeTempRegister(end);
+        }
+        for (const std::string &pointer : pointers)
+        {
+            freeTempRegister(pointer);
+        }
+        return result;
+    }
+};
+
+class CinExpr : public AstNode
+{
+    std::string varName;
+    std::string functionName;
+    VarRef ref;
+public:
+    CinExpr(const std::string& varName, const std::string& functionName)
+        : varName(varName), functionName(functionName), ref(SymbolTable::resolve(functionName, varName)) {}
+
+    const std::string &getVarName() const { return varName; }
+    VarRef getVarRef() const { return ref; }
+    void setVarRef(VarRef binding) { ref = binding; }
+
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        if (remap)
+        {
+            return new CinExpr(remap->map(varName), remap->functionName);
+        }
+        return new CinExpr(varName, functionName);
+    }
+
+    CodePlace generateCode() override
+    {
+        CodePlace result;
+
+        result.code += runtimeCall(MipsRuntime::READ_INT);
+
         
-        freeTempRegister(conditionCode.place);
+        std::string operand = varOperand(ref); 
+        if (SymbolTable::isReference(ref))
+        {
+            result.code += "lw $v1, " + operand + "\n";
+            result.code += "sw $v0, 0($v1)\n";
+        }
+        else
+        {
+            result.code += "sw $v0, " + operand + "\n"; 
+        }
 
         return result;
     }
 };
 
-class ArrayCinExpr : public AstNode
+// Operando de memoria de a[index]: los índices constantes se pliegan en el
+// desplazamiento y los variables se escalan con sll
+struct ElementAddress
 {
+    std::string code;
+    std::string operand;
+    std::string reg;
+};
+
+// Base de los accesos a elementos de arreglo. Con --bounds-check cada índice
+// variable se compara contra el tamaño declarado salvo que el análisis de
+// rangos haya demostrado que está dentro del arreglo.
+class ArrayAccess : public AstNode
+{
+protected:
+    std::string functionName;
     std::string varName;
     AstNode* indexExpr;
+    VarRef ref;
+    bool boundsChecked = true;
 
 public:
-    ArrayCinExpr(const std::string& varName, AstNode* indexExpr)
-        : varName(varName), indexExpr(indexExpr) {}
+    ArrayAccess(const std::string& functionName, const std::string& varName, AstNode* indexExpr)
+        : functionName(functionName), varName(varName), indexExpr(indexExpr),
+          ref(SymbolTable::resolve(functionName, varName)) {}
 
-    ~ArrayCinExpr() {
+    ~ArrayAccess() {
         delete indexExpr;
     }
 
-    CodePlace generateCode() override
+    const std::string &getFunctionName() const { return functionName; }
+    const std::string &getVarName() const { return varName; }
+    VarRef getVarRef() const { return ref; }
+    void setVarRef(VarRef binding) { ref = binding; }
+    AstNode *getIndex() const { return indexExpr; }
+
+    bool isBoundsChecked() const { return boundsChecked; }
+    void setBoundsChecked(bool checked) { boundsChecked = checked; }
+
+    // Si el código generado compara el índice contra el tamaño
+    bool needsBoundsCheck() const
     {
-        CodePlace result;
+        return codeGenOptions().boundsCheck && boundsChecked && SymbolTable::getArraySize(ref) > 0;
+    }
+
+protected:
+    ElementAddress elementAddress()
+    {
+        ElementAddress address;
+        bool global = SymbolTable::isGlobal(ref);
+        bool pointer = !global && SymbolTable::isReference(ref);
+        int size = SymbolTable::getArraySize(ref);
+        bool check = needsBoundsCheck();
+
+        // Dentro de un ciclo reducido, a[i] ya tiene su puntero
+        VariableExpr *index = dynamic_cast<VariableExpr *>(indexExpr);
+        const std::vector<InductionPointer> &pointers = inductionPointers();
+        for (auto it = pointers.rbegin(); index && !check && it != pointers.rend(); ++it)
+        {
+            if (it->array == ref && it->counter == index->getVarRef())
+            {
+                address.operand = "0(" + it->reg + ")";
+                return address;
+            }
+        }
+
+        if (ValueExpr *constant = dynamic_cast<ValueExpr *>(indexExpr))
+        {
+            int index = static_cast<int>(constant->getValue());
+            if (check && (index < 0 || index >= size))
+            {
+                throw std::runtime_error("Array index out of bounds: " + varName + "[" +
+                                         std::to_string(index) + "]");
+            }
+
+            int byteOffset = 4 * index;
+            if (global)
+            {
+                address.operand = SymbolTable::getGlobalLabel(ref) + "+" + std::to_string(byteOffset);
+            }
+            else if (pointer)
+            {
+                address.reg = allocateTempRegister();
+                address.code = "lw " + address.reg + ", " + varOperand(ref) + "\n";
+                address.operand = std::to_string(byteOffset) + "(" + address.reg + ")";
+            }
+            else
+            {
+                int offset = SymbolTable::getVarOffset(ref) + byteOffset;
+                address.operand = std::to_string(offset) + "($sp)";
+            }
+            return address;
+        }
 
-        
         CodePlace indexCode = indexExpr->generateCode();
+        address.reg = indexCode.place;
+        address.code = indexCode.code;
 
-        
-        std::string tempRegister = allocateTempRegister();
+        // Una comparación sin signo descarta a la vez índices negativos y >= size
+        if (check)
+        {
+            if (size <= 32767)
+            {
+                address.code += "sltiu $v1, " + address.reg + ", " + std::to_string(size) + "\n";
+            }
+            else
+            {
+                address.code += "li $v1, " + std::to_string(size) + "\n";
+                address.code += "sltu $v1, " + address.reg + ", $v1\n";
+            }
+            address.code += "beqz $v1, " + std::string(CodeGenOptions::BOUNDS_FAIL_LABEL) + "\n";
+        }
 
-        
-        result.code += indexCode.code;
-        result.code += "mul " + indexCode.place + ", " + indexCode.place + ", 4\n";  
+        address.code += "sll " + address.reg + ", " + address.reg + ", 2\n";
+        if (global || pointer)
+        {
+            std::string base = allocateTempRegister();
+            if (global)
+            {
+                address.code += "la " + base + ", " + SymbolTable::getGlobalLabel(ref) + "\n";
+            }
+            else
+            {
+                address.code += "lw " + base + ", " + varOperand(ref) + "\n";
+            }
+            address.code += "add " + address.reg + ", " + address.reg + ", " + base + "\n";
+            freeTempRegister(base);
+            address.operand = "0(" + address.reg + ")";
+        }
+        else
+        {
+            address.code += "add " + address.reg + ", " + address.reg + ", $sp\n";
+            address.operand = std::to_string(SymbolTable::getVarOffset(ref)) + "(" + address.reg + ")";
+        }
+        return address;
+    }
 
-        
-        result.code += "la " + tempRegister + ", " + varName + "\n";  
+    template <typename T>
+    T *keepCheck(T *copy) const
+    {
+        copy->setBoundsChecked(boundsChecked);
+        return copy;
+    }
+};
 
-        
-        result.code += "add " + tempRegister + ", " + tempRegister + ", " + indexCode.place + "\n";
+class ArrayElementExpr : public ArrayAccess
+{
+public:
+    ArrayElementExpr(const std::string& functionName, const std::string& varName, AstNode* indexExpr)
+        : ArrayAccess(functionName, varName, indexExpr) {}
 
-        
-        result.code += "lw " + tempRegister + ", 0(" + tempRegister + ")\n";
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        if (remap)
+        {
+            return keepCheck(new ArrayElementExpr(remap->functionName, remap->map(varName), indexExpr->clone(remap)));
+        }
+        return keepCheck(new ArrayElementExpr(functionName, varName, indexExpr->clone()));
+    }
 
-        
-        result.place = tempRegister;
+    void forEachChild(const std::function<void(AstNode *&)> &fn) override
+    {
+        fn(indexExpr);
+    }
 
-        
-        freeTempRegister(indexCode.place);
+    // Con índice variable, las globales y las referencias ocupan otro
+    // registro para la base mientras el índice sigue vivo
+    int registerNeed() override
+    {
+        if (dynamic_cast<ValueExpr *>(indexExpr))
+        {
+            return 1;
+        }
+        bool global = SymbolTable::isGlobal(ref);
+        bool pointer = !global && SymbolTable::isReference(ref);
+        return std::max(indexExpr->registerNeed(), global || pointer ? 2 : 1);
+    }
 
+    CodePlace generateCode() override
+    {
+        CodePlace result;
+        ElementAddress address = elementAddress();
+        result.place = address.reg.empty() ? allocateTempRegister() : address.reg;
+        result.code = address.code;
+        result.code += "lw " + result.place + ", " + address.operand + "\n";
         return result;
     }
 };
 
-class CinExpr : public AstNode
+class ArrayCinExpr : public ArrayAccess
 {
-    std::string varName;
-    std::string functionName;
 public:
-    CinExpr(const std::string& varName, const std::string& functionName) : varName(varName),functionName(functionName) {}
+    ArrayCinExpr(const std::string& functionName, const std::string& varName, AstNode* indexExpr)
+        : ArrayAccess(functionName, varName, indexExpr) {}
+
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        if (remap)
+        {
+            return keepCheck(new ArrayCinExpr(remap->functionName, remap->map(varName), indexExpr->clone(remap)));
+        }
+        return keepCheck(new ArrayCinExpr(functionName, varName, indexExpr->clone()));
+    }
+
+    void forEachChild(const std::function<void(AstNode *&)> &fn) override
+    {
+        fn(indexExpr);
+    }
 
     CodePlace generateCode() override
     {
         CodePlace result;
 
-        result.code += "li $v0, 5\n";              
-        result.code += "syscall\n";                
+        
+        ElementAddress address = elementAddress();
+        result.code = address.code;
+
+        
+        result.code += runtimeCall(MipsRuntime::READ_INT);
+        result.code += "sw $v0, " + address.operand + "\n";
 
         
-        int offset = SymbolTable::getVarOffset(functionName, varName); 
-        result.code += "sw $v0, " + std::to_string(offset) + "($sp)\n"; 
+        if (!address.reg.empty())
+        {
+            freeTempRegister(address.reg);
+        }
 
         return result;
     }
 };
 
-class ArrayAssignExpr : public AstNode
+class ArrayAssignExpr : public ArrayAccess
 {
-    std::string functionName;  
-    std::string varName;       
-    AstNode *indexExpr;        
     AstNode *expr;             
 
 public:
     ArrayAssignExpr(const std::string &functionName, const std::string &varName, AstNode *indexExpr, AstNode *expr)
-        : functionName(functionName), varName(varName), indexExpr(indexExpr), expr(expr) {}
+        : ArrayAccess(functionName, varName, indexExpr), expr(expr) {}
 
     ~ArrayAssignExpr()
     {
-        delete indexExpr;
         delete expr;
     }
 
+    AstNode *getExpr() const { return expr; }
+
+    AstNode *clone(const VarRemap *remap) const override
+    {
+        if (remap)
+        {
+            return keepCheck(new ArrayAssignExpr(remap->functionName, remap->map(varName),
+                                                 indexExpr->clone(remap), expr->clone(remap)));
+        }
+        return keepCheck(new ArrayAssignExpr(functionName, varName, indexExpr->clone(), expr->clone()));
+    }
+
+    void forEachChild(const std::function<void(AstNode *&)> &fn) override
+    {
+        fn(expr);
+        fn(indexExpr);
+    }
+
     CodePlace generateCode() override
     {
         CodePlace result;
-        CodePlace indexCode = indexExpr->generateCode();
         CodePlace exprCode = expr->generateCode();
+        ElementAddress address = elementAddress();
         
         result.place = "";  
 
         
-        result.code = indexCode.code;
-        result.code += "sll $t1, " + indexCode.place + ", 2\n";  
-        result.code += "add $t1, $t1, $sp\n";  
+        result.code = exprCode.code;
+        result.code += address.code;
+        result.code += "sw " + exprCode.place + ", " + address.operand + "\n";
         
         
-        result.code += exprCode.code;
-        result.code += "sw " + exprCode.place + ", 0($t1)\n";
-        
-        
-        freeTempRegister(indexCode.place);
+        if (!address.reg.empty())
+        {
+            freeTempRegister(address.reg);
+        }
         freeTempRegister(exprCode.place);
 
         return result;
     }
-};
\ No newline at end of file
+};
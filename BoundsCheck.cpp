@@ -0,0 +1,267 @@
+#include "BoundsCheck.hpp"
+#include <cmath>
+
+void BoundsCheckEliminator::run(ProgramNode *program)
+{
+    for (AstNode *node : program->getFunctions())
+    {
+        FunctionDeclExpr *func = static_cast<FunctionDeclExpr *>(node);
+        functionName = func->getName();
+
+        addressTaken.clear();
+        collectAddressTaken(func);
+
+        visitStatements(func->getStatements());
+    }
+}
+
+void BoundsCheckEliminator::visitStatements(std::vector<AstNode *> &statements)
+{
+    for (size_t i = 0; i < statements.size(); ++i)
+    {
+        if (WhileStmt *loop = dynamic_cast<WhileStmt *>(statements[i]))
+        {
+            analyzeLoop(statements, i, loop);
+        }
+        visitChildren(statements[i]);
+    }
+}
+
+void BoundsCheckEliminator::visitChildren(AstNode *node)
+{
+    if (!node)
+    {
+        return;
+    }
+    if (ExprList *list = dynamic_cast<ExprList *>(node))
+    {
+        visitStatements(list->getExpressions());
+        return;
+    }
+    node->forEachChild([&](AstNode *&child)
+    {
+        visitChildren(child);
+    });
+}
+
+void BoundsCheckEliminator::analyzeLoop(std::vector<AstNode *> &statements, size_t loopIndex, WhileStmt *loop)
+{
+    std::string var;
+    int bound = 0;
+    if (!loopBound(loop->getCondition(), var, bound))
+    {
+        return;
+    }
+
+    // Si i nunca baja de un valor inicial no negativo, i < N basta para 0 <= i < N
+    if (!nonNegativeOnEntry(statements, loopIndex, var) || !onlyIncreases(loop->getBody(), var))
+    {
+        return;
+    }
+
+    markSafeAccesses(loop->getBody(), var, bound);
+}
+
+// Reconoce `i < N` e `i <= N - 1` con N constante
+bool BoundsCheckEliminator::loopBound(AstNode *condition, std::string &var, int &bound) const
+{
+    BinaryExpr *compare = dynamic_cast<LessExpr *>(condition);
+    int adjust = 0;
+    if (!compare)
+    {
+        compare = dynamic_cast<LessEqualExpr *>(condition);
+        adjust = 1;
+    }
+    if (!compare)
+    {
+        return false;
+    }
+
+    VariableExpr *index = dynamic_cast<VariableExpr *>(compare->getLeft());
+    int limit = 0;
+    if (!index || !isConstant(compare->getRight(), limit))
+    {
+        return false;
+    }
+
+    // Solo locales escalares: un global o una referencia puede cambiar en una llamada
+    var = index->getVarName();
+    if (!SymbolTable::isLocal(functionName, var) || SymbolTable::isReference(functionName, var) ||
+        SymbolTable::getArraySize(functionName, var) > 0 || addressTaken.count(var))
+    {
+        return false;
+    }
+
+    bound = limit + adjust;
+    return true;
+}
+
+bool BoundsCheckEliminator::nonNegativeOnEntry(std::vector<AstNode *> &statements, size_t loopIndex,
+                                               const std::string &var) const
+{
+    for (size_t i = loopIndex; i-- > 0;)
+    {
+        if (!writes(statements[i], var))
+        {
+            continue;
+        }
+        AssignExpr *assign = dynamic_cast<AssignExpr *>(statements[i]);
+        int value = 0;
+        return assign && assign->getVarName() == var && isConstant(assign->getExpr(), value) && value >= 0;
+    }
+    return false;
+}
+
+bool BoundsCheckEliminator::onlyIncreases(AstNode *node, const std::string &var) const
+{
+    if (!node)
+    {
+        return true;
+    }
+    if (AssignExpr *assign = dynamic_cast<AssignExpr *>(node))
+    {
+        if (assign->getVarName() == var)
+        {
+            int value = 0;
+            if (isConstant(assign->getExpr(), value))
+            {
+                return value >= 0;
+            }
+            AddExpr *add = dynamic_cast<AddExpr *>(assign->getExpr());
+            if (!add)
+            {
+                return false;
+            }
+            VariableExpr *self = dynamic_cast<VariableExpr *>(add->getLeft());
+            AstNode *step = add->getRight();
+            if (!self)
+            {
+                self = dynamic_cast<VariableExpr *>(add->getRight());
+                step = add->getLeft();
+            }
+            return self && self->getVarName() == var && isConstant(step, value) && value >= 0;
+        }
+    }
+    if (CinExpr *cin = dynamic_cast<CinExpr *>(node))
+    {
+        return cin->getVarName() != var;
+    }
+
+    bool increases = true;
+    node->forEachChild([&](AstNode *&child)
+    {
+        increases = increases && onlyIncreases(child, var);
+    });
+    return increases;
+}
+
+// Recorre el cuerpo en orden de evaluación mientras i conserve la condición
+// del ciclo; devuelve false a partir de la primera escritura a i
+bool BoundsCheckEliminator::markSafeAccesses(AstNode *node, const std::string &var, int bound)
+{
+    if (!node)
+    {
+        return true;
+    }
+    if (AssignExpr *assign = dynamic_cast<AssignExpr *>(node))
+    {
+        markSafeAccesses(assign->getExpr(), var, bound);
+        return assign->getVarName() != var;
+    }
+    if (CinExpr *cin = dynamic_cast<CinExpr *>(node))
+    {
+        return cin->getVarName() != var;
+    }
+    if (IfStmt *ifStmt = dynamic_cast<IfStmt *>(node))
+    {
+        markSafeAccesses(ifStmt->getCondition(), var, bound);
+        bool ifSafe = markSafeAccesses(ifStmt->getIfBody(), var, bound);
+        bool elseSafe = markSafeAccesses(ifStmt->getElseBody(), var, bound);
+        return ifSafe && elseSafe;
+    }
+    if (dynamic_cast<WhileStmt *>(node) && writes(node, var))
+    {
+        return false;
+    }
+
+    bool safe = true;
+    node->forEachChild([&](AstNode *&child)
+    {
+        safe = safe && markSafeAccesses(child, var, bound);
+    });
+
+    if (ArrayAccess *access = dynamic_cast<ArrayAccess *>(node))
+    {
+        VariableExpr *index = dynamic_cast<VariableExpr *>(access->getIndex());
+        const std::string &array = access->getVarName();
+        if (index && index->getVarName() == var && access->isBoundsChecked() &&
+            !SymbolTable::isReference(functionName, array) &&
+            SymbolTable::getArraySize(functionName, array) >= bound)
+        {
+            access->setBoundsChecked(false);
+        }
+    }
+    return safe;
+}
+
+bool BoundsCheckEliminator::writes(AstNode *node, const std::string &var) const
+{
+    if (!node)
+    {
+        return false;
+    }
+    if (AssignExpr *assign = dynamic_cast<AssignExpr *>(node))
+    {
+        if (assign->getVarName() == var)
+        {
+            return true;
+        }
+    }
+    if (CinExpr *cin = dynamic_cast<CinExpr *>(node))
+    {
+        return cin->getVarName() == var;
+    }
+
+    bool found = false;
+    node->forEachChild([&](AstNode *&child)
+    {
+        found = found || writes(child, var);
+    });
+    return found;
+}
+
+// Variables cuya dirección se pasa a un parámetro por referencia
+void BoundsCheckEliminator::collectAddressTaken(AstNode *node)
+{
+    if (!node)
+    {
+        return;
+    }
+    if (FunctionCallExpr *call = dynamic_cast<FunctionCallExpr *>(node))
+    {
+        const std::vector<AstNode *> &args = call->getArguments();
+        for (size_t i = 0; i < args.size(); ++i)
+        {
+            VariableExpr *var = dynamic_cast<VariableExpr *>(args[i]);
+            if (var && SymbolTable::isReferenceParam(call->getFunctionName(), i))
+            {
+                addressTaken.insert(var->getVarName());
+            }
+        }
+    }
+    node->forEachChild([&](AstNode *&child)
+    {
+        collectAddressTaken(child);
+    });
+}
+
+bool BoundsCheckEliminator::isConstant(AstNode *node, int &value)
+{
+    ValueExpr *constant = dynamic_cast<ValueExpr *>(node);
+    if (!constant || constant->getValue() != std::floor(constant->getValue()))
+    {
+        return false;
+    }
+    value = static_cast<int>(constant->getValue());
+    return true;
+}
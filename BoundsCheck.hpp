@@ -0,0 +1,31 @@
+#pragma once
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "Ast.hpp"
+
+// Quita las comprobaciones de rango que el análisis demuestra redundantes:
+// accesos a[i] dentro de `while (i < N)` con 0 <= i y N <= tamaño de a
+class BoundsCheckEliminator
+{
+public:
+    void run(ProgramNode *program);
+
+private:
+    std::string functionName;
+    std::unordered_set<std::string> addressTaken;
+
+    void visitStatements(std::vector<AstNode *> &statements);
+    void visitChildren(AstNode *node);
+    void analyzeLoop(std::vector<AstNode *> &statements, size_t loopIndex, WhileStmt *loop);
+
+    bool loopBound(AstNode *condition, std::string &var, int &bound) const;
+    bool nonNegativeOnEntry(std::vector<AstNode *> &statements, size_t loopIndex, const std::string &var) const;
+    bool onlyIncreases(AstNode *node, const std::string &var) const;
+    bool markSafeAccesses(AstNode *node, const std::string &var, int bound);
+
+    bool writes(AstNode *node, const std::string &var) const;
+    void collectAddressTaken(AstNode *node);
+
+    static bool isConstant(AstNode *node, int &value);
+};
@@ -0,0 +1,165 @@
+#include "Bytecode.hpp"
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+
+static const char MAGIC[4] = {'M', 'C', 'B', 'C'};
+static const int32_t VERSION = 1;
+
+const char *opcodeOperandKinds(Opcode op)
+{
+    switch (op)
+    {
+    case Opcode::LOADK: return "RK";
+    case Opcode::MOVE: return "RR";
+    case Opcode::ADDK: return "RRK";
+    case Opcode::LOADG: return "RG";
+    case Opcode::STOREG: return "GR";
+    case Opcode::LOADI: return "RR";
+    case Opcode::STOREI: return "RR";
+    case Opcode::ADDR: return "RR";
+    case Opcode::CHECK: return "RK";
+    case Opcode::JMP: return "T";
+    case Opcode::JZ: return "RT";
+    case Opcode::CALL: return "RFR";
+    case Opcode::RET: return "R";
+    case Opcode::RET0: return "";
+    case Opcode::PRINT: return "R";
+    case Opcode::PRINTS: return "S";
+    case Opcode::ENDL: return "";
+    case Opcode::READ: return "R";
+    case Opcode::OPCODE_COUNT: break;
+    default: return "RRR";
+    }
+    throw std::runtime_error("Invalid opcode");
+}
+
+int opcodeOperands(Opcode op)
+{
+    return static_cast<int>(std::strlen(opcodeOperandKinds(op)));
+}
+
+static void writeInt(std::ostream &out, int32_t value)
+{
+    uint32_t bits = static_cast<uint32_t>(value);
+    char bytes[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        bytes[i] = static_cast<char>(bits >> (8 * i));
+    }
+    out.write(bytes, 4);
+}
+
+static void writeString(std::ostream &out, const std::string &text)
+{
+    writeInt(out, static_cast<int32_t>(text.size()));
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+static int32_t readInt(std::istream &in)
+{
+    unsigned char bytes[4];
+    if (!in.read(reinterpret_cast<char *>(bytes), 4))
+    {
+        throw std::runtime_error("Truncated bytecode file");
+    }
+    uint32_t bits = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        bits |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+    }
+    return static_cast<int32_t>(bits);
+}
+
+static std::string readString(std::istream &in)
+{
+    int32_t size = readInt(in);
+    if (size < 0)
+    {
+        throw std::runtime_error("Invalid bytecode file");
+    }
+    std::string text(static_cast<size_t>(size), '\0');
+    if (size > 0 && !in.read(&text[0], size))
+    {
+        throw std::runtime_error("Truncated bytecode file");
+    }
+    return text;
+}
+
+void BytecodeProgram::write(std::ostream &out) const
+{
+    out.write(MAGIC, sizeof(MAGIC));
+    writeInt(out, VERSION);
+    writeInt(out, globalsSize);
+    writeInt(out, mainFunction);
+
+    writeInt(out, static_cast<int32_t>(strings.size()));
+    for (const std::string &text : strings)
+    {
+        writeString(out, text);
+    }
+
+    writeInt(out, static_cast<int32_t>(functions.size()));
+    for (const BytecodeFunction &func : functions)
+    {
+        writeString(out, func.name);
+        writeInt(out, func.entry);
+        writeInt(out, func.params);
+        writeInt(out, func.frameSize);
+    }
+
+    writeInt(out, static_cast<int32_t>(code.size()));
+    for (int32_t word : code)
+    {
+        writeInt(out, word);
+    }
+}
+
+BytecodeProgram BytecodeProgram::read(std::istream &in)
+{
+    char magic[4];
+    if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + 4, MAGIC) || readInt(in) != VERSION)
+    {
+        throw std::runtime_error("Not a MiniCpp bytecode file");
+    }
+
+    BytecodeProgram program;
+    program.globalsSize = readInt(in);
+    program.mainFunction = readInt(in);
+
+    int32_t stringCount = readInt(in);
+    for (int32_t i = 0; i < stringCount; ++i)
+    {
+        program.strings.push_back(readString(in));
+    }
+
+    int32_t functionCount = readInt(in);
+    for (int32_t i = 0; i < functionCount; ++i)
+    {
+        BytecodeFunction func;
+        func.name = readString(in);
+        func.entry = readInt(in);
+        func.params = readInt(in);
+        func.frameSize = readInt(in);
+        program.functions.push_back(func);
+    }
+
+    int32_t codeSize = readInt(in);
+    if (codeSize < 0)
+    {
+        throw std::runtime_error("Invalid bytecode file");
+    }
+    program.code.reserve(static_cast<size_t>(codeSize));
+    for (int32_t i = 0; i < codeSize; ++i)
+    {
+        program.code.push_back(readInt(in));
+    }
+
+    if (program.mainFunction < 0 || program.mainFunction >= functionCount)
+    {
+        throw std::runtime_error("Bytecode file has no main function");
+    }
+    return program;
+}
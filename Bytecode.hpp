@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// Bytecode de registros. Cada instrucción es un código de operación seguido
+// de un número fijo de operandos de 32 bits. Los registros son relativos al
+// marco de la función; la memoria de la VM contiene primero los globales y
+// después la pila de marcos, así que una dirección es un índice absoluto.
+enum class Opcode : int32_t
+{
+    LOADK,   // a k       r[a] = k
+    MOVE,    // a b       r[a] = r[b]
+    ADD,     // a b c     r[a] = r[b] + r[c]
+    ADDK,    // a b k     r[a] = r[b] + k
+    SUB,
+    MUL,
+    DIV,
+    MOD,
+    LT,
+    GT,
+    LE,
+    GE,
+    EQ,
+    NE,
+    AND,
+    OR,
+    LOADG,   // a g       r[a] = mem[g]
+    STOREG,  // g a       mem[g] = r[a]
+    LOADI,   // a b       r[a] = mem[r[b]]
+    STOREI,  // b a       mem[r[b]] = r[a]
+    ADDR,    // a b       r[a] = dirección de r[b]
+    CHECK,   // a n       error si r[a] no está en [0, n)
+    JMP,     // t         pc = t
+    JZ,      // a t       si r[a] == 0, pc = t
+    CALL,    // a f b     r[a] = f(r[b], r[b+1], ...); el marco de f empieza en r[b]
+    RET,     // a         devuelve r[a]
+    RET0,    //           devuelve 0
+    PRINT,   // a         escribe r[a]
+    PRINTS,  // s         escribe la cadena s
+    ENDL,    //           escribe un salto de línea
+    READ,    // a         lee un entero en r[a]
+    OPCODE_COUNT
+};
+
+// Tipo de cada operando: R registro, K constante, G global, T destino de
+// salto, F función, S cadena
+const char *opcodeOperandKinds(Opcode op);
+int opcodeOperands(Opcode op);
+
+struct BytecodeFunction
+{
+    std::string name;
+    int32_t entry = 0;
+    int32_t params = 0;
+    int32_t frameSize = 0;
+};
+
+struct BytecodeProgram
+{
+    std::vector<int32_t> code;
+    std::vector<BytecodeFunction> functions;
+    std::vector<std::string> strings;
+    int32_t globalsSize = 0;
+    int32_t mainFunction = -1;
+
+    // Formato binario independiente del host (enteros little-endian)
+    void write(std::ostream &out) const;
+    static BytecodeProgram read(std::istream &in);
+};
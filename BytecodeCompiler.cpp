@@ -0,0 +1,520 @@
+#include "BytecodeCompiler.hpp"
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+BytecodeProgram BytecodeCompiler::compile(ProgramNode *program)
+{
+    result = BytecodeProgram();
+    functionIndex.clear();
+    globals.clear();
+    strings.clear();
+
+    std::function<void(AstNode *)> declareGlobals = [&](AstNode *node)
+    {
+        if (VarDeclExpr *decl = dynamic_cast<VarDeclExpr *>(node))
+        {
+            globals[decl->getVarName()] = result.globalsSize;
+            result.globalsSize += std::max(decl->getArraySize(), 1);
+            return;
+        }
+        node->forEachChild([&](AstNode *&child)
+        {
+            declareGlobals(child);
+        });
+    };
+    for (AstNode *global : program->getGlobals())
+    {
+        declareGlobals(global);
+    }
+
+    // Los índices se fijan antes para poder llamar a funciones definidas después
+    for (AstNode *node : program->getFunctions())
+    {
+        FunctionDeclExpr *func = static_cast<FunctionDeclExpr *>(node);
+        functionIndex[func->getName()] = static_cast<int>(result.functions.size());
+        BytecodeFunction entry;
+        entry.name = func->getName();
+        entry.params = static_cast<int32_t>(func->getParams().size());
+        result.functions.push_back(entry);
+    }
+
+    auto mainIt = functionIndex.find("main");
+    if (mainIt == functionIndex.end())
+    {
+        throw std::runtime_error("Program has no main function");
+    }
+    result.mainFunction = mainIt->second;
+
+    for (AstNode *node : program->getFunctions())
+    {
+        compileFunction(static_cast<FunctionDeclExpr *>(node));
+    }
+    return result;
+}
+
+void BytecodeCompiler::compileFunction(FunctionDeclExpr *func)
+{
+    functionName = func->getName();
+    allocateVariables(func);
+
+    BytecodeFunction &entry = result.functions[functionIndex.at(functionName)];
+    entry.entry = static_cast<int32_t>(result.code.size());
+
+    for (AstNode *stmt : func->getStatements())
+    {
+        compileStatement(stmt);
+    }
+    emit(Opcode::RET0, {});
+
+    entry.frameSize = std::max(frameSize, 1);
+}
+
+void BytecodeCompiler::allocateVariables(FunctionDeclExpr *func)
+{
+    registers.clear();
+    numVars = 0;
+
+    for (ParamExpr *param : func->getParams())
+    {
+        reserveRegisters(param->getParamName(), 1);
+    }
+
+    std::function<void(AstNode *)> collect = [&](AstNode *node)
+    {
+        std::string name;
+        if (VarDeclExpr *decl = dynamic_cast<VarDeclExpr *>(node))
+        {
+            name = decl->getVarName();
+        }
+        else if (VariableExpr *var = dynamic_cast<VariableExpr *>(node))
+        {
+            name = var->getVarName();
+        }
+        else if (AssignExpr *assign = dynamic_cast<AssignExpr *>(node))
+        {
+            name = assign->getVarName();
+        }
+        else if (CinExpr *cin = dynamic_cast<CinExpr *>(node))
+        {
+            name = cin->getVarName();
+        }
+        else if (ArrayAccess *access = dynamic_cast<ArrayAccess *>(node))
+        {
+            name = access->getVarName();
+        }
+
+        if (!name.empty() && SymbolTable::isLocal(functionName, name))
+        {
+            int size = SymbolTable::getArraySize(functionName, name);
+            bool array = size > 0 && !SymbolTable::isReference(functionName, name);
+            reserveRegisters(name, array ? size : 1);
+        }
+        node->forEachChild([&](AstNode *&child)
+        {
+            if (child)
+            {
+                collect(child);
+            }
+        });
+    };
+    collect(func);
+
+    tempTop = numVars;
+    frameSize = numVars;
+}
+
+void BytecodeCompiler::reserveRegisters(const std::string &name, int count)
+{
+    if (registers.count(name) == 0)
+    {
+        registers[name] = numVars;
+        numVars += count;
+    }
+}
+
+int BytecodeCompiler::variableRegister(const std::string &varName) const
+{
+    auto it = registers.find(varName);
+    if (it == registers.end())
+    {
+        throw std::runtime_error("Unknown variable " + varName + " in function " + functionName);
+    }
+    return it->second;
+}
+
+void BytecodeCompiler::compileStatement(AstNode *node)
+{
+    if (!node || dynamic_cast<VarDeclExpr *>(node))
+    {
+        return;
+    }
+
+    int mark = tempTop;
+    if (ExprList *list = dynamic_cast<ExprList *>(node))
+    {
+        for (AstNode *expr : list->getExpressions())
+        {
+            compileStatement(expr);
+        }
+    }
+    else if (AssignExpr *assign = dynamic_cast<AssignExpr *>(node))
+    {
+        const std::string &name = assign->getVarName();
+        if (SymbolTable::isGlobal(functionName, name))
+        {
+            int value = compileExpr(assign->getExpr());
+            emit(Opcode::STOREG, {globals.at(name), value});
+        }
+        else if (SymbolTable::isReference(functionName, name))
+        {
+            int value = compileExpr(assign->getExpr());
+            emit(Opcode::STOREI, {variableRegister(name), value});
+        }
+        else
+        {
+            compileExpr(assign->getExpr(), variableRegister(name));
+        }
+    }
+    else if (ArrayAssignExpr *assign = dynamic_cast<ArrayAssignExpr *>(node))
+    {
+        int value = compileExpr(assign->getExpr());
+        if (!isTemp(value) && containsCall(assign->getIndex()))
+        {
+            int copy = allocTemp();
+            emit(Opcode::MOVE, {copy, value});
+            value = copy;
+        }
+        int address = elementAddress(assign);
+        emit(Opcode::STOREI, {address, value});
+    }
+    else if (CinExpr *cin = dynamic_cast<CinExpr *>(node))
+    {
+        const std::string &name = cin->getVarName();
+        if (SymbolTable::isGlobal(functionName, name))
+        {
+            int value = allocTemp();
+            emit(Opcode::READ, {value});
+            emit(Opcode::STOREG, {globals.at(name), value});
+        }
+        else if (SymbolTable::isReference(functionName, name))
+        {
+            int value = allocTemp();
+            emit(Opcode::READ, {value});
+            emit(Opcode::STOREI, {variableRegister(name), value});
+        }
+        else
+        {
+            emit(Opcode::READ, {variableRegister(name)});
+        }
+    }
+    else if (ArrayCinExpr *cin = dynamic_cast<ArrayCinExpr *>(node))
+    {
+        int address = elementAddress(cin);
+        int value = allocTemp();
+        emit(Opcode::READ, {value});
+        emit(Opcode::STOREI, {address, value});
+    }
+    else if (PrintStmt *print = dynamic_cast<PrintStmt *>(node))
+    {
+        emit(Opcode::PRINT, {compileExpr(print->getExpr())});
+    }
+    else if (StringLiteralExpr *literal = dynamic_cast<StringLiteralExpr *>(node))
+    {
+        std::string text = literal->getText();
+        auto it = strings.find(text);
+        if (it == strings.end())
+        {
+            it = strings.emplace(text, static_cast<int>(result.strings.size())).first;
+            result.strings.push_back(text);
+        }
+        emit(Opcode::PRINTS, {it->second});
+    }
+    else if (dynamic_cast<EndlExpr *>(node))
+    {
+        emit(Opcode::ENDL, {});
+    }
+    else if (IfStmt *ifStmt = dynamic_cast<IfStmt *>(node))
+    {
+        int condition = compileExpr(ifStmt->getCondition());
+        tempTop = mark;
+        int toElse = emit(Opcode::JZ, {condition, 0});
+        compileStatement(ifStmt->getIfBody());
+        if (ifStmt->getElseBody())
+        {
+            int toEnd = emit(Opcode::JMP, {0});
+            patch(toElse + 2, static_cast<int32_t>(result.code.size()));
+            compileStatement(ifStmt->getElseBody());
+            patch(toEnd + 1, static_cast<int32_t>(result.code.size()));
+        }
+        else
+        {
+            patch(toElse + 2, static_cast<int32_t>(result.code.size()));
+        }
+    }
+    else if (WhileStmt *loop = dynamic_cast<WhileStmt *>(node))
+    {
+        int start = static_cast<int>(result.code.size());
+        int condition = compileExpr(loop->getCondition());
+        tempTop = mark;
+        int toEnd = emit(Opcode::JZ, {condition, 0});
+        compileStatement(loop->getBody());
+        emit(Opcode::JMP, {start});
+        patch(toEnd + 2, static_cast<int32_t>(result.code.size()));
+    }
+    else if (ReturnStmt *ret = dynamic_cast<ReturnStmt *>(node))
+    {
+        emit(Opcode::RET, {compileExpr(ret->getExpr())});
+    }
+    else
+    {
+        compileExpr(node);
+    }
+    tempTop = mark;
+}
+
+int BytecodeCompiler::compileExpr(AstNode *node, int target)
+{
+    if (ValueExpr *value = dynamic_cast<ValueExpr *>(node))
+    {
+        int dst = destination(target);
+        emit(Opcode::LOADK, {dst, static_cast<int32_t>(value->getValue())});
+        return dst;
+    }
+    if (VariableExpr *var = dynamic_cast<VariableExpr *>(node))
+    {
+        const std::string &name = var->getVarName();
+        if (SymbolTable::isGlobal(functionName, name))
+        {
+            int dst = destination(target);
+            emit(Opcode::LOADG, {dst, globals.at(name)});
+            return dst;
+        }
+        int reg = variableRegister(name);
+        if (SymbolTable::isReference(functionName, name))
+        {
+            int dst = destination(target);
+            emit(Opcode::LOADI, {dst, reg});
+            return dst;
+        }
+        // Un local se lee directamente de su registro
+        if (target >= 0 && target != reg)
+        {
+            emit(Opcode::MOVE, {target, reg});
+            return target;
+        }
+        return reg;
+    }
+    if (ArrayElementExpr *element = dynamic_cast<ArrayElementExpr *>(node))
+    {
+        int mark = tempTop;
+        int address = elementAddress(element);
+        tempTop = mark;
+        int dst = destination(target);
+        emit(Opcode::LOADI, {dst, address});
+        return dst;
+    }
+    if (FunctionCallExpr *call = dynamic_cast<FunctionCallExpr *>(node))
+    {
+        return compileCall(call, target);
+    }
+    if (BinaryExpr *binary = dynamic_cast<BinaryExpr *>(node))
+    {
+        return compileBinary(binary, target);
+    }
+    throw std::runtime_error("Unsupported expression for the bytecode target");
+}
+
+int BytecodeCompiler::compileBinary(BinaryExpr *expr, int target)
+{
+    Opcode op;
+    if (dynamic_cast<AddExpr *>(expr)) op = Opcode::ADD;
+    else if (dynamic_cast<SubExpr *>(expr)) op = Opcode::SUB;
+    else if (dynamic_cast<MulExpr *>(expr)) op = Opcode::MUL;
+    else if (dynamic_cast<DivExpr *>(expr)) op = Opcode::DIV;
+    else if (dynamic_cast<ModExpr *>(expr)) op = Opcode::MOD;
+    else if (dynamic_cast<LessExpr *>(expr)) op = Opcode::LT;
+    else if (dynamic_cast<GreaterExpr *>(expr)) op = Opcode::GT;
+    else if (dynamic_cast<LessEqualExpr *>(expr)) op = Opcode::LE;
+    else if (dynamic_cast<GreaterEqualExpr *>(expr)) op = Opcode::GE;
+    else if (dynamic_cast<EqualExpr *>(expr)) op = Opcode::EQ;
+    else if (dynamic_cast<NotEqualExpr *>(expr)) op = Opcode::NE;
+    else if (dynamic_cast<AndExpr *>(expr)) op = Opcode::AND;
+    else if (dynamic_cast<OrExpr *>(expr)) op = Opcode::OR;
+    else throw std::runtime_error("Unsupported operator for the bytecode target");
+
+    int mark = tempTop;
+    int left = compileExpr(expr->getLeft());
+
+    // x + k y x - k usan una sola instrucción con la constante
+    ValueExpr *constant = dynamic_cast<ValueExpr *>(expr->getRight());
+    if (constant && (op == Opcode::ADD || op == Opcode::SUB))
+    {
+        int k = static_cast<int32_t>(constant->getValue());
+        tempTop = mark;
+        int dst = destination(target);
+        emit(Opcode::ADDK, {dst, left, op == Opcode::ADD ? k : -k});
+        return dst;
+    }
+
+    // Una llamada a la derecha puede modificar el local por referencia
+    if (!isTemp(left) && containsCall(expr->getRight()))
+    {
+        int copy = allocTemp();
+        emit(Opcode::MOVE, {copy, left});
+        left = copy;
+    }
+    int right = compileExpr(expr->getRight());
+    tempTop = mark;
+    int dst = destination(target);
+    emit(op, {dst, left, right});
+    return dst;
+}
+
+// Los argumentos se evalúan en registros consecutivos en la cima de los
+// temporales, que pasan a ser los primeros registros del marco llamado
+int BytecodeCompiler::compileCall(FunctionCallExpr *call, int target)
+{
+    const std::string &callee = call->getFunctionName();
+    auto it = functionIndex.find(callee);
+    if (it == functionIndex.end())
+    {
+        throw std::runtime_error("Call to undefined function " + callee);
+    }
+
+    const std::vector<AstNode *> &args = call->getArguments();
+    int argStart = tempTop;
+    for (size_t i = 0; i < args.size(); ++i)
+    {
+        int reg = allocTemp();
+        if (SymbolTable::isReferenceParam(callee, i))
+        {
+            VariableExpr *var = dynamic_cast<VariableExpr *>(args[i]);
+            if (!var)
+            {
+                throw std::runtime_error("Argument " + std::to_string(i + 1) + " of call to " + callee +
+                                         " must be a variable");
+            }
+            addressOf(var->getVarName(), reg);
+        }
+        else
+        {
+            compileExpr(args[i], reg);
+        }
+        tempTop = reg + 1;
+    }
+
+    tempTop = argStart;
+    int dst = destination(target);
+    emit(Opcode::CALL, {dst, it->second, argStart});
+    return dst;
+}
+
+// Deja en un temporal la dirección absoluta de a[index]
+int BytecodeCompiler::elementAddress(ArrayAccess *access)
+{
+    const std::string &varName = access->getVarName();
+    bool global = SymbolTable::isGlobal(functionName, varName);
+    bool pointer = !global && SymbolTable::isReference(functionName, varName);
+    int size = SymbolTable::getArraySize(functionName, varName);
+    bool check = codeGenOptions().boundsCheck && access->isBoundsChecked() && size > 0;
+
+    if (ValueExpr *constant = dynamic_cast<ValueExpr *>(access->getIndex()))
+    {
+        int index = static_cast<int>(constant->getValue());
+        if (check && (index < 0 || index >= size))
+        {
+            throw std::runtime_error("Array index out of bounds: " + varName + "[" + std::to_string(index) + "]");
+        }
+        int address = allocTemp();
+        if (global)
+        {
+            emit(Opcode::LOADK, {address, globals.at(varName) + index});
+        }
+        else if (pointer)
+        {
+            emit(Opcode::ADDK, {address, variableRegister(varName), index});
+        }
+        else
+        {
+            emit(Opcode::ADDR, {address, variableRegister(varName) + index});
+        }
+        return address;
+    }
+
+    int index = compileExpr(access->getIndex());
+    if (check)
+    {
+        emit(Opcode::CHECK, {index, size});
+    }
+    int address = allocTemp();
+    if (global)
+    {
+        emit(Opcode::ADDK, {address, index, globals.at(varName)});
+    }
+    else if (pointer)
+    {
+        emit(Opcode::ADD, {address, variableRegister(varName), index});
+    }
+    else
+    {
+        emit(Opcode::ADDR, {address, variableRegister(varName)});
+        emit(Opcode::ADD, {address, address, index});
+    }
+    return address;
+}
+
+void BytecodeCompiler::addressOf(const std::string &varName, int dst)
+{
+    if (SymbolTable::isGlobal(functionName, varName))
+    {
+        emit(Opcode::LOADK, {dst, globals.at(varName)});
+    }
+    else if (SymbolTable::isReference(functionName, varName))
+    {
+        emit(Opcode::MOVE, {dst, variableRegister(varName)});
+    }
+    else
+    {
+        emit(Opcode::ADDR, {dst, variableRegister(varName)});
+    }
+}
+
+int BytecodeCompiler::emit(Opcode op, std::initializer_list<int32_t> operands)
+{
+    int position = static_cast<int>(result.code.size());
+    result.code.push_back(static_cast<int32_t>(op));
+    result.code.insert(result.code.end(), operands.begin(), operands.end());
+    return position;
+}
+
+void BytecodeCompiler::patch(int position, int32_t value)
+{
+    result.code[position] = value;
+}
+
+int BytecodeCompiler::allocTemp()
+{
+    int reg = tempTop++;
+    frameSize = std::max(frameSize, tempTop);
+    return reg;
+}
+
+int BytecodeCompiler::destination(int target)
+{
+    return target >= 0 ? target : allocTemp();
+}
+
+bool BytecodeCompiler::containsCall(AstNode *node)
+{
+    if (!node)
+    {
+        return false;
+    }
+    bool found = dynamic_cast<FunctionCallExpr *>(node) != nullptr;
+    node->forEachChild([&](AstNode *&child)
+    {
+        found = found || containsCall(child);
+    });
+    return found;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include "Ast.hpp"
+#include "Bytecode.hpp"
+
+// Traduce el AST a bytecode de registros. Parámetros y locales ocupan los
+// primeros registros del marco (los arreglos, uno por elemento) y los
+// temporales se asignan como pila por encima de ellos.
+class BytecodeCompiler
+{
+public:
+    BytecodeProgram compile(ProgramNode *program);
+
+private:
+    BytecodeProgram result;
+    std::unordered_map<std::string, int> functionIndex;
+    std::unordered_map<std::string, int> globals;
+    std::unordered_map<std::string, int> strings;
+    std::unordered_map<std::string, int> registers;
+    std::string functionName;
+    int numVars = 0;
+    int tempTop = 0;
+    int frameSize = 0;
+
+    void compileFunction(FunctionDeclExpr *func);
+    void allocateVariables(FunctionDeclExpr *func);
+    void reserveRegisters(const std::string &name, int count);
+
+    void compileStatement(AstNode *node);
+    int compileExpr(AstNode *node, int target = -1);
+    int compileBinary(BinaryExpr *expr, int target);
+    int compileCall(FunctionCallExpr *call, int target);
+    int elementAddress(ArrayAccess *access);
+    void addressOf(const std::string &varName, int dst);
+
+    int emit(Opcode op, std::initializer_list<int32_t> operands);
+    void patch(int position, int32_t value);
+    int allocTemp();
+    int destination(int target);
+    bool isTemp(int reg) const { return reg >= numVars; }
+    int variableRegister(const std::string &varName) const;
+
+    static bool containsCall(AstNode *node);
+};
@@ -0,0 +1,376 @@
+#include "BytecodeVm.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+#if defined(__GNUC__)
+#define MINICPP_THREADED_DISPATCH 1
+#endif
+
+// La salida pendiente se escribe antes de informar del error
+static void fail(const std::string &message)
+{
+    std::fflush(stdout);
+    throw std::runtime_error(message);
+}
+
+static inline int32_t wrapAdd(int32_t a, int32_t b)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b));
+}
+
+static inline int32_t wrapSub(int32_t a, int32_t b)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(a) - static_cast<uint32_t>(b));
+}
+
+static inline int32_t wrapMul(int32_t a, int32_t b)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(a) * static_cast<uint32_t>(b));
+}
+
+BytecodeVm::BytecodeVm(const BytecodeProgram &program, size_t memoryWords)
+    : program(program), memory(std::min<size_t>(memoryWords, INT32_MAX))
+{
+    verify();
+}
+
+// Comprueba una sola vez lo que el intérprete da por válido: códigos de
+// operación, registros dentro del marco y destinos de salto
+void BytecodeVm::verify() const
+{
+    const std::vector<int32_t> &code = program.code;
+    if (program.globalsSize < 0 || static_cast<size_t>(program.globalsSize) >= memory.size())
+    {
+        throw std::runtime_error("Invalid bytecode: globals do not fit in memory");
+    }
+
+    std::vector<const BytecodeFunction *> functions;
+    for (const BytecodeFunction &func : program.functions)
+    {
+        if (func.entry < 0 || static_cast<size_t>(func.entry) >= code.size() || func.frameSize < func.params ||
+            func.params < 0)
+        {
+            throw std::runtime_error("Invalid bytecode: bad function " + func.name);
+        }
+        functions.push_back(&func);
+    }
+    std::sort(functions.begin(), functions.end(), [](const BytecodeFunction *a, const BytecodeFunction *b)
+    {
+        return a->entry < b->entry;
+    });
+    if (functions.empty() || functions.front()->entry != 0)
+    {
+        throw std::runtime_error("Invalid bytecode: code outside of any function");
+    }
+
+    std::vector<bool> starts(code.size() + 1, false);
+    std::vector<std::pair<size_t, int32_t>> targets;
+    for (size_t f = 0; f < functions.size(); ++f)
+    {
+        size_t end = f + 1 < functions.size() ? static_cast<size_t>(functions[f + 1]->entry) : code.size();
+        size_t pc = static_cast<size_t>(functions[f]->entry);
+        Opcode last = Opcode::OPCODE_COUNT;
+        while (pc < end)
+        {
+            if (code[pc] < 0 || code[pc] >= static_cast<int32_t>(Opcode::OPCODE_COUNT))
+            {
+                throw std::runtime_error("Invalid bytecode: unknown opcode at " + std::to_string(pc));
+            }
+            last = static_cast<Opcode>(code[pc]);
+            const char *kinds = opcodeOperandKinds(last);
+            size_t count = std::char_traits<char>::length(kinds);
+            if (pc + count >= end)
+            {
+                throw std::runtime_error("Invalid bytecode: truncated instruction at " + std::to_string(pc));
+            }
+            starts[pc] = true;
+            for (size_t i = 0; i < count; ++i)
+            {
+                int32_t operand = code[pc + 1 + i];
+                bool valid = true;
+                switch (kinds[i])
+                {
+                case 'R': valid = operand >= 0 && operand < functions[f]->frameSize; break;
+                case 'G': valid = operand >= 0 && operand < program.globalsSize; break;
+                case 'F': valid = operand >= 0 && static_cast<size_t>(operand) < program.functions.size(); break;
+                case 'S': valid = operand >= 0 && static_cast<size_t>(operand) < program.strings.size(); break;
+                case 'T': targets.emplace_back(pc, operand); break;
+                default: break;
+                }
+                if (!valid)
+                {
+                    throw std::runtime_error("Invalid bytecode: bad operand at " + std::to_string(pc));
+                }
+            }
+            pc += count + 1;
+        }
+        if (last != Opcode::RET && last != Opcode::RET0 && last != Opcode::JMP)
+        {
+            throw std::runtime_error("Invalid bytecode: function " + functions[f]->name + " does not end in a return");
+        }
+    }
+
+    for (const auto &target : targets)
+    {
+        if (target.second < 0 || static_cast<size_t>(target.second) >= code.size() || !starts[target.second])
+        {
+            throw std::runtime_error("Invalid bytecode: bad jump target at " + std::to_string(target.first));
+        }
+    }
+}
+
+int BytecodeVm::run()
+{
+    struct Frame
+    {
+        int32_t returnPc;
+        int32_t fp;
+        int32_t dst;
+    };
+
+    const int32_t *code = program.code.data();
+    const BytecodeFunction *functions = program.functions.data();
+    int32_t *mem = memory.data();
+    const int64_t capacity = static_cast<int64_t>(memory.size());
+    std::vector<Frame> frames;
+
+    const BytecodeFunction &mainFunction = functions[program.mainFunction];
+    int64_t fp = program.globalsSize;
+    if (fp + mainFunction.frameSize > capacity)
+    {
+        fail("Stack overflow");
+    }
+    std::fill(mem, mem + fp + mainFunction.frameSize, 0);
+    int32_t *r = mem + fp;
+    int32_t pc = mainFunction.entry;
+    int32_t value = 0;
+
+#ifdef MINICPP_THREADED_DISPATCH
+    static void *const dispatchTable[] = {
+        &&op_LOADK, &&op_MOVE, &&op_ADD, &&op_ADDK, &&op_SUB, &&op_MUL, &&op_DIV, &&op_MOD,
+        &&op_LT, &&op_GT, &&op_LE, &&op_GE, &&op_EQ, &&op_NE, &&op_AND, &&op_OR,
+        &&op_LOADG, &&op_STOREG, &&op_LOADI, &&op_STOREI, &&op_ADDR, &&op_CHECK,
+        &&op_JMP, &&op_JZ, &&op_CALL, &&op_RET, &&op_RET0,
+        &&op_PRINT, &&op_PRINTS, &&op_ENDL, &&op_READ};
+    static_assert(sizeof(dispatchTable) / sizeof(dispatchTable[0]) == static_cast<size_t>(Opcode::OPCODE_COUNT),
+                  "dispatch table out of sync with Opcode");
+#define VM_CASE(name) op_##name:
+#define VM_NEXT() goto *dispatchTable[code[pc]]
+    VM_NEXT();
+#else
+#define VM_CASE(name) case Opcode::name:
+#define VM_NEXT() continue
+    for (;;)
+    {
+        switch (static_cast<Opcode>(code[pc]))
+        {
+#endif
+
+#define A code[pc + 1]
+#define B code[pc + 2]
+#define C code[pc + 3]
+#define VM_BINARY(name, expr)        \
+    VM_CASE(name)                    \
+    {                                \
+        int32_t x = r[B], y = r[C];  \
+        r[A] = (expr);               \
+        pc += 4;                     \
+        VM_NEXT();                   \
+    }
+
+    VM_CASE(LOADK)
+    {
+        r[A] = B;
+        pc += 3;
+        VM_NEXT();
+    }
+    VM_CASE(MOVE)
+    {
+        r[A] = r[B];
+        pc += 3;
+        VM_NEXT();
+    }
+    VM_BINARY(ADD, wrapAdd(x, y))
+    VM_CASE(ADDK)
+    {
+        r[A] = wrapAdd(r[B], C);
+        pc += 4;
+        VM_NEXT();
+    }
+    VM_BINARY(SUB, wrapSub(x, y))
+    VM_BINARY(MUL, wrapMul(x, y))
+    VM_CASE(DIV)
+    {
+        int32_t x = r[B], y = r[C];
+        if (y == 0)
+        {
+            fail("Division by zero");
+        }
+        r[A] = (x == INT32_MIN && y == -1) ? x : x / y;
+        pc += 4;
+        VM_NEXT();
+    }
+    VM_CASE(MOD)
+    {
+        int32_t x = r[B], y = r[C];
+        if (y == 0)
+        {
+            fail("Division by zero");
+        }
+        r[A] = (y == -1) ? 0 : x % y;
+        pc += 4;
+        VM_NEXT();
+    }
+    VM_BINARY(LT, x < y)
+    VM_BINARY(GT, x > y)
+    VM_BINARY(LE, x <= y)
+    VM_BINARY(GE, x >= y)
+    VM_BINARY(EQ, x == y)
+    VM_BINARY(NE, x != y)
+    VM_BINARY(AND, x & y)
+    VM_BINARY(OR, x | y)
+    VM_CASE(LOADG)
+    {
+        r[A] = mem[B];
+        pc += 3;
+        VM_NEXT();
+    }
+    VM_CASE(STOREG)
+    {
+        mem[A] = r[B];
+        pc += 3;
+        VM_NEXT();
+    }
+    VM_CASE(LOADI)
+    {
+        int32_t address = r[B];
+        if (address < 0 || address >= capacity)
+        {
+            fail("Invalid memory access");
+        }
+        r[A] = mem[address];
+        pc += 3;
+        VM_NEXT();
+    }
+    VM_CASE(STOREI)
+    {
+        int32_t address = r[A];
+        if (address < 0 || address >= capacity)
+        {
+            fail("Invalid memory access");
+        }
+        mem[address] = r[B];
+        pc += 3;
+        VM_NEXT();
+    }
+    VM_CASE(ADDR)
+    {
+        r[A] = static_cast<int32_t>(fp + B);
+        pc += 3;
+        VM_NEXT();
+    }
+    VM_CASE(CHECK)
+    {
+        if (static_cast<uint32_t>(r[A]) >= static_cast<uint32_t>(B))
+        {
+            fail("Error: array index out of bounds");
+        }
+        pc += 3;
+        VM_NEXT();
+    }
+    VM_CASE(JMP)
+    {
+        pc = A;
+        VM_NEXT();
+    }
+    VM_CASE(JZ)
+    {
+        pc = r[A] == 0 ? B : pc + 3;
+        VM_NEXT();
+    }
+    VM_CASE(CALL)
+    {
+        const BytecodeFunction &callee = functions[B];
+        int64_t calleeFp = fp + C;
+        if (calleeFp + callee.frameSize > capacity)
+        {
+            fail("Stack overflow");
+        }
+        std::fill(mem + calleeFp + callee.params, mem + calleeFp + callee.frameSize, 0);
+        frames.push_back({pc + 4, static_cast<int32_t>(fp), A});
+        fp = calleeFp;
+        r = mem + fp;
+        pc = callee.entry;
+        VM_NEXT();
+    }
+    VM_CASE(RET)
+    {
+        value = r[A];
+        goto ret;
+    }
+    VM_CASE(RET0)
+    {
+        value = 0;
+    ret:
+        if (frames.empty())
+        {
+            std::fflush(stdout);
+            return value;
+        }
+        Frame frame = frames.back();
+        frames.pop_back();
+        fp = frame.fp;
+        r = mem + fp;
+        r[frame.dst] = value;
+        pc = frame.returnPc;
+        VM_NEXT();
+    }
+    VM_CASE(PRINT)
+    {
+        std::printf("%d", r[A]);
+        pc += 2;
+        VM_NEXT();
+    }
+    VM_CASE(PRINTS)
+    {
+        std::fputs(program.strings[A].c_str(), stdout);
+        pc += 2;
+        VM_NEXT();
+    }
+    VM_CASE(ENDL)
+    {
+        std::putchar('\n');
+        pc += 1;
+        VM_NEXT();
+    }
+    VM_CASE(READ)
+    {
+        int input = 0;
+        if (std::scanf("%d", &input) != 1)
+        {
+            input = 0;
+        }
+        r[A] = input;
+        pc += 2;
+        VM_NEXT();
+    }
+
+#ifndef MINICPP_THREADED_DISPATCH
+        case Opcode::OPCODE_COUNT:
+            break;
+        }
+        fail("Invalid opcode");
+    }
+#endif
+
+#undef A
+#undef B
+#undef C
+#undef VM_BINARY
+#undef VM_CASE
+#undef VM_NEXT
+    return value;
+}
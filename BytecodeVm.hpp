@@ -0,0 +1,23 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Bytecode.hpp"
+
+// Intérprete del bytecode de registros. Con GCC/Clang el despacho es por
+// goto computado; en otros compiladores se usa un switch.
+class BytecodeVm
+{
+public:
+    // memoryWords limita globales más pila de marcos
+    explicit BytecodeVm(const BytecodeProgram &program, size_t memoryWords = 1 << 22);
+
+    // Ejecuta main y devuelve su valor de retorno
+    int run();
+
+private:
+    const BytecodeProgram &program;
+    std::vector<int32_t> memory;
+
+    void verify() const;
+};
@@ -0,0 +1,133 @@
+#include "ConstexprEvaluator.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+// Memoria del intérprete para las evaluaciones: solo hay marcos, no globales
+static const size_t EVALUATION_MEMORY_WORDS = 1 << 18;
+
+void ConstexprEvaluator::run(ProgramNode *program)
+{
+    if (budget <= 0)
+    {
+        return;
+    }
+
+    callBudget = std::max<int64_t>(budget / 10, 1);
+    findPureFunctions(program);
+    if (pure.empty())
+    {
+        return;
+    }
+
+    // Fuera del intérprete todo acceso fuera de rango es indefinido, así que
+    // aquí se comprueban todos y la llamada se deja sin evaluar si falla
+    Interpreter interpreter(EVALUATION_MEMORY_WORDS, true);
+    try
+    {
+        interpreter.load(program);
+    }
+    catch (const std::runtime_error &)
+    {
+        // Los errores del programa los informa el generador de código
+        return;
+    }
+
+    for (AstNode *node : program->getFunctions())
+    {
+        FunctionDeclExpr *func = static_cast<FunctionDeclExpr *>(node);
+        for (AstNode *&stmt : func->getStatements())
+        {
+            fold(stmt, interpreter);
+        }
+    }
+}
+
+// Una función es pura si no tiene E/S, no toca globales, no recibe nada por
+// referencia y solo llama a funciones puras
+void ConstexprEvaluator::findPureFunctions(ProgramNode *program)
+{
+    pure.clear();
+    FlatAst flat(program);
+    std::unordered_map<std::string, std::vector<int>> callees;
+
+    for (const FlatFunction &function : flat.getFunctions())
+    {
+        const std::string &name = SymbolTable::functionName(function.functionId);
+        bool candidate = !flat.hasSideEffects(function);
+        for (uint32_t i = 0; i < function.paramCount; ++i)
+        {
+            candidate = candidate && !SymbolTable::isReferenceParam(function.functionId, i);
+        }
+        if (candidate)
+        {
+            pure.insert(name);
+            callees[name] = flat.callees(function);
+        }
+    }
+
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (auto it = pure.begin(); it != pure.end();)
+        {
+            bool callsImpure = false;
+            for (int callee : callees[*it])
+            {
+                callsImpure = callsImpure || pure.count(SymbolTable::functionName(callee)) == 0;
+            }
+            if (callsImpure)
+            {
+                it = pure.erase(it);
+                changed = true;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+}
+
+// Primero los hijos, para que f(g(1)) se resuelva de adentro hacia afuera
+void ConstexprEvaluator::fold(AstNode *&node, Interpreter &interpreter)
+{
+    if (!node)
+    {
+        return;
+    }
+    node->forEachChild([&](AstNode *&child)
+    {
+        fold(child, interpreter);
+    });
+
+    FunctionCallExpr *call = dynamic_cast<FunctionCallExpr *>(node);
+    if (!call || pure.count(call->getFunctionName()) == 0 || budget <= 0)
+    {
+        return;
+    }
+
+    std::vector<int32_t> args;
+    for (AstNode *arg : call->getArguments())
+    {
+        ValueExpr *constant = dynamic_cast<ValueExpr *>(arg);
+        if (!constant)
+        {
+            return;
+        }
+        args.push_back(static_cast<int32_t>(constant->getValue()));
+    }
+
+    // Una llamada que no termina no debe agotar el presupuesto de las demás
+    int64_t steps = std::min(budget, callBudget);
+    int32_t value = 0;
+    bool evaluated = interpreter.evaluate(call->getFunctionName(), args, steps, value);
+    budget -= std::min(budget, callBudget) - steps;
+    if (evaluated)
+    {
+        delete node;
+        node = new ValueExpr(value);
+    }
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include "Ast.hpp"
+#include "FlatAst.hpp"
+#include "Interpreter.hpp"
+
+// Sustituye por su valor las llamadas con argumentos constantes a funciones
+// puras (sin E/S, sin globales ni parámetros por referencia). Las llamadas se
+// evalúan con el intérprete; budget acota el total de iteraciones de ciclo y
+// llamadas que puede consumir la pasada, y cada llamada usa a lo sumo un décimo.
+class ConstexprEvaluator
+{
+public:
+    explicit ConstexprEvaluator(int64_t budget) : budget(budget) {}
+
+    void run(ProgramNode *program);
+
+private:
+    int64_t budget;
+    int64_t callBudget = 0;
+    std::unordered_set<std::string> pure;
+
+    void findPureFunctions(ProgramNode *program);
+    void fold(AstNode *&node, Interpreter &interpreter);
+};
@@ -0,0 +1,204 @@
+#include "FlatAst.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+FlatAst::FlatAst(ProgramNode *program)
+{
+    for (AstNode *node : program->getFunctions())
+    {
+        FunctionDeclExpr *func = static_cast<FunctionDeclExpr *>(node);
+
+        FlatFunction function;
+        function.functionId = SymbolTable::functionId(func->getName());
+        function.paramCount = static_cast<uint32_t>(func->getParams().size());
+        function.firstNode = static_cast<uint32_t>(nodes.size());
+
+        std::vector<uint32_t> statements;
+        for (AstNode *stmt : func->getStatements())
+        {
+            if (stmt)
+            {
+                statements.push_back(flatten(stmt));
+            }
+        }
+
+        function.endNode = static_cast<uint32_t>(nodes.size());
+        function.firstStatement = static_cast<uint32_t>(children.size());
+        function.statementCount = static_cast<uint32_t>(statements.size());
+        children.insert(children.end(), statements.begin(), statements.end());
+        functions.push_back(function);
+    }
+}
+
+std::vector<int> FlatAst::callees(const FlatFunction &function) const
+{
+    std::vector<int> result;
+    for (uint32_t i = function.firstNode; i < function.endNode; ++i)
+    {
+        if (nodes[i].kind == FlatKind::Call &&
+            std::find(result.begin(), result.end(), nodes[i].operand) == result.end())
+        {
+            result.push_back(nodes[i].operand);
+        }
+    }
+    return result;
+}
+
+bool FlatAst::hasSideEffects(const FlatFunction &function) const
+{
+    for (uint32_t i = function.firstNode; i < function.endNode; ++i)
+    {
+        const FlatNode &node = nodes[i];
+        switch (node.kind)
+        {
+        case FlatKind::Print:
+        case FlatKind::StringLiteral:
+        case FlatKind::Endl:
+        case FlatKind::Cin:
+        case FlatKind::ArrayCin:
+            return true;
+        case FlatKind::Variable:
+        case FlatKind::Assign:
+        case FlatKind::ArrayElement:
+        case FlatKind::ArrayAssign:
+            if (node.scope == SymbolTable::GLOBAL_SCOPE)
+            {
+                return true;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    return false;
+}
+
+// Post-orden: los hijos se agregan antes que el nodo que los contiene
+uint32_t FlatAst::flatten(AstNode *node)
+{
+    std::vector<uint32_t> nodeChildren;
+    node->forEachChild([&](AstNode *&child)
+    {
+        if (child)
+        {
+            nodeChildren.push_back(flatten(child));
+        }
+    });
+
+    FlatKind kind;
+    if (ValueExpr *value = dynamic_cast<ValueExpr *>(node))
+    {
+        return addNode(FlatKind::Value, static_cast<int32_t>(value->getValue()), nodeChildren);
+    }
+    if (VariableExpr *var = dynamic_cast<VariableExpr *>(node))
+    {
+        return addVariable(FlatKind::Variable, var->getVarRef(), nodeChildren);
+    }
+    if (AssignExpr *assign = dynamic_cast<AssignExpr *>(node))
+    {
+        return addVariable(FlatKind::Assign, assign->getVarRef(), nodeChildren);
+    }
+    if (CinExpr *cin = dynamic_cast<CinExpr *>(node))
+    {
+        return addVariable(FlatKind::Cin, cin->getVarRef(), nodeChildren);
+    }
+    if (ArrayElementExpr *element = dynamic_cast<ArrayElementExpr *>(node))
+    {
+        return addVariable(FlatKind::ArrayElement, element->getVarRef(), nodeChildren);
+    }
+    if (ArrayAssignExpr *assign = dynamic_cast<ArrayAssignExpr *>(node))
+    {
+        return addVariable(FlatKind::ArrayAssign, assign->getVarRef(), nodeChildren);
+    }
+    if (ArrayCinExpr *cin = dynamic_cast<ArrayCinExpr *>(node))
+    {
+        return addVariable(FlatKind::ArrayCin, cin->getVarRef(), nodeChildren);
+    }
+    if (binaryKind(node, kind))
+    {
+        return addNode(kind, 0, nodeChildren);
+    }
+    if (FunctionCallExpr *call = dynamic_cast<FunctionCallExpr *>(node))
+    {
+        return addNode(FlatKind::Call, call->getCalleeId(), nodeChildren);
+    }
+    if (dynamic_cast<PrintStmt *>(node))
+    {
+        return addNode(FlatKind::Print, 0, nodeChildren);
+    }
+    if (StringLiteralExpr *literal = dynamic_cast<StringLiteralExpr *>(node))
+    {
+        strings.push_back(literal->getText());
+        return addNode(FlatKind::StringLiteral, static_cast<int32_t>(strings.size() - 1), nodeChildren);
+    }
+    if (dynamic_cast<EndlExpr *>(node))
+    {
+        return addNode(FlatKind::Endl, 0, nodeChildren);
+    }
+    if (dynamic_cast<ExprList *>(node))
+    {
+        return addNode(FlatKind::List, 0, nodeChildren);
+    }
+    if (IfStmt *ifStmt = dynamic_cast<IfStmt *>(node))
+    {
+        uint32_t index = addNode(FlatKind::If, 0, nodeChildren);
+        if (ifStmt->getElseBody())
+        {
+            nodes[index].flags |= FlatNode::HAS_ELSE;
+        }
+        return index;
+    }
+    if (dynamic_cast<WhileStmt *>(node))
+    {
+        return addNode(FlatKind::While, 0, nodeChildren);
+    }
+    if (dynamic_cast<ReturnStmt *>(node))
+    {
+        return addNode(FlatKind::Return, 0, nodeChildren);
+    }
+    throw std::runtime_error("Unsupported node in flat AST");
+}
+
+uint32_t FlatAst::addNode(FlatKind kind, int32_t operand, const std::vector<uint32_t> &nodeChildren)
+{
+    FlatNode node;
+    node.kind = kind;
+    node.flags = 0;
+    node.scope = 0;
+    node.operand = operand;
+    node.firstChild = static_cast<uint32_t>(children.size());
+    node.childCount = static_cast<uint32_t>(nodeChildren.size());
+    children.insert(children.end(), nodeChildren.begin(), nodeChildren.end());
+    nodes.push_back(node);
+    return static_cast<uint32_t>(nodes.size() - 1);
+}
+
+uint32_t FlatAst::addVariable(FlatKind kind, VarRef ref, const std::vector<uint32_t> &nodeChildren)
+{
+    if (ref.function < 0 || ref.function > UINT16_MAX)
+    {
+        throw std::runtime_error("Too many functions for the flat AST");
+    }
+    uint32_t index = addNode(kind, ref.slot, nodeChildren);
+    nodes[index].scope = static_cast<uint16_t>(ref.function);
+    return index;
+}
+
+bool FlatAst::binaryKind(AstNode *node, FlatKind &kind)
+{
+    if (dynamic_cast<AddExpr *>(node)) kind = FlatKind::Add;
+    else if (dynamic_cast<SubExpr *>(node)) kind = FlatKind::Sub;
+    else if (dynamic_cast<MulExpr *>(node)) kind = FlatKind::Mul;
+    else if (dynamic_cast<DivExpr *>(node)) kind = FlatKind::Div;
+    else if (dynamic_cast<ModExpr *>(node)) kind = FlatKind::Mod;
+    else if (dynamic_cast<GreaterExpr *>(node)) kind = FlatKind::Greater;
+    else if (dynamic_cast<LessExpr *>(node)) kind = FlatKind::Less;
+    else if (dynamic_cast<GreaterEqualExpr *>(node)) kind = FlatKind::GreaterEqual;
+    else if (dynamic_cast<LessEqualExpr *>(node)) kind = FlatKind::LessEqual;
+    else if (dynamic_cast<NotEqualExpr *>(node)) kind = FlatKind::NotEqual;
+    else if (dynamic_cast<EqualExpr *>(node)) kind = FlatKind::Equal;
+    else if (dynamic_cast<AndExpr *>(node)) kind = FlatKind::And;
+    else if (dynamic_cast<OrExpr *>(node)) kind = FlatKind::Or;
+    else return false;
+    return true;
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Ast.hpp"
+
+enum class FlatKind : uint8_t
+{
+    Value,
+    Variable,
+    Assign,
+    Cin,
+    ArrayElement,
+    ArrayAssign,
+    ArrayCin,
+    Add,
+    Sub,
+    Mul,
+    Div,
+    Mod,
+    Greater,
+    Less,
+    GreaterEqual,
+    LessEqual,
+    NotEqual,
+    Equal,
+    And,
+    Or,
+    Call,
+    Print,
+    StringLiteral,
+    Endl,
+    List,
+    If,
+    While,
+    Return
+};
+
+// Nodo de 16 bytes. operand depende del tipo: la constante, el slot de la
+// variable (scope es su función, SymbolTable::GLOBAL_SCOPE para globales),
+// el id de la función llamada o el índice del literal de texto. Los hijos son
+// children[firstChild, firstChild + childCount). Como scope ocupa 16 bits,
+// un programa con más de UINT16_MAX funciones no puede aplanarse.
+struct FlatNode
+{
+    FlatKind kind;
+    uint8_t flags;
+    uint16_t scope;
+    int32_t operand;
+    uint32_t firstChild;
+    uint32_t childCount;
+
+    static constexpr uint8_t HAS_ELSE = 1;
+
+    VarRef var() const { return VarRef{scope, operand}; }
+};
+
+// Cuerpo de una función: sus nodos ocupan [firstNode, endNode) en post-orden,
+// así que cada hijo precede a su padre y una pasada es un ciclo sobre el rango
+struct FlatFunction
+{
+    int functionId;
+    uint32_t paramCount;
+    uint32_t firstNode;
+    uint32_t endNode;
+    uint32_t firstStatement;
+    uint32_t statementCount;
+};
+
+// Representación plana del programa para las pasadas de análisis: los nodos
+// viven en un arreglo contiguo y se direccionan con índices de 32 bits, sin
+// nombres como cadenas ni llamadas virtuales. Se construye una vez a partir
+// del AST ya analizado y no se modifica.
+class FlatAst
+{
+public:
+    explicit FlatAst(ProgramNode *program);
+
+    const std::vector<FlatNode> &getNodes() const { return nodes; }
+    const std::vector<uint32_t> &getChildren() const { return children; }
+    const std::vector<FlatFunction> &getFunctions() const { return functions; }
+    const std::string &getString(int32_t index) const { return strings[index]; }
+
+    const FlatNode &child(const FlatNode &node, uint32_t i) const { return nodes[children[node.firstChild + i]]; }
+
+    // Cantidad de nodos del cuerpo, igual que al recorrer el árbol
+    static uint32_t size(const FlatFunction &function) { return function.endNode - function.firstNode; }
+
+    // Funciones llamadas desde el cuerpo, sin repetir
+    std::vector<int> callees(const FlatFunction &function) const;
+
+    // E/S o acceso a una variable global en el cuerpo
+    bool hasSideEffects(const FlatFunction &function) const;
+
+private:
+    std::vector<FlatNode> nodes;
+    std::vector<uint32_t> children;
+    std::vector<FlatFunction> functions;
+    std::vector<std::string> strings;
+
+    uint32_t flatten(AstNode *node);
+    uint32_t addNode(FlatKind kind, int32_t operand, const std::vector<uint32_t> &nodeChildren);
+    uint32_t addVariable(FlatKind kind, VarRef ref, const std::vector<uint32_t> &nodeChildren);
+
+    static bool binaryKind(AstNode *node, FlatKind &kind);
+};
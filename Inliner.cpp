@@ -0,0 +1,480 @@
+#include "Inliner.hpp"
+#include <algorithm>
+#include <functional>
+
+// Costo aproximado de una llamada: paso de argumentos, jal, retorno y marco
+static const int CALL_OVERHEAD = 4;
+
+void Inliner::run(ProgramNode *program)
+{
+    if (budget <= 0)
+    {
+        return;
+    }
+
+    buildCallGraph(program);
+
+    for (const std::string &name : bottomUpOrder(program))
+    {
+        FunctionDeclExpr *func = functions[name];
+        inlineStatements(func, func->getStatements(), 0, profileCount(func->getProfileSite(), 0));
+        sizes[name] = 0;
+        bool effects = false;
+        for (AstNode *stmt : func->getStatements())
+        {
+            sizes[name] += nodeCount(stmt);
+            effects = effects || hasSideEffects(stmt);
+        }
+
+        // Ya con sus propias llamadas expandidas: si termina en return y no
+        // tiene efectos, sus llamadas pueden adelantarse desde una expresión
+        const std::vector<AstNode *> &body = func->getStatements();
+        if (!effects && !body.empty() && dynamic_cast<ReturnStmt *>(body.back()))
+        {
+            pureFunctions.insert(name);
+        }
+    }
+
+    removeDeadFunctions(program);
+}
+
+void Inliner::buildCallGraph(ProgramNode *program)
+{
+    functions.clear();
+    callGraph.clear();
+    sizes.clear();
+    pureFunctions.clear();
+
+    for (AstNode *node : program->getFunctions())
+    {
+        FunctionDeclExpr *func = static_cast<FunctionDeclExpr *>(node);
+        functions[func->getName()] = func;
+    }
+
+    FlatAst flat(program);
+    for (const FlatFunction &function : flat.getFunctions())
+    {
+        const std::string &name = SymbolTable::functionName(function.functionId);
+        std::unordered_set<std::string> &callees = callGraph[name];
+        for (int callee : flat.callees(function))
+        {
+            callees.insert(SymbolTable::functionName(callee));
+        }
+        sizes[name] = static_cast<int>(FlatAst::size(function));
+    }
+}
+
+bool Inliner::isRecursive(const std::string &name) const
+{
+    std::unordered_set<std::string> visited;
+    std::vector<std::string> pending;
+
+    auto it = callGraph.find(name);
+    if (it == callGraph.end())
+    {
+        return false;
+    }
+    pending.assign(it->second.begin(), it->second.end());
+
+    while (!pending.empty())
+    {
+        std::string current = pending.back();
+        pending.pop_back();
+        if (current == name)
+        {
+            return true;
+        }
+        if (!visited.insert(current).second)
+        {
+            continue;
+        }
+        auto callees = callGraph.find(current);
+        if (callees != callGraph.end())
+        {
+            pending.insert(pending.end(), callees->second.begin(), callees->second.end());
+        }
+    }
+    return false;
+}
+
+// Orden en que las funciones llamadas se procesan antes que sus llamadores
+std::vector<std::string> Inliner::bottomUpOrder(ProgramNode *program) const
+{
+    std::vector<std::string> order;
+    std::unordered_set<std::string> visited;
+
+    std::function<void(const std::string &)> visit = [&](const std::string &name)
+    {
+        if (!visited.insert(name).second || functions.count(name) == 0)
+        {
+            return;
+        }
+        for (const std::string &callee : callGraph.at(name))
+        {
+            visit(callee);
+        }
+        order.push_back(name);
+    };
+
+    for (AstNode *node : program->getFunctions())
+    {
+        visit(static_cast<FunctionDeclExpr *>(node)->getName());
+    }
+    return order;
+}
+
+void Inliner::inlineStatements(FunctionDeclExpr *caller, std::vector<AstNode *> &statements, int loopDepth,
+                               long long frequency)
+{
+    for (AstNode *&stmt : statements)
+    {
+        if (ExprList *list = dynamic_cast<ExprList *>(stmt))
+        {
+            inlineStatements(caller, list->getExpressions(), loopDepth, frequency);
+        }
+        else if (dynamic_cast<IfStmt *>(stmt) || dynamic_cast<WhileStmt *>(stmt))
+        {
+            IfStmt *ifStmt = dynamic_cast<IfStmt *>(stmt);
+            WhileStmt *loop = dynamic_cast<WhileStmt *>(stmt);
+            int depth = loop ? loopDepth + 1 : loopDepth;
+
+            // La condición del if se evalúa una vez, así que sus llamadas pueden
+            // ir antes; la del while se vuelve a evaluar en cada vuelta
+            std::vector<AstNode **> slots;
+            ExprList *hoisted = nullptr;
+            if (ifStmt)
+            {
+                stmt->forEachChild([&](AstNode *&child)
+                {
+                    if (child == ifStmt->getCondition())
+                    {
+                        collectCallSlots(child, slots);
+                    }
+                });
+                hoisted = hoistCalls(caller, slots, loopDepth, frequency);
+            }
+
+            stmt->forEachChild([&](AstNode *&child)
+            {
+                if (ExprList *body = dynamic_cast<ExprList *>(child))
+                {
+                    // Una rama sin perfil se ejecuta a lo más tanto como el if;
+                    // un cuerpo de ciclo sin perfil puede ejecutarse más
+                    long long count = loop ? profileCount(loop->getProfileSite(), 1)
+                                           : profileCount(ifStmt->getProfileSite(), child == ifStmt->getIfBody() ? 0 : 1);
+                    if (count < 0 && ifStmt)
+                    {
+                        count = frequency;
+                    }
+                    inlineStatements(caller, body->getExpressions(), depth, count);
+                }
+            });
+
+            if (hoisted)
+            {
+                hoisted->addExpression(stmt);
+                stmt = hoisted;
+            }
+        }
+        else
+        {
+            // Las llamadas dentro de la sentencia (sin contar la sentencia misma
+            // si es una llamada) se expanden antes de ella
+            std::vector<AstNode **> slots;
+            stmt->forEachChild([&](AstNode *&child)
+            {
+                if (child)
+                {
+                    collectCallSlots(child, slots);
+                }
+            });
+            ExprList *hoisted = hoistCalls(caller, slots, loopDepth, frequency);
+
+            // Una llamada como sentencia descarta el valor que devuelva
+            FunctionCallExpr *call = dynamic_cast<FunctionCallExpr *>(stmt);
+            if (call && shouldInline(caller, call, loopDepth, frequency))
+            {
+                std::string result;
+                stmt = expandCall(caller, call, result);
+            }
+
+            if (hoisted)
+            {
+                hoisted->addExpression(stmt);
+                stmt = hoisted;
+            }
+        }
+    }
+}
+
+// Expande las llamadas de una expresión, en el orden de los slots, y cambia
+// cada una por la variable que recibe su valor. Adelantar una llamada solo es
+// correcto si ninguna llamada de la expresión tiene efectos, porque entonces
+// su orden respecto al resto de la expresión no se nota. Devuelve los cuerpos
+// expandidos, o nulo si no hubo ninguno
+ExprList *Inliner::hoistCalls(FunctionDeclExpr *caller, const std::vector<AstNode **> &slots, int loopDepth,
+                              long long frequency)
+{
+    for (AstNode **slot : slots)
+    {
+        if (pureFunctions.count(static_cast<FunctionCallExpr *>(*slot)->getFunctionName()) == 0)
+        {
+            return nullptr;
+        }
+    }
+
+    ExprList *hoisted = nullptr;
+    for (AstNode **slot : slots)
+    {
+        FunctionCallExpr *call = static_cast<FunctionCallExpr *>(*slot);
+        if (!shouldInline(caller, call, loopDepth, frequency))
+        {
+            continue;
+        }
+        if (!hoisted)
+        {
+            hoisted = new ExprList();
+        }
+        std::string result;
+        hoisted->addExpression(expandCall(caller, call, result));
+        *slot = new VariableExpr(caller->getName(), result);
+    }
+    return hoisted;
+}
+
+bool Inliner::shouldInline(FunctionDeclExpr *caller, FunctionCallExpr *call, int loopDepth, long long frequency) const
+{
+    auto it = functions.find(call->getFunctionName());
+    if (it == functions.end() || it->second == caller || isRecursive(call->getFunctionName()))
+    {
+        return false;
+    }
+
+    // Un return solo se admite como última sentencia: su valor pasa a una variable
+    FunctionDeclExpr *callee = it->second;
+    const std::vector<AstNode *> &body = callee->getStatements();
+    for (size_t i = 0; i < body.size(); ++i)
+    {
+        bool last = i + 1 == body.size() && dynamic_cast<ReturnStmt *>(body[i]);
+        if (!last && containsReturn(body[i]))
+        {
+            return false;
+        }
+    }
+
+    std::vector<ParamExpr *> params = callee->getParams();
+    const std::vector<AstNode *> &args = call->getArguments();
+    if (params.size() != args.size())
+    {
+        return false;
+    }
+    for (size_t i = 0; i < params.size(); ++i)
+    {
+        if (params[i]->getIsReference() && !dynamic_cast<VariableExpr *>(args[i]))
+        {
+            return false;
+        }
+    }
+
+    // Dentro de ciclos la llamada se repite, así que se tolera más crecimiento.
+    // Con perfil se usa la frecuencia medida: una llamada que se ejecuta más
+    // veces que la función que la contiene es caliente, y una que nunca se
+    // ejecutó solo se expande si el código no crece
+    int limit = loopDepth > 0 ? budget * 2 : budget;
+    long long entries = profileCount(caller->getProfileSite(), 0);
+    if (frequency == 0)
+    {
+        limit = 0;
+    }
+    else if (frequency > 0 && entries > 0)
+    {
+        limit = frequency > entries ? budget * 2 : budget;
+    }
+    int growth = sizes.at(callee->getName()) - (CALL_OVERHEAD + static_cast<int>(args.size()));
+    return growth <= limit;
+}
+
+// Si la función termina en return, result es la variable del llamador que
+// recibe el valor; el nombre sin '_' final no choca con las demás del prefijo
+ExprList *Inliner::expandCall(FunctionDeclExpr *caller, FunctionCallExpr *call, std::string &result)
+{
+    FunctionDeclExpr *callee = functions.at(call->getFunctionName());
+    std::vector<ParamExpr *> params = callee->getParams();
+    std::vector<AstNode *> args = call->releaseArguments();
+
+    VarRemap remap;
+    remap.sourceFunction = callee->getName();
+    remap.functionName = caller->getName();
+    result = "__inl" + std::to_string(inlinedCount++);
+    remap.prefix = result + "_";
+
+    ExprList *block = new ExprList();
+    for (size_t i = 0; i < params.size(); ++i)
+    {
+        const std::string &paramName = params[i]->getParamName();
+        if (params[i]->getIsReference())
+        {
+            remap.names[paramName] = static_cast<VariableExpr *>(args[i])->getVarName();
+            delete args[i];
+        }
+        else
+        {
+            block->addExpression(new AssignExpr(caller->getName(), remap.prefix + paramName, args[i]));
+        }
+    }
+
+    // Las declaraciones reservan el espacio de los arreglos antes de usarlos
+    for (AstNode *decl : callee->getVarDecls())
+    {
+        block->addExpression(decl->clone(&remap));
+    }
+    for (AstNode *stmt : callee->getStatements())
+    {
+        if (ReturnStmt *ret = dynamic_cast<ReturnStmt *>(stmt))
+        {
+            block->addExpression(new VarDeclExpr(caller->getName(), result));
+            block->addExpression(new AssignExpr(caller->getName(), result, ret->getExpr()->clone(&remap)));
+        }
+        else
+        {
+            block->addExpression(stmt->clone(&remap));
+        }
+    }
+    if (callee->getStatements().empty() || !dynamic_cast<ReturnStmt *>(callee->getStatements().back()))
+    {
+        result.clear();
+    }
+
+    delete call;
+    return block;
+}
+
+void Inliner::removeDeadFunctions(ProgramNode *program)
+{
+    std::vector<AstNode *> &funcs = program->getFunctions();
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        std::unordered_set<std::string> referenced;
+        for (AstNode *node : funcs)
+        {
+            FunctionDeclExpr *func = static_cast<FunctionDeclExpr *>(node);
+            std::unordered_set<std::string> callees;
+            collectCalls(func, callees);
+            callees.erase(func->getName());
+            referenced.insert(callees.begin(), callees.end());
+        }
+
+        auto dead = std::remove_if(funcs.begin(), funcs.end(), [&](AstNode *node)
+        {
+            const std::string &name = static_cast<FunctionDeclExpr *>(node)->getName();
+            if (name == "main" || referenced.count(name))
+            {
+                return false;
+            }
+            delete node;
+            return true;
+        });
+        changed = dead != funcs.end();
+        funcs.erase(dead, funcs.end());
+    }
+}
+
+int Inliner::nodeCount(AstNode *node)
+{
+    if (!node)
+    {
+        return 0;
+    }
+    int count = 1;
+    node->forEachChild([&](AstNode *&child)
+    {
+        count += nodeCount(child);
+    });
+    return count;
+}
+
+void Inliner::collectCalls(AstNode *node, std::unordered_set<std::string> &callees)
+{
+    if (!node)
+    {
+        return;
+    }
+    if (FunctionCallExpr *call = dynamic_cast<FunctionCallExpr *>(node))
+    {
+        callees.insert(call->getFunctionName());
+    }
+    node->forEachChild([&](AstNode *&child)
+    {
+        collectCalls(child, callees);
+    });
+}
+
+// Llamadas del subárbol en el orden en que se evalúan: los argumentos antes
+// que la llamada que los usa
+void Inliner::collectCallSlots(AstNode *&node, std::vector<AstNode **> &slots)
+{
+    node->forEachChild([&](AstNode *&child)
+    {
+        if (child)
+        {
+            collectCallSlots(child, slots);
+        }
+    });
+    if (dynamic_cast<FunctionCallExpr *>(node))
+    {
+        slots.push_back(&node);
+    }
+}
+
+bool Inliner::containsReturn(AstNode *node)
+{
+    if (!node)
+    {
+        return false;
+    }
+    bool found = dynamic_cast<ReturnStmt *>(node) != nullptr;
+    node->forEachChild([&](AstNode *&child)
+    {
+        found = found || containsReturn(child);
+    });
+    return found;
+}
+
+// Si el subárbol puede escribir o leer la E/S, escribir globales o escribir a
+// través de una referencia. Cualquier llamada cuenta como efecto
+bool Inliner::hasSideEffects(AstNode *node)
+{
+    if (!node)
+    {
+        return false;
+    }
+    if (dynamic_cast<FunctionCallExpr *>(node) || dynamic_cast<PrintStmt *>(node) ||
+        dynamic_cast<StringLiteralExpr *>(node) || dynamic_cast<EndlExpr *>(node) ||
+        dynamic_cast<CinExpr *>(node) || dynamic_cast<ArrayCinExpr *>(node))
+    {
+        return true;
+    }
+
+    VarRef target;
+    if (AssignExpr *assign = dynamic_cast<AssignExpr *>(node))
+    {
+        target = assign->getVarRef();
+    }
+    else if (ArrayAssignExpr *assign = dynamic_cast<ArrayAssignExpr *>(node))
+    {
+        target = assign->getVarRef();
+    }
+    if (target.isValid() && (SymbolTable::isGlobal(target) || SymbolTable::isReference(target)))
+    {
+        return true;
+    }
+
+    bool found = false;
+    node->forEachChild([&](AstNode *&child)
+    {
+        found = found || hasSideEffects(child);
+    });
+    return found;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "Ast.hpp"
+#include "FlatAst.hpp"
+
+// Sustituye llamadas a funciones pequeñas y no recursivas por su cuerpo
+class Inliner
+{
+public:
+    explicit Inliner(int budget) : budget(budget) {}
+
+    void run(ProgramNode *program);
+
+private:
+    int budget;
+    int inlinedCount = 0; // numera los prefijos de las variables de cada expansión
+    std::unordered_map<std::string, FunctionDeclExpr *> functions;
+    std::unordered_map<std::string, std::unordered_set<std::string>> callGraph;
+    std::unordered_map<std::string, int> sizes;
+    std::unordered_set<std::string> pureFunctions; // terminan en return y no tienen efectos
+
+    void buildCallGraph(ProgramNode *program);
+    bool isRecursive(const std::string &name) const;
+    std::vector<std::string> bottomUpOrder(ProgramNode *program) const;
+
+    // frequency: ejecuciones de las sentencias según --profile-use, -1 si no se conocen
+    void inlineStatements(FunctionDeclExpr *caller, std::vector<AstNode *> &statements, int loopDepth,
+                          long long frequency);
+    ExprList *hoistCalls(FunctionDeclExpr *caller, const std::vector<AstNode **> &slots, int loopDepth,
+                         long long frequency);
+    bool shouldInline(FunctionDeclExpr *caller, FunctionCallExpr *call, int loopDepth, long long frequency) const;
+    ExprList *expandCall(FunctionDeclExpr *caller, FunctionCallExpr *call, std::string &result);
+    void removeDeadFunctions(ProgramNode *program);
+
+    static int nodeCount(AstNode *node);
+    static void collectCalls(AstNode *node, std::unordered_set<std::string> &callees);
+    static void collectCallSlots(AstNode *&node, std::vector<AstNode **> &slots);
+    static bool containsReturn(AstNode *node);
+    static bool hasSideEffects(AstNode *node);
+};
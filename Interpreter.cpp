@@ -0,0 +1,786 @@
+#include "Interpreter.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <functional>
+#include <stdexcept>
+
+// Límite de llamadas anidadas: cada llamada consume pila nativa del intérprete
+static const int MAX_CALL_DEPTH = 20000;
+
+// La salida pendiente se escribe antes de informar del error
+static void fail(const std::string &message)
+{
+    std::fflush(stdout);
+    throw std::runtime_error(message);
+}
+
+struct Interpreter::State
+{
+    int32_t *mem;
+    int64_t capacity;
+    int32_t *fp;
+    int64_t top;
+    int32_t returnValue;
+    int depth;
+    // Iteraciones de ciclo y llamadas que aún se pueden ejecutar
+    int64_t steps;
+
+    int32_t &at(int64_t address)
+    {
+        if (address < 0 || address >= capacity)
+        {
+            fail("Invalid memory access");
+        }
+        return mem[address];
+    }
+};
+
+struct Interpreter::Expr
+{
+    virtual ~Expr() = default;
+    virtual int32_t eval(State &s) = 0;
+};
+
+// exec devuelve true si se ejecutó un return
+struct Interpreter::Stmt
+{
+    virtual ~Stmt() = default;
+    virtual bool exec(State &s) = 0;
+};
+
+struct Interpreter::Function
+{
+    std::string name;
+    int params = 0;
+    int frameSize = 0;
+    std::unique_ptr<Stmt> body;
+};
+
+using ExprPtr = std::unique_ptr<Interpreter::Expr>;
+using StmtPtr = std::unique_ptr<Interpreter::Stmt>;
+using State = Interpreter::State;
+
+namespace
+{
+
+inline int32_t wrap(int64_t value)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(value));
+}
+
+struct Constant : Interpreter::Expr
+{
+    int32_t value;
+    explicit Constant(int32_t value) : value(value) {}
+    int32_t eval(State &) override { return value; }
+};
+
+struct LoadLocal : Interpreter::Expr
+{
+    int slot;
+    explicit LoadLocal(int slot) : slot(slot) {}
+    int32_t eval(State &s) override { return s.fp[slot]; }
+};
+
+struct LoadGlobal : Interpreter::Expr
+{
+    int index;
+    explicit LoadGlobal(int index) : index(index) {}
+    int32_t eval(State &s) override { return s.mem[index]; }
+};
+
+// Dirección absoluta de un local del marco actual
+struct FrameAddress : Interpreter::Expr
+{
+    int slot;
+    explicit FrameAddress(int slot) : slot(slot) {}
+    int32_t eval(State &s) override { return static_cast<int32_t>(s.fp - s.mem + slot); }
+};
+
+struct ElementAt : Interpreter::Expr
+{
+    ExprPtr base;
+    ExprPtr index;
+    uint32_t checkSize;
+    ElementAt(ExprPtr base, ExprPtr index, uint32_t checkSize)
+        : base(std::move(base)), index(std::move(index)), checkSize(checkSize) {}
+
+    int32_t eval(State &s) override
+    {
+        int32_t i = index->eval(s);
+        if (checkSize != 0 && static_cast<uint32_t>(i) >= checkSize)
+        {
+            fail("Error: array index out of bounds");
+        }
+        return wrap(static_cast<int64_t>(base->eval(s)) + i);
+    }
+};
+
+struct LoadAt : Interpreter::Expr
+{
+    ExprPtr address;
+    explicit LoadAt(ExprPtr address) : address(std::move(address)) {}
+    int32_t eval(State &s) override { return s.at(address->eval(s)); }
+};
+
+struct StoreLocal : Interpreter::Expr
+{
+    int slot;
+    ExprPtr value;
+    StoreLocal(int slot, ExprPtr value) : slot(slot), value(std::move(value)) {}
+    int32_t eval(State &s) override { return s.fp[slot] = value->eval(s); }
+};
+
+struct StoreGlobal : Interpreter::Expr
+{
+    int index;
+    ExprPtr value;
+    StoreGlobal(int index, ExprPtr value) : index(index), value(std::move(value)) {}
+    int32_t eval(State &s) override { return s.mem[index] = value->eval(s); }
+};
+
+// Como en el backend MIPS, el valor se evalúa antes que la dirección
+struct StoreAt : Interpreter::Expr
+{
+    ExprPtr address;
+    ExprPtr value;
+    StoreAt(ExprPtr address, ExprPtr value) : address(std::move(address)), value(std::move(value)) {}
+
+    int32_t eval(State &s) override
+    {
+        int32_t v = value->eval(s);
+        return s.at(address->eval(s)) = v;
+    }
+};
+
+struct ReadAt : Interpreter::Expr
+{
+    ExprPtr address;
+    explicit ReadAt(ExprPtr address) : address(std::move(address)) {}
+
+    int32_t eval(State &s) override
+    {
+        int32_t &target = s.at(address->eval(s));
+        int input = 0;
+        if (std::scanf("%d", &input) != 1)
+        {
+            input = 0;
+        }
+        return target = input;
+    }
+};
+
+template <typename Op>
+struct Binary : Interpreter::Expr
+{
+    ExprPtr left;
+    ExprPtr right;
+    Binary(ExprPtr left, ExprPtr right) : left(std::move(left)), right(std::move(right)) {}
+
+    int32_t eval(State &s) override
+    {
+        int32_t x = left->eval(s);
+        int32_t y = right->eval(s);
+        return Op::apply(x, y);
+    }
+};
+
+struct AddOp { static int32_t apply(int32_t x, int32_t y) { return wrap(static_cast<int64_t>(x) + y); } };
+struct SubOp { static int32_t apply(int32_t x, int32_t y) { return wrap(static_cast<int64_t>(x) - y); } };
+struct MulOp { static int32_t apply(int32_t x, int32_t y) { return wrap(static_cast<int64_t>(x) * y); } };
+struct LtOp { static int32_t apply(int32_t x, int32_t y) { return x < y; } };
+struct GtOp { static int32_t apply(int32_t x, int32_t y) { return x > y; } };
+struct LeOp { static int32_t apply(int32_t x, int32_t y) { return x <= y; } };
+struct GeOp { static int32_t apply(int32_t x, int32_t y) { return x >= y; } };
+struct EqOp { static int32_t apply(int32_t x, int32_t y) { return x == y; } };
+struct NeOp { static int32_t apply(int32_t x, int32_t y) { return x != y; } };
+struct AndOp { static int32_t apply(int32_t x, int32_t y) { return x & y; } };
+struct OrOp { static int32_t apply(int32_t x, int32_t y) { return x | y; } };
+
+struct DivOp
+{
+    static int32_t apply(int32_t x, int32_t y)
+    {
+        if (y == 0)
+        {
+            fail("Division by zero");
+        }
+        return (x == INT32_MIN && y == -1) ? x : x / y;
+    }
+};
+
+struct ModOp
+{
+    static int32_t apply(int32_t x, int32_t y)
+    {
+        if (y == 0)
+        {
+            fail("Division by zero");
+        }
+        return (y == -1) ? 0 : x % y;
+    }
+};
+
+// Los argumentos se escriben directamente en el marco nuevo; la cima de la
+// pila avanza con cada uno para que una llamada anidada no los pise
+struct Call : Interpreter::Expr
+{
+    const Interpreter::Function *callee;
+    std::vector<ExprPtr> args;
+    explicit Call(const Interpreter::Function *callee) : callee(callee) {}
+
+    int32_t eval(State &s) override
+    {
+        int64_t base = s.top;
+        if (base + callee->frameSize > s.capacity || s.depth >= MAX_CALL_DEPTH)
+        {
+            fail("Stack overflow");
+        }
+        if (--s.steps < 0)
+        {
+            fail("Evaluation budget exceeded");
+        }
+        for (size_t i = 0; i < args.size(); ++i)
+        {
+            s.top = base + static_cast<int64_t>(i);
+            int32_t value = args[i]->eval(s);
+            s.mem[base + static_cast<int64_t>(i)] = value;
+        }
+        std::fill(s.mem + base + callee->params, s.mem + base + callee->frameSize, 0);
+
+        int32_t *callerFp = s.fp;
+        s.fp = s.mem + base;
+        s.top = base + callee->frameSize;
+        ++s.depth;
+        int32_t result = callee->body->exec(s) ? s.returnValue : 0;
+        --s.depth;
+        s.fp = callerFp;
+        s.top = base;
+        return result;
+    }
+};
+
+struct ExprStmt : Interpreter::Stmt
+{
+    ExprPtr expr;
+    explicit ExprStmt(ExprPtr expr) : expr(std::move(expr)) {}
+
+    bool exec(State &s) override
+    {
+        expr->eval(s);
+        return false;
+    }
+};
+
+struct Block : Interpreter::Stmt
+{
+    std::vector<StmtPtr> statements;
+
+    bool exec(State &s) override
+    {
+        for (const StmtPtr &stmt : statements)
+        {
+            if (stmt->exec(s))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+struct If : Interpreter::Stmt
+{
+    ExprPtr condition;
+    StmtPtr ifBody;
+    StmtPtr elseBody;
+
+    bool exec(State &s) override
+    {
+        if (condition->eval(s))
+        {
+            return ifBody->exec(s);
+        }
+        return elseBody && elseBody->exec(s);
+    }
+};
+
+struct While : Interpreter::Stmt
+{
+    ExprPtr condition;
+    StmtPtr body;
+
+    bool exec(State &s) override
+    {
+        while (condition->eval(s))
+        {
+            if (--s.steps < 0)
+            {
+                fail("Evaluation budget exceeded");
+            }
+            if (body->exec(s))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+struct Return : Interpreter::Stmt
+{
+    ExprPtr value;
+    explicit Return(ExprPtr value) : value(std::move(value)) {}
+
+    bool exec(State &s) override
+    {
+        s.returnValue = value->eval(s);
+        return true;
+    }
+};
+
+struct Print : Interpreter::Stmt
+{
+    ExprPtr value;
+    explicit Print(ExprPtr value) : value(std::move(value)) {}
+
+    bool exec(State &s) override
+    {
+        std::printf("%d", value->eval(s));
+        return false;
+    }
+};
+
+struct PrintText : Interpreter::Stmt
+{
+    std::string text;
+    explicit PrintText(std::string text) : text(std::move(text)) {}
+
+    bool exec(State &) override
+    {
+        std::fputs(text.c_str(), stdout);
+        return false;
+    }
+};
+
+}
+
+Interpreter::Interpreter(size_t memoryWords, bool checkAllAccesses)
+    : memoryWords(std::min<size_t>(memoryWords, INT32_MAX)), checkAllAccesses(checkAllAccesses)
+{
+}
+
+Interpreter::~Interpreter() = default;
+
+void Interpreter::load(ProgramNode *program)
+{
+    functions.clear();
+    functionIndex.clear();
+    globals.clear();
+    globalsSize = 0;
+
+    std::function<void(AstNode *)> declareGlobals = [&](AstNode *node)
+    {
+        if (VarDeclExpr *decl = dynamic_cast<VarDeclExpr *>(node))
+        {
+            globals[decl->getVarName()] = globalsSize;
+            globalsSize += std::max(decl->getArraySize(), 1);
+            return;
+        }
+        node->forEachChild([&](AstNode *&child)
+        {
+            declareGlobals(child);
+        });
+    };
+    for (AstNode *global : program->getGlobals())
+    {
+        declareGlobals(global);
+    }
+    if (static_cast<size_t>(globalsSize) >= memoryWords)
+    {
+        throw std::runtime_error("Globals do not fit in memory");
+    }
+
+    // Las funciones se registran antes para resolver llamadas hacia adelante
+    for (AstNode *node : program->getFunctions())
+    {
+        FunctionDeclExpr *func = static_cast<FunctionDeclExpr *>(node);
+        std::unique_ptr<Function> entry(new Function());
+        entry->name = func->getName();
+        entry->params = static_cast<int>(func->getParams().size());
+        functionIndex[entry->name] = entry.get();
+        functions.push_back(std::move(entry));
+    }
+
+    for (AstNode *node : program->getFunctions())
+    {
+        FunctionDeclExpr *func = static_cast<FunctionDeclExpr *>(node);
+        compileFunction(func, *functionIndex.at(func->getName()));
+    }
+    memory.assign(memoryWords, 0);
+}
+
+int Interpreter::run(ProgramNode *program)
+{
+    load(program);
+    int32_t result = 0;
+    std::string error;
+    int64_t steps = INT64_MAX;
+    if (!call("main", {}, steps, result, error))
+    {
+        throw std::runtime_error(error);
+    }
+    std::fflush(stdout);
+    return result;
+}
+
+bool Interpreter::evaluate(const std::string &function, const std::vector<int32_t> &args, int64_t &steps,
+                           int32_t &result)
+{
+    std::string error;
+    return call(function, args, steps, result, error);
+}
+
+bool Interpreter::call(const std::string &function, const std::vector<int32_t> &args, int64_t &steps,
+                       int32_t &result, std::string &error)
+{
+    auto it = functionIndex.find(function);
+    if (it == functionIndex.end())
+    {
+        error = function == "main" ? "Program has no main function" : "Call to undefined function " + function;
+        return false;
+    }
+    if (static_cast<int>(args.size()) != it->second->params)
+    {
+        error = "Wrong number of arguments in call to " + function;
+        return false;
+    }
+
+    State state;
+    state.mem = memory.data();
+    state.capacity = static_cast<int64_t>(memory.size());
+    state.fp = state.mem;
+    state.top = globalsSize;
+    state.returnValue = 0;
+    state.depth = 0;
+    state.steps = steps;
+
+    Call entry(it->second);
+    for (int32_t arg : args)
+    {
+        entry.args.push_back(ExprPtr(new Constant(arg)));
+    }
+    try
+    {
+        result = entry.eval(state);
+    }
+    catch (const std::runtime_error &e)
+    {
+        steps = std::max<int64_t>(state.steps, 0);
+        error = e.what();
+        return false;
+    }
+    steps = state.steps;
+    return true;
+}
+
+void Interpreter::compileFunction(FunctionDeclExpr *func, Function &target)
+{
+    functionName = func->getName();
+    allocateSlots(func);
+
+    std::unique_ptr<Block> body(new Block());
+    for (AstNode *stmt : func->getStatements())
+    {
+        if (StmtPtr compiled = compileStatement(stmt))
+        {
+            body->statements.push_back(std::move(compiled));
+        }
+    }
+    target.body = std::move(body);
+    target.frameSize = std::max(frameSize, 1);
+}
+
+// Parámetros primero (los coloca la llamada) y luego los locales; cada
+// arreglo local ocupa una posición por elemento
+void Interpreter::allocateSlots(FunctionDeclExpr *func)
+{
+    slots.clear();
+    frameSize = 0;
+    auto reserve = [&](const std::string &name, int count)
+    {
+        if (slots.emplace(name, frameSize).second)
+        {
+            frameSize += count;
+        }
+    };
+
+    for (ParamExpr *param : func->getParams())
+    {
+        reserve(param->getParamName(), 1);
+    }
+
+    std::function<void(AstNode *)> collect = [&](AstNode *node)
+    {
+        std::string name;
+        if (VarDeclExpr *decl = dynamic_cast<VarDeclExpr *>(node))
+        {
+            name = decl->getVarName();
+        }
+        else if (VariableExpr *var = dynamic_cast<VariableExpr *>(node))
+        {
+            name = var->getVarName();
+        }
+        else if (AssignExpr *assign = dynamic_cast<AssignExpr *>(node))
+        {
+            name = assign->getVarName();
+        }
+        else if (CinExpr *cin = dynamic_cast<CinExpr *>(node))
+        {
+            name = cin->getVarName();
+        }
+        else if (ArrayAccess *access = dynamic_cast<ArrayAccess *>(node))
+        {
+            name = access->getVarName();
+        }
+
+        if (!name.empty() && SymbolTable::isLocal(functionName, name))
+        {
+            int size = SymbolTable::getArraySize(functionName, name);
+            bool array = size > 0 && !SymbolTable::isReference(functionName, name);
+            reserve(name, array ? size : 1);
+        }
+        node->forEachChild([&](AstNode *&child)
+        {
+            if (child)
+            {
+                collect(child);
+            }
+        });
+    };
+    collect(func);
+}
+
+int Interpreter::slot(const std::string &varName) const
+{
+    auto it = slots.find(varName);
+    if (it == slots.end())
+    {
+        throw std::runtime_error("Unknown variable " + varName + " in function " + functionName);
+    }
+    return it->second;
+}
+
+StmtPtr Interpreter::compileStatement(AstNode *node)
+{
+    if (!node || dynamic_cast<VarDeclExpr *>(node))
+    {
+        return nullptr;
+    }
+
+    if (ExprList *list = dynamic_cast<ExprList *>(node))
+    {
+        std::unique_ptr<Block> block(new Block());
+        for (AstNode *expr : list->getExpressions())
+        {
+            if (StmtPtr stmt = compileStatement(expr))
+            {
+                block->statements.push_back(std::move(stmt));
+            }
+        }
+        return StmtPtr(std::move(block));
+    }
+    if (PrintStmt *print = dynamic_cast<PrintStmt *>(node))
+    {
+        return StmtPtr(new Print(compileExpr(print->getExpr())));
+    }
+    if (StringLiteralExpr *literal = dynamic_cast<StringLiteralExpr *>(node))
+    {
+        return StmtPtr(new PrintText(literal->getText()));
+    }
+    if (dynamic_cast<EndlExpr *>(node))
+    {
+        return StmtPtr(new PrintText("\n"));
+    }
+    if (IfStmt *ifStmt = dynamic_cast<IfStmt *>(node))
+    {
+        std::unique_ptr<If> result(new If());
+        result->condition = compileExpr(ifStmt->getCondition());
+        result->ifBody = compileStatement(ifStmt->getIfBody());
+        if (!result->ifBody)
+        {
+            result->ifBody.reset(new Block());
+        }
+        result->elseBody = compileStatement(ifStmt->getElseBody());
+        return StmtPtr(std::move(result));
+    }
+    if (WhileStmt *loop = dynamic_cast<WhileStmt *>(node))
+    {
+        std::unique_ptr<While> result(new While());
+        result->condition = compileExpr(loop->getCondition());
+        result->body = compileStatement(loop->getBody());
+        if (!result->body)
+        {
+            result->body.reset(new Block());
+        }
+        return StmtPtr(std::move(result));
+    }
+    if (ReturnStmt *ret = dynamic_cast<ReturnStmt *>(node))
+    {
+        return StmtPtr(new Return(compileExpr(ret->getExpr())));
+    }
+    return StmtPtr(new ExprStmt(compileExpr(node)));
+}
+
+ExprPtr Interpreter::compileExpr(AstNode *node)
+{
+    if (ValueExpr *value = dynamic_cast<ValueExpr *>(node))
+    {
+        return ExprPtr(new Constant(static_cast<int32_t>(value->getValue())));
+    }
+    if (VariableExpr *var = dynamic_cast<VariableExpr *>(node))
+    {
+        const std::string &name = var->getVarName();
+        if (SymbolTable::isGlobal(functionName, name))
+        {
+            return ExprPtr(new LoadGlobal(globals.at(name)));
+        }
+        if (SymbolTable::isReference(functionName, name))
+        {
+            return ExprPtr(new LoadAt(ExprPtr(new LoadLocal(slot(name)))));
+        }
+        return ExprPtr(new LoadLocal(slot(name)));
+    }
+    if (AssignExpr *assign = dynamic_cast<AssignExpr *>(node))
+    {
+        const std::string &name = assign->getVarName();
+        ExprPtr value = compileExpr(assign->getExpr());
+        if (SymbolTable::isGlobal(functionName, name))
+        {
+            return ExprPtr(new StoreGlobal(globals.at(name), std::move(value)));
+        }
+        if (SymbolTable::isReference(functionName, name))
+        {
+            return ExprPtr(new StoreAt(ExprPtr(new LoadLocal(slot(name))), std::move(value)));
+        }
+        return ExprPtr(new StoreLocal(slot(name), std::move(value)));
+    }
+    if (CinExpr *cin = dynamic_cast<CinExpr *>(node))
+    {
+        return ExprPtr(new ReadAt(compileAddress(cin->getVarName())));
+    }
+    if (ArrayElementExpr *element = dynamic_cast<ArrayElementExpr *>(node))
+    {
+        return ExprPtr(new LoadAt(compileElementAddress(element)));
+    }
+    if (ArrayAssignExpr *assign = dynamic_cast<ArrayAssignExpr *>(node))
+    {
+        ExprPtr value = compileExpr(assign->getExpr());
+        return ExprPtr(new StoreAt(compileElementAddress(assign), std::move(value)));
+    }
+    if (ArrayCinExpr *cin = dynamic_cast<ArrayCinExpr *>(node))
+    {
+        return ExprPtr(new ReadAt(compileElementAddress(cin)));
+    }
+    if (FunctionCallExpr *call = dynamic_cast<FunctionCallExpr *>(node))
+    {
+        return compileCall(call);
+    }
+    if (BinaryExpr *binary = dynamic_cast<BinaryExpr *>(node))
+    {
+        return compileBinary(binary);
+    }
+    throw std::runtime_error("Unsupported expression for the interpreter");
+}
+
+ExprPtr Interpreter::compileBinary(BinaryExpr *expr)
+{
+    ExprPtr left = compileExpr(expr->getLeft());
+    ExprPtr right = compileExpr(expr->getRight());
+    Expr *result = nullptr;
+    if (dynamic_cast<AddExpr *>(expr)) result = new Binary<AddOp>(std::move(left), std::move(right));
+    else if (dynamic_cast<SubExpr *>(expr)) result = new Binary<SubOp>(std::move(left), std::move(right));
+    else if (dynamic_cast<MulExpr *>(expr)) result = new Binary<MulOp>(std::move(left), std::move(right));
+    else if (dynamic_cast<DivExpr *>(expr)) result = new Binary<DivOp>(std::move(left), std::move(right));
+    else if (dynamic_cast<ModExpr *>(expr)) result = new Binary<ModOp>(std::move(left), std::move(right));
+    else if (dynamic_cast<LessExpr *>(expr)) result = new Binary<LtOp>(std::move(left), std::move(right));
+    else if (dynamic_cast<GreaterExpr *>(expr)) result = new Binary<GtOp>(std::move(left), std::move(right));
+    else if (dynamic_cast<LessEqualExpr *>(expr)) result = new Binary<LeOp>(std::move(left), std::move(right));
+    else if (dynamic_cast<GreaterEqualExpr *>(expr)) result = new Binary<GeOp>(std::move(left), std::move(right));
+    else if (dynamic_cast<EqualExpr *>(expr)) result = new Binary<EqOp>(std::move(left), std::move(right));
+    else if (dynamic_cast<NotEqualExpr *>(expr)) result = new Binary<NeOp>(std::move(left), std::move(right));
+    else if (dynamic_cast<AndExpr *>(expr)) result = new Binary<AndOp>(std::move(left), std::move(right));
+    else if (dynamic_cast<OrExpr *>(expr)) result = new Binary<OrOp>(std::move(left), std::move(right));
+    else throw std::runtime_error("Unsupported operator for the interpreter");
+    return ExprPtr(result);
+}
+
+ExprPtr Interpreter::compileCall(FunctionCallExpr *call)
+{
+    const std::string &callee = call->getFunctionName();
+    auto it = functionIndex.find(callee);
+    if (it == functionIndex.end())
+    {
+        throw std::runtime_error("Call to undefined function " + callee);
+    }
+
+    const std::vector<AstNode *> &args = call->getArguments();
+    if (static_cast<int>(args.size()) != it->second->params)
+    {
+        throw std::runtime_error("Wrong number of arguments in call to " + callee);
+    }
+
+    std::unique_ptr<Call> result(new Call(it->second));
+    for (size_t i = 0; i < args.size(); ++i)
+    {
+        // Los parámetros por referencia reciben la dirección de la variable
+        if (SymbolTable::isReferenceParam(callee, i))
+        {
+            VariableExpr *var = dynamic_cast<VariableExpr *>(args[i]);
+            if (!var)
+            {
+                throw std::runtime_error("Argument " + std::to_string(i + 1) + " of call to " + callee +
+                                         " must be a variable");
+            }
+            result->args.push_back(compileAddress(var->getVarName()));
+        }
+        else
+        {
+            result->args.push_back(compileExpr(args[i]));
+        }
+    }
+    return ExprPtr(std::move(result));
+}
+
+ExprPtr Interpreter::compileAddress(const std::string &varName)
+{
+    if (SymbolTable::isGlobal(functionName, varName))
+    {
+        return ExprPtr(new Constant(globals.at(varName)));
+    }
+    if (SymbolTable::isReference(functionName, varName))
+    {
+        return ExprPtr(new LoadLocal(slot(varName)));
+    }
+    return ExprPtr(new FrameAddress(slot(varName)));
+}
+
+ExprPtr Interpreter::compileElementAddress(ArrayAccess *access)
+{
+    const std::string &varName = access->getVarName();
+    int size = SymbolTable::getArraySize(functionName, varName);
+    bool check = codeGenOptions().boundsCheck && access->isBoundsChecked() && size > 0;
+    bool runtimeCheck = (check || checkAllAccesses) && size > 0;
+
+    if (ValueExpr *constant = dynamic_cast<ValueExpr *>(access->getIndex()))
+    {
+        int index = static_cast<int>(constant->getValue());
+        if (check && (index < 0 || index >= size))
+        {
+            throw std::runtime_error("Array index out of bounds: " + varName + "[" + std::to_string(index) + "]");
+        }
+    }
+    return ExprPtr(new ElementAt(compileAddress(varName), compileExpr(access->getIndex()),
+                                      runtimeCheck ? static_cast<uint32_t>(size) : 0));
+}
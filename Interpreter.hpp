@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Ast.hpp"
+
+// Ejecuta el programa sin generar código. El AST se traduce una sola vez a un
+// árbol de evaluación con cada variable ya resuelta a su posición en el marco
+// o en los globales; la memoria sigue el esquema de la VM de bytecode.
+class Interpreter
+{
+public:
+    // memoryWords limita globales más pila de marcos. Con checkAllAccesses
+    // todo acceso a un arreglo de tamaño conocido se comprueba
+    explicit Interpreter(size_t memoryWords = 1 << 22, bool checkAllAccesses = false);
+    ~Interpreter();
+
+    // Traduce el programa al árbol de evaluación sin ejecutarlo
+    void load(ProgramNode *program);
+
+    // Carga el programa, ejecuta main y devuelve su valor de retorno
+    int run(ProgramNode *program);
+
+    // Evalúa una llamada del programa cargado. steps limita las iteraciones
+    // de ciclo y llamadas y se descuenta con lo consumido; devuelve false si
+    // la evaluación falla o agota el límite
+    bool evaluate(const std::string &function, const std::vector<int32_t> &args, int64_t &steps,
+                  int32_t &result);
+
+    struct State;
+    struct Expr;
+    struct Stmt;
+    struct Function;
+
+private:
+    size_t memoryWords;
+    bool checkAllAccesses;
+    std::vector<int32_t> memory;
+    std::vector<std::unique_ptr<Function>> functions;
+    std::unordered_map<std::string, Function *> functionIndex;
+    std::unordered_map<std::string, int> globals;
+    std::unordered_map<std::string, int> slots;
+    std::string functionName;
+    int globalsSize = 0;
+    int frameSize = 0;
+
+    bool call(const std::string &function, const std::vector<int32_t> &args, int64_t &steps, int32_t &result,
+              std::string &error);
+    void compileFunction(FunctionDeclExpr *func, Function &target);
+    void allocateSlots(FunctionDeclExpr *func);
+    int slot(const std::string &varName) const;
+
+    std::unique_ptr<Stmt> compileStatement(AstNode *node);
+    std::unique_ptr<Expr> compileExpr(AstNode *node);
+    std::unique_ptr<Expr> compileBinary(BinaryExpr *expr);
+    std::unique_ptr<Expr> compileCall(FunctionCallExpr *call);
+    std::unique_ptr<Expr> compileAddress(const std::string &varName);
+    std::unique_ptr<Expr> compileElementAddress(ArrayAccess *access);
+};
@@ -0,0 +1,105 @@
+#include "Jit.hpp"
+#include "X86Backend.hpp"
+#include "X86Encoder.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <stdexcept>
+
+#if defined(__x86_64__) && defined(__unix__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define MINICPP_JIT_SUPPORTED 1
+#endif
+
+#ifdef MINICPP_JIT_SUPPORTED
+
+// Equivalentes en el proceso de las funciones de MiniCppRuntime.c
+static void jitPrintInt(int value)
+{
+    std::printf("%d", value);
+}
+
+static void jitPrintString(const char *text)
+{
+    std::fputs(text, stdout);
+}
+
+static void jitPrintEndl()
+{
+    std::putchar('\n');
+}
+
+static int jitReadInt()
+{
+    int value = 0;
+    if (std::scanf("%d", &value) != 1)
+    {
+        return 0;
+    }
+    return value;
+}
+
+static void jitBoundsFail()
+{
+    std::fflush(stdout);
+    std::fputs("Error: array index out of bounds\n", stderr);
+    std::exit(1);
+}
+
+int Jit::run(ProgramNode *program)
+{
+    X86Encoder encoder;
+    encoder.defineExternal(X86Backend::PRINT_INT, reinterpret_cast<const void *>(&jitPrintInt));
+    encoder.defineExternal(X86Backend::PRINT_STRING, reinterpret_cast<const void *>(&jitPrintString));
+    encoder.defineExternal(X86Backend::PRINT_ENDL, reinterpret_cast<const void *>(&jitPrintEndl));
+    encoder.defineExternal(X86Backend::READ_INT, reinterpret_cast<const void *>(&jitReadInt));
+    encoder.defineExternal(X86Backend::BOUNDS_FAIL, reinterpret_cast<const void *>(&jitBoundsFail));
+
+    X86Backend backend(encoder);
+    backend.generate(program);
+    size_t entry = encoder.getSymbolOffset(X86Backend::functionSymbol("main"));
+
+    // Código y datos en páginas separadas: el código queda de solo lectura y ejecución
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t codeSize = (encoder.getCodeSize() + page - 1) / page * page;
+    size_t dataSize = (encoder.getDataSize() + page - 1) / page * page;
+    size_t total = codeSize + dataSize;
+
+    void *memory = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+    {
+        throw std::runtime_error("Cannot allocate memory for JIT code");
+    }
+
+    uint8_t *codeBase = static_cast<uint8_t *>(memory);
+    try
+    {
+        encoder.link(codeBase, codeBase + codeSize);
+    }
+    catch (...)
+    {
+        munmap(memory, total);
+        throw;
+    }
+    if (mprotect(codeBase, codeSize, PROT_READ | PROT_EXEC) != 0)
+    {
+        munmap(memory, total);
+        throw std::runtime_error("Cannot make JIT code executable");
+    }
+
+    int (*mainFunction)() = reinterpret_cast<int (*)()>(codeBase + entry);
+    int result = mainFunction();
+    std::fflush(stdout);
+
+    munmap(memory, total);
+    return result;
+}
+
+#else
+
+int Jit::run(ProgramNode *program)
+{
+    throw std::runtime_error("--run requires an x86-64 Unix host");
+}
+
+#endif
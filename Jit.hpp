@@ -0,0 +1,11 @@
+#pragma once
+#include "Ast.hpp"
+
+// Modo --run: genera código x86-64 en un búfer ejecutable del proceso y
+// llama a main sin pasar por el ensamblador ni el enlazador
+class Jit
+{
+public:
+    // Devuelve el valor de retorno de main
+    int run(ProgramNode *program);
+};
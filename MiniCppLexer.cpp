@@ -0,0 +1,68 @@
+#include <stdexcept>
+#include "MiniCppLexer.hpp"
+
+// Los tokens pendientes viven en un anillo: el actual está en head y los
+// siguientes ya reconocidos detrás de él, así que mirar por delante no vuelve
+// a analizar la entrada ni copia texto.
+Token Lexer::nextToken()
+{
+    if (count > 0)
+    {
+        head = (head + 1) & (LOOKAHEAD - 1);
+        --count;
+    }
+    if (count == 0)
+    {
+        db.keep = nullptr;
+        lex();
+    }
+    db.keep = db.buf + (ring[head].offset - db.discarded);
+    return ring[head].kind;
+}
+
+Token Lexer::peekToken(size_t k)
+{
+    if (k == 0 || k >= LOOKAHEAD)
+    {
+        throw std::runtime_error("Lookahead out of range: " + std::to_string(k));
+    }
+    while (count <= k)
+    {
+        lex();
+    }
+    return ring[(head + k) & (LOOKAHEAD - 1)].kind;
+}
+
+std::string Lexer::tokenText() const
+{
+    if (count == 0)
+    {
+        return std::string();
+    }
+    const TokenInfo &token = ring[head];
+    const char *start = db.buf + (token.offset - db.discarded);
+    return std::string(start, start + token.length);
+}
+
+// Reconoce un token más al final del anillo. Después del fin de archivo se
+// repite Eof sin volver a leer
+void Lexer::lex()
+{
+    TokenInfo &token = ring[(head + count) & (LOOKAHEAD - 1)];
+    if (finished)
+    {
+        token.kind = Token::Eof;
+        db.tok = db.cur;
+    }
+    else
+    {
+        token.kind = scan();
+        finished = token.kind == Token::Eof;
+    }
+
+    token.offset = db.discarded + (db.tok - db.buf);
+    token.length = static_cast<uint32_t>(db.cur - db.tok);
+    token.line = line;
+    token.column = column;
+    ++count;
+}
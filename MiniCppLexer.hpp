@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <fstream>
 
@@ -11,6 +13,7 @@ enum Token {
     KW_IF,          // if
     KW_ELSE,        // else
     KW_WHILE,       // while
+    KW_RETURN,      // return
     KW_COUT,        // cout
     KW_CIN,         // cin
     LT_LT,          // <<
@@ -49,41 +52,67 @@ class Lexer
 {
 public:
     static const size_t SIZE = 512;
+    // Tokens que puede haber por delante del actual (potencia de 2)
+    static const size_t LOOKAHEAD = 4;
 
     Lexer(std::ifstream &in) : db(in) {}
 
+    // Avanza al siguiente token y lo devuelve
     Token nextToken();
-    Token peekNextToken();
-    std::string tokenText() const { return text; }
+    // Token k posiciones después del actual (1 <= k < LOOKAHEAD), sin consumirlo
+    Token peekToken(size_t k);
+    Token peekNextToken() { return peekToken(1); }
+
+    // Texto, línea y columna del token actual
+    std::string tokenText() const;
+    int getLine() const { return count ? ring[head].line : line; }
+    int getColumn() const { return count ? ring[head].column : column; }
 
-    int getLine() const {return line;}
-    int getColumn() const {return column;}
-    
 private:
     int line = 1;
     int column = 1;
+
+    // Token ya reconocido: su texto se ubica por posición en el flujo, que
+    // sigue siendo válida después de que fill mueva el buffer
+    struct TokenInfo
+    {
+        Token kind;
+        size_t offset;
+        uint32_t length;
+        int line;
+        int column;
+    };
+
     struct DataBuffer
     {
+        size_t capacity;
         char *buf;
         char *lim;
         char *cur;
         char *tok;
         char* marker;
+        // Inicio del token más antiguo que se conserva al rellenar
+        char *keep = nullptr;
+        // Bytes descartados del inicio del buffer; buf[i] está en la posición discarded + i
+        size_t discarded = 0;
         bool eof;
         std::ifstream &in;
 
         DataBuffer(std::ifstream &in);
 
-        std::string tokenText() const { return std::string(tok, cur); }
-
         ~DataBuffer() { delete[] buf; }
 
         bool fill(size_t need);
     };
 
-private:
     DataBuffer db;
-    std::string text;
-      Token lastToken;  // Para guardar el último token
-    bool peeked = false;  // Indica si hemos "espiado" el siguiente token
-};
\ No newline at end of file
+    TokenInfo ring[LOOKAHEAD];
+    size_t head = 0;
+    size_t count = 0;
+    bool finished = false;
+
+    void lex();
+    Token scan();
+    bool skipTrivia();
+    void advance(const char *from, const char *to, int newlines, const char *lastNewline);
+};
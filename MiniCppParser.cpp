@@ -43,6 +43,8 @@ std::string Parser::tokenToString(Token token)
         return "else";
     case Token::KW_WHILE:
         return "while";
+    case Token::KW_RETURN:
+        return "return";
     case Token::KW_COUT:
         return "std::cout";
     case Token::KW_CIN:
@@ -110,40 +112,63 @@ std::string Parser::tokenToString(Token token)
     }
 }
 
-AstNode *Parser::parse()
+ProgramNode *Parser::parse()
 {
     return parsePrg();
 }
 
-AstNode *Parser::parsePrg()
+ProgramNode *Parser::parsePrg()
 {
 
     ProgramNode *programNode = new ProgramNode();
 
     while (currentToken != Token::Eof)
     {
-        programNode->addFunction(parseFunc());
+        AstNode *type = parseType();
+        std::string name = lexer.tokenText();
+        match(Token::IDENT);
+
+        
+        if (currentToken == Token::OPEN_PAR)
+        {
+            AstNode *func = parseFunc(type, name);
+            if (functionHandler)
+            {
+                functionHandler(static_cast<FunctionDeclExpr *>(func));
+            }
+            else
+            {
+                programNode->addFunction(func);
+            }
+        }
+        else
+        {
+            delete type;
+            functionName = "";
+            programNode->addGlobal(parseVarDeclRest(name));
+        }
     }
 
     return programNode;
 }
 
-AstNode *Parser::parseFunc()
+AstNode *Parser::parseFunc(AstNode *returnType, const std::string &funcName)
 {
 
-    AstNode *returnType = parseType();
-
-    std::string funcName = lexer.tokenText();
-
     functionName = funcName;
 
-    match(Token::IDENT);
-
     match(Token::OPEN_PAR);
     AstNode *paramList = parseParamList();
     match(Token::CLOSE_PAR);
 
-    FunctionDeclExpr *funcDecl = new FunctionDeclExpr(funcName, returnType, paramList, includeReturn);
+    FunctionDeclExpr *funcDecl = new FunctionDeclExpr(funcName, returnType, paramList);
+
+    std::vector<bool> referenceParams;
+    for (ParamExpr *param : funcDecl->getParams())
+    {
+        referenceParams.push_back(param->getIsReference());
+    }
+    SymbolTable::declareFunction(funcName, referenceParams);
 
     match(Token::OPEN_CURLY);
 
@@ -159,17 +184,6 @@ AstNode *Parser::parseFunc()
 
     match(Token::CLOSE_CURLY);
 
-    Token next = lexer.peekNextToken();
-
-    if (next == Token::Error)
-    {
-        funcDecl->setIncludeReturn(false);
-    }
-    else
-    {
-        funcDecl->setIncludeReturn(true);
-    }
-
     return funcDecl;
 }
 
@@ -227,58 +241,54 @@ AstNode *Parser::parseParam()
     std::string paramName = lexer.tokenText();
     match(Token::IDENT);
 
-    return new ParamExpr(functionName, paramName, isReference);
+    
+    int arraySize = 0;
+    if (currentToken == Token::OPEN_BRACKET)
+    {
+        match(Token::OPEN_BRACKET);
+        arraySize = parseArraySize();
+        match(Token::CLOSE_BRACKET);
+    }
+
+    return new ParamExpr(functionName, paramName, isReference, arraySize);
 }
 
 AstNode *Parser::parseVarDecl()
 {
     parseType(); 
 
-    
-    ExprList *varDeclList = new ExprList();
-
     std::string varName = lexer.tokenText();
     match(Token::IDENT); 
 
+    return parseVarDeclRest(varName);
+}
+
+AstNode *Parser::parseVarDeclRest(const std::string &firstName)
+{
     
-    if (currentToken == Token::OPEN_BRACKET)
-    {
-        match(Token::OPEN_BRACKET);
-        std::string arraySize = lexer.tokenText(); 
-        match(Token::NUMBER);
-        match(Token::CLOSE_BRACKET);
+    ExprList *varDeclList = new ExprList();
+    std::string varName = firstName;
 
-        
-        // varDeclList->addExpression(new VarDeclExpr(functionName, varName, arraySize));
-    }
-    else
+    while (true)
     {
         
-        varDeclList->addExpression(new VarDeclExpr(functionName, varName));
-    }
-
-    
-    while (currentToken == Token::COMMA)
-    {
-        match(Token::COMMA);
-        varName = lexer.tokenText(); 
-        match(Token::IDENT);
-
+        int arraySize = 0;
         if (currentToken == Token::OPEN_BRACKET)
         {
             match(Token::OPEN_BRACKET);
-            std::string arraySize = lexer.tokenText();
-            match(Token::NUMBER);
+            arraySize = parseArraySize();
             match(Token::CLOSE_BRACKET);
-
-            
-            // varDeclList->addExpression(new VarDeclExpr(functionName, varName, arraySize));
         }
-        else
+        varDeclList->addExpression(new VarDeclExpr(functionName, varName, arraySize));
+
+        
+        if (currentToken != Token::COMMA)
         {
-            
-            varDeclList->addExpression(new VarDeclExpr(functionName, varName));
+            break;
         }
+        match(Token::COMMA);
+        varName = lexer.tokenText(); 
+        match(Token::IDENT);
     }
 
     match(Token::SEMICOLON); 
@@ -286,6 +296,21 @@ AstNode *Parser::parseVarDecl()
     return varDeclList; 
 }
 
+int Parser::parseArraySize()
+{
+    std::string text = lexer.tokenText();
+    match(Token::NUMBER);
+
+    int size = std::stoi(text);
+    if (size <= 0)
+    {
+        throw std::runtime_error("Error en línea " + std::to_string(lexer.getLine()) +
+                                 " columna " + std::to_string(lexer.getColumn()) +
+                                 ". El tamaño de un arreglo debe ser positivo.");
+    }
+    return size;
+}
+
 AstNode *Parser::parseStmt()
 {
     if (currentToken == Token::IDENT)
@@ -306,8 +331,7 @@ AstNode *Parser::parseStmt()
                 match(Token::OP_ASSIGN);
                 AstNode *expr = parseExpr();
                 match(Token::SEMICOLON);
-                return nullptr;
-                // return new ArrayAssignExpr(functionName, varName, indexExpr, expr);
+                return new ArrayAssignExpr(functionName, varName, indexExpr, expr);
             }
             else
             {
@@ -329,8 +353,6 @@ AstNode *Parser::parseStmt()
         else if (currentToken == Token::OPEN_PAR)
         {
             match(Token::OPEN_PAR);
-            prevFunctionName = functionName;
-            functionName = varName;
             std::vector<AstNode *> args;
 
             if (currentToken != Token::CLOSE_PAR)
@@ -345,7 +367,6 @@ AstNode *Parser::parseStmt()
 
             match(Token::CLOSE_PAR);
             match(Token::SEMICOLON);
-            functionName = prevFunctionName;
 
             return new FunctionCallExpr(varName, args);
         }
@@ -383,11 +404,14 @@ AstNode *Parser::parseStmt()
         match(Token::CLOSE_PAR);
         match(Token::OPEN_CURLY);
 
+        // Cada bloque abre su propio ámbito en la tabla de símbolos
         ExprList *ifBodyList = new ExprList();
+        SymbolTable::enterScope(functionName);
         while (currentToken != Token::CLOSE_CURLY)
         {
             ifBodyList->addExpression(parseStmt());
         }
+        SymbolTable::exitScope(functionName);
         match(Token::CLOSE_CURLY);
 
         ExprList *elseBodyList = nullptr;
@@ -396,10 +420,12 @@ AstNode *Parser::parseStmt()
             match(Token::KW_ELSE);
             match(Token::OPEN_CURLY);
             elseBodyList = new ExprList();
+            SymbolTable::enterScope(functionName);
             while (currentToken != Token::CLOSE_CURLY)
             {
                 elseBodyList->addExpression(parseStmt());
             }
+            SymbolTable::exitScope(functionName);
             match(Token::CLOSE_CURLY);
         }
 
@@ -415,15 +441,24 @@ AstNode *Parser::parseStmt()
         match(Token::OPEN_CURLY);
 
         ExprList *whileBodyList = new ExprList(); 
+        SymbolTable::enterScope(functionName);
         while (currentToken != Token::CLOSE_CURLY)
         {
             whileBodyList->addExpression(parseStmt());
         }
+        SymbolTable::exitScope(functionName);
         match(Token::CLOSE_CURLY);
 
         return new WhileStmt(condition, whileBodyList); 
     }
 
+    else if (currentToken == Token::KW_RETURN)
+    {
+        match(Token::KW_RETURN);
+        AstNode *expr = parseExpr();
+        match(Token::SEMICOLON);
+        return new ReturnStmt(expr);
+    }
     
     else if (currentToken == Token::KW_CIN)
     {
@@ -439,7 +474,7 @@ AstNode *Parser::parseStmt()
             match(Token::CLOSE_BRACKET);
 
             match(Token::SEMICOLON);
-            return new ArrayCinExpr(varName, indexExpr);
+            return new ArrayCinExpr(functionName, varName, indexExpr);
         }
         else
         {
@@ -474,172 +509,187 @@ AstNode *Parser::parserCoutArg()
     }
 }
 
-AstNode *Parser::parseExpr()
+// Precedencia de los operadores binarios de expr, de menor a mayor. Todos
+// asocian a la izquierda; 0 indica que el token no es un operador binario
+int Parser::binaryPrecedence(Token op)
 {
-
-    AstNode *left = parseBoolTerm();
-
-    while (currentToken == Token::BOOL_OR)
+    switch (op)
     {
-        match(Token::BOOL_OR);
-        AstNode *right = parseBoolTerm();
-
-        left = new OrExpr(left, right);
+    case Token::BOOL_OR:
+        return 1;
+    case Token::BOOL_AND:
+        return 2;
+    case Token::GT:
+    case Token::LT:
+    case Token::GTE:
+    case Token::LTE:
+    case Token::NE:
+    case Token::EQ:
+        return 3;
+    case Token::OP_ADD:
+    case Token::OP_SUB:
+        return 4;
+    case Token::OP_MULT:
+    case Token::OP_DIV:
+    case Token::OP_MOD:
+        return 5;
+    default:
+        return 0;
     }
-
-    return left;
 }
 
-AstNode *Parser::parseBoolTerm()
+AstNode *Parser::makeBinary(Token op, AstNode *left, AstNode *right)
 {
-
-    AstNode *left = parseRelExpr();
-
-    while (currentToken == Token::BOOL_AND)
+    switch (op)
     {
-        match(Token::BOOL_AND);
-        AstNode *right = parseRelExpr();
-
-        left = new AndExpr(left, right);
+    case Token::BOOL_OR:
+        return new OrExpr(left, right);
+    case Token::BOOL_AND:
+        return new AndExpr(left, right);
+    case Token::GT:
+        return new GreaterExpr(left, right);
+    case Token::LT:
+        return new LessExpr(left, right);
+    case Token::GTE:
+        return new GreaterEqualExpr(left, right);
+    case Token::LTE:
+        return new LessEqualExpr(left, right);
+    case Token::NE:
+        return new NotEqualExpr(left, right);
+    case Token::EQ:
+        return new EqualExpr(left, right);
+    case Token::OP_ADD:
+        return new AddExpr(left, right);
+    case Token::OP_SUB:
+        return new SubExpr(left, right);
+    case Token::OP_MULT:
+        return new MulExpr(left, right);
+    case Token::OP_DIV:
+        return new DivExpr(left, right);
+    default:
+        return new ModExpr(left, right);
     }
-
-    return left;
 }
 
-AstNode *Parser::parseRelExpr()
+// expr completa (bool_term, rel_expr, arith_expr, arith_term y arith_factor)
+// en un solo ciclo de precedencia de operadores. Los operandos y los
+// operadores pendientes viven en pilas explícitas, igual que los paréntesis,
+// los argumentos de una llamada y el índice de un arreglo, así que la
+// profundidad de anidamiento no consume pila nativa.
+AstNode *Parser::parseExpr()
 {
-    AstNode *left = parseArithExpr();
+    std::vector<AstNode *> operands;
+    std::vector<ExprFrame> frames;
 
-    while (currentToken == Token::GT || currentToken == Token::LT ||
-           currentToken == Token::GTE || currentToken == Token::LTE ||
-           currentToken == Token::NE || currentToken == Token::EQ)
+    // Construye los operadores pendientes de precedencia >= minPrecedence
+    auto reduce = [&](int minPrecedence)
     {
-        Token op = currentToken;
-        advance();
-        AstNode *right = parseArithExpr();
-
-        if (op == Token::GT)
-        {
-            left = new GreaterExpr(left, right);
-        }
-        else if (op == Token::LT)
-        {
-            left = new LessExpr(left, right);
-        }
-        else if (op == Token::GTE)
-        {
-            left = new GreaterEqualExpr(left, right);
-        }
-        else if (op == Token::LTE)
-        {
-            left = new LessEqualExpr(left, right);
-        }
-        else if (op == Token::NE)
-        {
-            left = new NotEqualExpr(left, right);
-        }
-        else if (op == Token::EQ)
+        while (!frames.empty() && frames.back().kind == ExprFrame::BINARY &&
+               binaryPrecedence(frames.back().op) >= minPrecedence)
         {
-            left = new EqualExpr(left, right);
+            AstNode *right = operands.back();
+            operands.pop_back();
+            operands.back() = makeBinary(frames.back().op, operands.back(), right);
+            frames.pop_back();
         }
-    }
-
-    return left;
-}
+    };
 
-AstNode *Parser::parseArithExpr()
-{
-    AstNode *left = parseArithTerm();
-    while (currentToken == Token::OP_ADD || currentToken == Token::OP_SUB)
+    while (true)
     {
-        Token op = currentToken;
-        advance();
-        AstNode *right = parseArithTerm();
-
-        if (op == Token::OP_ADD)
+        // Operando, precedido de cualquier cantidad de paréntesis o aperturas
+        while (true)
         {
-            left = new AddExpr(left, right);
-        }
-        else if (op == Token::OP_SUB)
-        {
-            left = new SubExpr(left, right);
-        }
-    }
-    return left;
-}
-
-AstNode *Parser::parseArithTerm()
-{
-    AstNode *left = parseArithFactor();
-    while (currentToken == Token::OP_MULT || currentToken == Token::OP_DIV || currentToken == Token::OP_MOD)
-    {
-        Token op = currentToken;
-        advance();
-        AstNode *right = parseArithFactor();
+            if (currentToken == Token::NUMBER)
+            {
+                double value = std::stod(lexer.tokenText());
+                match(Token::NUMBER);
+                operands.push_back(new ValueExpr(value));
+                break;
+            }
+            else if (currentToken == Token::IDENT)
+            {
+                std::string varName = lexer.tokenText();
+                match(Token::IDENT);
 
-        if (op == Token::OP_MULT)
-        {
-            left = new MulExpr(left, right);
-        }
-        else if (op == Token::OP_DIV)
-        {
-            left = new DivExpr(left, right);
-        }
-        else if (op == Token::OP_MOD)
-        {
-            left = new ModExpr(left, right);
+                if (currentToken == Token::OPEN_PAR)
+                {
+                    match(Token::OPEN_PAR);
+                    if (currentToken == Token::CLOSE_PAR)
+                    {
+                        match(Token::CLOSE_PAR);
+                        operands.push_back(new FunctionCallExpr(varName, std::vector<AstNode *>()));
+                        break;
+                    }
+                    frames.push_back({ExprFrame::CALL, Token::Eof, varName, operands.size()});
+                }
+                else if (currentToken == Token::OPEN_BRACKET)
+                {
+                    match(Token::OPEN_BRACKET);
+                    frames.push_back({ExprFrame::INDEX, Token::Eof, varName, operands.size()});
+                }
+                else
+                {
+                    operands.push_back(new VariableExpr(functionName, varName));
+                    break;
+                }
+            }
+            else if (currentToken == Token::OPEN_PAR)
+            {
+                match(Token::OPEN_PAR);
+                frames.push_back({ExprFrame::GROUP, Token::Eof, std::string(), operands.size()});
+            }
+            else
+            {
+                throw std::runtime_error("Error en línea " + std::to_string(lexer.getLine()) +
+                                         " columna " + std::to_string(lexer.getColumn()) +
+                                         ". Token inesperado en la expresión.");
+            }
         }
-    }
-    return left;
-}
 
-AstNode *Parser::parseArithFactor()
-{
-    if (currentToken == Token::NUMBER)
-    {
-        double value = std::stod(lexer.tokenText());
-        match(Token::NUMBER);
-        return new ValueExpr(value);
-    }
-    else if (currentToken == Token::IDENT)
-    {
-        std::string varName = lexer.tokenText();
-        match(Token::IDENT);
-
-        if (currentToken == Token::OPEN_PAR)
+        // Operador binario, o cierre de lo que esté abierto
+        while (true)
         {
-            match(Token::OPEN_PAR);
-            std::vector<AstNode *> exprList;
+            int precedence = binaryPrecedence(currentToken);
+            if (precedence > 0)
+            {
+                reduce(precedence);
+                frames.push_back({ExprFrame::BINARY, currentToken, std::string(), operands.size()});
+                advance();
+                break;
+            }
 
-            if (currentToken != Token::CLOSE_PAR)
+            reduce(0);
+            if (frames.empty())
             {
-                exprList.push_back(parseExpr());
-                while (currentToken == Token::COMMA)
-                {
-                    match(Token::COMMA);
-                    exprList.push_back(parseExpr());
-                }
+                return operands.back();
             }
 
-            match(Token::CLOSE_PAR);
-            return new FunctionCallExpr(varName, exprList);
-        }
-        else
-        {
-            return new VariableExpr(functionName, varName);
+            ExprFrame &frame = frames.back();
+            if (frame.kind == ExprFrame::GROUP)
+            {
+                match(Token::CLOSE_PAR);
+            }
+            else if (frame.kind == ExprFrame::INDEX)
+            {
+                match(Token::CLOSE_BRACKET);
+                operands.back() = new ArrayElementExpr(functionName, frame.name, operands.back());
+            }
+            else if (currentToken == Token::COMMA)
+            {
+                // Otro argumento de la llamada; el anterior queda en la pila
+                match(Token::COMMA);
+                break;
+            }
+            else
+            {
+                match(Token::CLOSE_PAR);
+                std::vector<AstNode *> args(operands.begin() + frame.firstOperand, operands.end());
+                operands.resize(frame.firstOperand);
+                operands.push_back(new FunctionCallExpr(frame.name, args));
+            }
+            frames.pop_back();
         }
     }
-    else if (currentToken == Token::OPEN_PAR)
-    {
-        match(Token::OPEN_PAR);
-        AstNode *expr = parseExpr();
-        match(Token::CLOSE_PAR);
-        return expr;
-    }
-    else
-    {
-        throw std::runtime_error("Error: Token inesperado en parseArithFactor.");
-    }
 }
 
 AstNode *Parser::parseExprList()
@@ -1,39 +1,59 @@
 #pragma once
 #include "MiniCppLexer.hpp"
 #include "Ast.hpp"
+#include <functional>
 #include <stdexcept>
 
 class Parser
 {
 public:
     Parser(Lexer &lexer);
-    AstNode *parse();
+    ProgramNode *parse();
+
+    // Con un manejador, cada función se le entrega (y pasa a ser suya) en
+    // cuanto se termina de leer, en lugar de agregarse al ProgramNode
+    void setFunctionHandler(std::function<void(FunctionDeclExpr *)> handler) { functionHandler = std::move(handler); }
 
 private:
     Lexer &lexer;
     Token currentToken;
+    std::function<void(FunctionDeclExpr *)> functionHandler;
     void advance();
     std::string tokenToString(Token token);
     void match(Token validToken);
 
     std::string functionName; // nombre de la función actual
-    std::string prevFunctionName;
-    bool includeReturn = false; // actica el jr $ra
-    AstNode *parsePrg();
-    AstNode *parseFunc();
+    ProgramNode *parsePrg();
+    AstNode *parseFunc(AstNode *returnType, const std::string &funcName);
     AstNode *parseParamList(); // param_list
     AstNode *parseParam();     // param
     AstNode *parseVarDecl();   // var_decl
+    AstNode *parseVarDeclRest(const std::string &firstName);
+    int parseArraySize();
     AstNode *parseType();      // type
     AstNode *parseStmt();      // stmt
 
     AstNode *parserCoutArg(); // cout_arg
     AstNode *parseExpr();     // expr
-    AstNode *parseBoolTerm(); // bool_term
-    AstNode *parseRelExpr();  // rel_expr
+    AstNode *parseExprList(); /// expr_list
+
+    // Lo que parseExpr tiene abierto: un operador binario esperando su operando
+    // derecho, un paréntesis, la lista de argumentos de una llamada o el índice
+    // de un arreglo. firstOperand es el tamaño de la pila de operandos al abrir.
+    struct ExprFrame
+    {
+        enum Kind
+        {
+            BINARY,
+            GROUP,
+            CALL,
+            INDEX
+        } kind;
+        Token op;
+        std::string name;
+        size_t firstOperand;
+    };
 
-    AstNode *parseArithExpr();   // arith_expr
-    AstNode *parseArithTerm();   // arith_term
-    AstNode *parseArithFactor(); // arith_factor
-    AstNode *parseExprList();    /// expr_list
+    static int binaryPrecedence(Token op);
+    static AstNode *makeBinary(Token op, AstNode *left, AstNode *right);
 };
@@ -0,0 +1,43 @@
+/* Runtime para los programas compilados con --target=x86-64 */
+#include <stdio.h>
+#include <stdlib.h>
+
+extern int mc_main(void);
+
+void minicpp_print_int(int value)
+{
+    printf("%d", value);
+}
+
+void minicpp_print_string(const char *text)
+{
+    fputs(text, stdout);
+}
+
+void minicpp_print_endl(void)
+{
+    putchar('\n');
+}
+
+int minicpp_read_int(void)
+{
+    int value = 0;
+    if (scanf("%d", &value) != 1)
+    {
+        return 0;
+    }
+    return value;
+}
+
+void minicpp_bounds_fail(void)
+{
+    fflush(stdout);
+    fputs("Error: array index out of bounds\n", stderr);
+    exit(1);
+}
+
+int main(void)
+{
+    mc_main();
+    return 0;
+}
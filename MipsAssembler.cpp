@@ -0,0 +1,954 @@
+#include "MipsAssembler.hpp"
+#include <cctype>
+#include <ostream>
+#include <stdexcept>
+
+enum : uint32_t
+{
+    OP_J = 2,
+    OP_JAL = 3,
+    OP_BEQ = 4,
+    OP_BNE = 5,
+    OP_ADDI = 8,
+    OP_ADDIU = 9,
+    OP_SLTI = 10,
+    OP_SLTIU = 11,
+    OP_ANDI = 12,
+    OP_ORI = 13,
+    OP_XORI = 14,
+    OP_LUI = 15,
+    OP_LW = 35,
+    OP_LBU = 36,
+    OP_SB = 40,
+    OP_SW = 43
+};
+
+enum : uint32_t
+{
+    FN_SLL = 0,
+    FN_SRA = 3,
+    FN_JR = 8,
+    FN_SYSCALL = 12,
+    FN_MFHI = 16,
+    FN_MFLO = 18,
+    FN_MULT = 24,
+    FN_DIV = 26,
+    FN_ADD = 32,
+    FN_ADDU = 33,
+    FN_SUB = 34,
+    FN_SUBU = 35,
+    FN_AND = 36,
+    FN_OR = 37,
+    FN_XOR = 38,
+    FN_SLT = 42,
+    FN_SLTU = 43
+};
+
+static const int REG_ZERO = 0;
+static const int REG_AT = 1;
+
+static uint32_t rType(int rs, int rt, int rd, int shamt, uint32_t funct)
+{
+    return (static_cast<uint32_t>(rs) << 21) | (static_cast<uint32_t>(rt) << 16) |
+           (static_cast<uint32_t>(rd) << 11) | (static_cast<uint32_t>(shamt) << 6) | funct;
+}
+
+static uint32_t iType(uint32_t opcode, int rs, int rt, int32_t imm)
+{
+    return (opcode << 26) | (static_cast<uint32_t>(rs) << 21) | (static_cast<uint32_t>(rt) << 16) |
+           (static_cast<uint32_t>(imm) & 0xFFFF);
+}
+
+static bool fitsSigned16(int64_t value)
+{
+    return value >= -32768 && value <= 32767;
+}
+
+static bool fitsUnsigned16(int64_t value)
+{
+    return value >= 0 && value <= 0xFFFF;
+}
+
+// Parte alta ajustada para que sumada a la baja con signo dé value
+static uint32_t high16(uint32_t value)
+{
+    return ((value + 0x8000) >> 16) & 0xFFFF;
+}
+
+static bool isJump(const std::string &mnemonic)
+{
+    return mnemonic == "j" || mnemonic == "jal" || mnemonic == "jr" || mnemonic == "b" || mnemonic == "beqz" ||
+           mnemonic == "bnez" || mnemonic == "beq" || mnemonic == "bne";
+}
+
+static std::string trim(const std::string &text)
+{
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos)
+    {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+static std::string stripComment(const std::string &line)
+{
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); ++i)
+    {
+        if (line[i] == '"' && (i == 0 || line[i - 1] != '\\'))
+        {
+            quoted = !quoted;
+        }
+        else if (line[i] == '#' && !quoted)
+        {
+            return line.substr(0, i);
+        }
+    }
+    return line;
+}
+
+static std::vector<std::string> splitOperands(const std::string &text)
+{
+    std::vector<std::string> operands;
+    std::string current;
+    bool quoted = false;
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+        char c = text[i];
+        if (c == '"' && (i == 0 || text[i - 1] != '\\'))
+        {
+            quoted = !quoted;
+        }
+        if (c == ',' && !quoted)
+        {
+            operands.push_back(trim(current));
+            current.clear();
+        }
+        else
+        {
+            current += c;
+        }
+    }
+    if (!trim(current).empty())
+    {
+        operands.push_back(trim(current));
+    }
+    return operands;
+}
+
+static bool isIdentifierChar(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.' || c == '$';
+}
+
+static bool parseInteger(const std::string &text, int64_t &value)
+{
+    if (text.empty())
+    {
+        return false;
+    }
+    try
+    {
+        size_t used = 0;
+        value = std::stoll(text, &used, 0);
+        return used == text.size();
+    }
+    catch (const std::exception &)
+    {
+        return false;
+    }
+}
+
+static int parseRegister(const std::string &text)
+{
+    static const std::unordered_map<std::string, int> names = {
+        {"zero", 0}, {"at", 1}, {"v0", 2}, {"v1", 3}, {"a0", 4}, {"a1", 5}, {"a2", 6}, {"a3", 7},
+        {"t0", 8}, {"t1", 9}, {"t2", 10}, {"t3", 11}, {"t4", 12}, {"t5", 13}, {"t6", 14}, {"t7", 15},
+        {"s0", 16}, {"s1", 17}, {"s2", 18}, {"s3", 19}, {"s4", 20}, {"s5", 21}, {"s6", 22}, {"s7", 23},
+        {"t8", 24}, {"t9", 25}, {"k0", 26}, {"k1", 27}, {"gp", 28}, {"sp", 29}, {"fp", 30}, {"ra", 31}};
+
+    if (text.size() < 2 || text[0] != '$')
+    {
+        return -1;
+    }
+    auto it = names.find(text.substr(1));
+    if (it != names.end())
+    {
+        return it->second;
+    }
+    int64_t number = 0;
+    if (parseInteger(text.substr(1), number) && number >= 0 && number < 32)
+    {
+        return static_cast<int>(number);
+    }
+    return -1;
+}
+
+// Operando de memoria "desplazamiento(registro)"
+static bool parseMemory(const std::string &text, int64_t &offset, int &base)
+{
+    size_t open = text.find('(');
+    if (open == std::string::npos || text.back() != ')')
+    {
+        return false;
+    }
+    std::string displacement = trim(text.substr(0, open));
+    offset = 0;
+    if (!displacement.empty() && !parseInteger(displacement, offset))
+    {
+        return false;
+    }
+    base = parseRegister(trim(text.substr(open + 1, text.size() - open - 2)));
+    return base >= 0;
+}
+
+// Operando "etiqueta" o "etiqueta+k"
+static void parseSymbol(const std::string &text, std::string &symbol, int32_t &addend)
+{
+    size_t sign = text.find_first_of("+-", 1);
+    symbol = trim(text.substr(0, sign));
+    addend = 0;
+    if (sign != std::string::npos)
+    {
+        int64_t value = 0;
+        if (!parseInteger(trim(text.substr(sign + 1)), value))
+        {
+            throw std::runtime_error("Invalid address " + text);
+        }
+        addend = static_cast<int32_t>(text[sign] == '-' ? -value : value);
+    }
+}
+
+static std::string parseString(const std::string &text)
+{
+    if (text.size() < 2 || text.front() != '"' || text.back() != '"')
+    {
+        throw std::runtime_error("Expected a string literal");
+    }
+    std::string result;
+    for (size_t i = 1; i + 1 < text.size(); ++i)
+    {
+        char c = text[i];
+        if (c == '\\' && i + 2 < text.size())
+        {
+            c = text[++i];
+            switch (c)
+            {
+            case 'n': c = '\n'; break;
+            case 't': c = '\t'; break;
+            case 'r': c = '\r'; break;
+            case '0': c = '\0'; break;
+            default: break;
+            }
+        }
+        result += c;
+    }
+    return result;
+}
+
+static void put16(std::vector<uint8_t> &out, uint32_t value)
+{
+    out.push_back(static_cast<uint8_t>(value));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+static void put32(std::vector<uint8_t> &out, uint32_t value)
+{
+    put16(out, value & 0xFFFF);
+    put16(out, value >> 16);
+}
+
+static void writeBytes(std::ostream &out, const std::vector<uint8_t> &bytes)
+{
+    out.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+void MipsAssembler::assemble(const std::string &source)
+{
+    text.clear();
+    data.clear();
+    symbols.clear();
+    symbolOrder.clear();
+    statements.clear();
+    relocations.clear();
+
+    collect(source);
+    for (const Statement &stmt : statements)
+    {
+        try
+        {
+            encode(stmt);
+        }
+        catch (const std::runtime_error &e)
+        {
+            throw std::runtime_error("MIPS assembler, line " + std::to_string(stmt.line) + ": " + e.what());
+        }
+    }
+}
+
+// Primera pasada: etiquetas, tamaño de cada instrucción y contenido de .data
+void MipsAssembler::collect(const std::string &source)
+{
+    Section section = Section::TEXT;
+    uint32_t textOffset = 0;
+    bool reorder = true;
+    bool delaySlot = false;
+    std::vector<std::string> pending;
+    size_t position = 0;
+    int lineNumber = 0;
+
+    while (position < source.size())
+    {
+        size_t end = source.find('\n', position);
+        if (end == std::string::npos)
+        {
+            end = source.size();
+        }
+        std::string line = trim(stripComment(source.substr(position, end - position)));
+        position = end + 1;
+        ++lineNumber;
+
+        try
+        {
+            // Etiquetas al inicio de la línea
+            size_t length = 0;
+            while (length < line.size() && isIdentifierChar(line[length]))
+            {
+                ++length;
+            }
+            while (length > 0 && length < line.size() && line[length] == ':')
+            {
+                pending.push_back(line.substr(0, length));
+                line = trim(line.substr(length + 1));
+                length = 0;
+                while (length < line.size() && isIdentifierChar(line[length]))
+                {
+                    ++length;
+                }
+            }
+            if (line.empty())
+            {
+                continue;
+            }
+
+            size_t split = line.find_first_of(" \t");
+            Statement stmt;
+            stmt.mnemonic = line.substr(0, split);
+            stmt.operands = split == std::string::npos ? std::vector<std::string>() : splitOperands(line.substr(split + 1));
+            stmt.line = lineNumber;
+            stmt.reorder = reorder;
+
+            if (stmt.mnemonic == ".text" || stmt.mnemonic == ".data")
+            {
+                section = stmt.mnemonic == ".text" ? Section::TEXT : Section::DATA;
+                continue;
+            }
+            if (stmt.mnemonic == ".globl")
+            {
+                continue;
+            }
+            if (stmt.mnemonic == ".set")
+            {
+                if (stmt.operands.size() != 1 || (stmt.operands[0] != "reorder" && stmt.operands[0] != "noreorder"))
+                {
+                    throw std::runtime_error("Unsupported .set option");
+                }
+                reorder = stmt.operands[0] == "reorder";
+                continue;
+            }
+
+            // La etiqueta toma la dirección ya alineada de lo que sigue
+            uint32_t offset = textOffset;
+            if (section == Section::DATA)
+            {
+                offset = dataDirective(stmt);
+            }
+            else if (stmt.mnemonic[0] == '.')
+            {
+                throw std::runtime_error("Unsupported directive in .text: " + stmt.mnemonic);
+            }
+            for (const std::string &name : pending)
+            {
+                if (!symbols.emplace(name, Symbol{section, offset}).second)
+                {
+                    throw std::runtime_error("Duplicate label " + name);
+                }
+                symbolOrder.push_back(name);
+            }
+            pending.clear();
+
+            if (section == Section::TEXT)
+            {
+                // En la ranura de retardo solo cabe una instrucción de una palabra
+                if (delaySlot && (isJump(stmt.mnemonic) || instructionSize(stmt) != 1))
+                {
+                    throw std::runtime_error("Invalid instruction in delay slot: " + stmt.mnemonic);
+                }
+                delaySlot = !reorder && isJump(stmt.mnemonic);
+                stmt.offset = textOffset;
+                textOffset += 4 * instructionSize(stmt);
+                statements.push_back(stmt);
+            }
+        }
+        catch (const std::runtime_error &e)
+        {
+            throw std::runtime_error("MIPS assembler, line " + std::to_string(lineNumber) + ": " + e.what());
+        }
+    }
+
+    for (const std::string &name : pending)
+    {
+        uint32_t offset = section == Section::TEXT ? textOffset : static_cast<uint32_t>(data.size());
+        if (!symbols.emplace(name, Symbol{section, offset}).second)
+        {
+            throw std::runtime_error("Duplicate label " + name);
+        }
+        symbolOrder.push_back(name);
+    }
+}
+
+// Devuelve el desplazamiento donde empieza lo reservado por la directiva
+uint32_t MipsAssembler::dataDirective(const Statement &stmt)
+{
+    const std::string &name = stmt.mnemonic;
+    // .space reserva enteros en este generador, así que se alinea a palabra
+    if (name == ".space" || name == ".word")
+    {
+        while (data.size() % 4 != 0)
+        {
+            data.push_back(0);
+        }
+    }
+    uint32_t start = static_cast<uint32_t>(data.size());
+
+    if (name == ".space")
+    {
+        int64_t bytes = 0;
+        if (stmt.operands.size() != 1 || !parseInteger(stmt.operands[0], bytes) || bytes < 0)
+        {
+            throw std::runtime_error("Invalid .space size");
+        }
+        data.resize(data.size() + static_cast<size_t>(bytes), 0);
+    }
+    else if (name == ".word")
+    {
+        for (const std::string &operand : stmt.operands)
+        {
+            int64_t value = 0;
+            if (!parseInteger(operand, value))
+            {
+                throw std::runtime_error("Invalid .word value " + operand);
+            }
+            put32(data, static_cast<uint32_t>(value));
+        }
+    }
+    else if (name == ".asciiz" || name == ".ascii")
+    {
+        if (stmt.operands.size() != 1)
+        {
+            throw std::runtime_error("Expected one string in " + name);
+        }
+        std::string value = parseString(stmt.operands[0]);
+        data.insert(data.end(), value.begin(), value.end());
+        if (name == ".asciiz")
+        {
+            data.push_back(0);
+        }
+    }
+    else if (name == ".align")
+    {
+        int64_t power = 0;
+        if (stmt.operands.size() != 1 || !parseInteger(stmt.operands[0], power) || power < 0 || power > 12)
+        {
+            throw std::runtime_error("Invalid .align");
+        }
+        while (data.size() % (size_t(1) << power) != 0)
+        {
+            data.push_back(0);
+        }
+        start = static_cast<uint32_t>(data.size());
+    }
+    else
+    {
+        throw std::runtime_error("Unsupported directive in .data: " + name);
+    }
+    return start;
+}
+
+// Palabras que ocupa cada instrucción o pseudoinstrucción. Debe coincidir
+// con lo que emite encode() para que las etiquetas queden bien ubicadas.
+int MipsAssembler::instructionSize(const Statement &stmt)
+{
+    const std::string &m = stmt.mnemonic;
+    const std::vector<std::string> &ops = stmt.operands;
+    int64_t value = 0;
+    int base = 0;
+
+    if (m == "li")
+    {
+        if (ops.size() != 2 || !parseInteger(ops[1], value))
+        {
+            throw std::runtime_error("Invalid li");
+        }
+        value = static_cast<int32_t>(value);
+        bool single = fitsSigned16(value) || fitsUnsigned16(value) || (value & 0xFFFF) == 0;
+        return single ? 1 : 2;
+    }
+    if (m == "la" || m == "lw" || m == "sw" || m == "lbu" || m == "sb")
+    {
+        if (ops.size() != 2)
+        {
+            throw std::runtime_error("Invalid " + m);
+        }
+        if (parseMemory(ops[1], value, base))
+        {
+            return fitsSigned16(value) ? 1 : 3;
+        }
+        return 2;
+    }
+    if (m == "addi" || m == "addiu" || m == "slti" || m == "sltiu" || m == "andi" || m == "ori" || m == "xori")
+    {
+        if (ops.size() != 3 || !parseInteger(ops[2], value))
+        {
+            throw std::runtime_error("Invalid " + m);
+        }
+        bool signedImm = m != "andi" && m != "ori" && m != "xori";
+        return (signedImm ? fitsSigned16(value) : fitsUnsigned16(value)) ? 1 : 3;
+    }
+    if (isJump(m))
+    {
+        return stmt.reorder ? 2 : 1;
+    }
+    return 1;
+}
+
+// Segunda pasada: todas las etiquetas ya tienen dirección
+void MipsAssembler::encode(const Statement &stmt)
+{
+    const std::string &m = stmt.mnemonic;
+    const std::vector<std::string> &ops = stmt.operands;
+    size_t before = text.size();
+
+    auto reg = [&](size_t index)
+    {
+        int number = index < ops.size() ? parseRegister(ops[index]) : -1;
+        if (number < 0)
+        {
+            throw std::runtime_error("Expected a register in " + m);
+        }
+        return number;
+    };
+    auto expect = [&](size_t count)
+    {
+        if (ops.size() != count)
+        {
+            throw std::runtime_error("Wrong number of operands for " + m);
+        }
+    };
+
+    static const std::unordered_map<std::string, uint32_t> threeRegister = {
+        {"add", FN_ADD}, {"addu", FN_ADDU}, {"sub", FN_SUB}, {"subu", FN_SUBU}, {"and", FN_AND},
+        {"or", FN_OR}, {"xor", FN_XOR}, {"slt", FN_SLT}, {"sltu", FN_SLTU}};
+    static const std::unordered_map<std::string, std::pair<uint32_t, uint32_t>> immediate = {
+        {"addi", {OP_ADDI, FN_ADD}}, {"addiu", {OP_ADDIU, FN_ADDU}}, {"slti", {OP_SLTI, FN_SLT}},
+        {"sltiu", {OP_SLTIU, FN_SLTU}}, {"andi", {OP_ANDI, FN_AND}}, {"ori", {OP_ORI, FN_OR}},
+        {"xori", {OP_XORI, FN_XOR}}};
+
+    auto three = threeRegister.find(m);
+    auto imm = immediate.find(m);
+    if (three != threeRegister.end())
+    {
+        expect(3);
+        emit(rType(reg(1), reg(2), reg(0), 0, three->second));
+    }
+    else if (imm != immediate.end())
+    {
+        expect(3);
+        emitImmediate(stmt, imm->second.first, imm->second.second, m != "andi" && m != "ori" && m != "xori");
+    }
+    else if (m == "mult" || m == "div")
+    {
+        expect(2);
+        emit(rType(reg(0), reg(1), 0, 0, m == "mult" ? FN_MULT : FN_DIV));
+    }
+    else if (m == "mflo" || m == "mfhi")
+    {
+        expect(1);
+        emit(rType(0, 0, reg(0), 0, m == "mflo" ? FN_MFLO : FN_MFHI));
+    }
+    else if (m == "sll" || m == "sra")
+    {
+        expect(3);
+        int64_t shift = 0;
+        if (!parseInteger(ops[2], shift) || shift < 0 || shift > 31)
+        {
+            throw std::runtime_error("Invalid shift amount");
+        }
+        emit(rType(0, reg(1), reg(0), static_cast<int>(shift), m == "sll" ? FN_SLL : FN_SRA));
+    }
+    else if (m == "move")
+    {
+        expect(2);
+        emit(rType(reg(1), REG_ZERO, reg(0), 0, FN_ADDU));
+    }
+    else if (m == "li")
+    {
+        int64_t value = 0;
+        parseInteger(ops[1], value);
+        emitLoadImmediate(reg(0), static_cast<int32_t>(value));
+    }
+    else if (m == "la")
+    {
+        expect(2);
+        emitAddress(reg(0), ops[1], OP_ADDIU);
+    }
+    else if (m == "lw" || m == "sw" || m == "lbu" || m == "sb")
+    {
+        static const std::unordered_map<std::string, uint32_t> memory = {
+            {"lw", OP_LW}, {"sw", OP_SW}, {"lbu", OP_LBU}, {"sb", OP_SB}};
+        expect(2);
+        emitAddress(reg(0), ops[1], memory.at(m));
+    }
+    else if (m == "beqz" || m == "bnez")
+    {
+        expect(2);
+        emitBranch(stmt, m == "beqz" ? OP_BEQ : OP_BNE, reg(0), REG_ZERO, ops[1]);
+    }
+    else if (m == "beq" || m == "bne")
+    {
+        expect(3);
+        emitBranch(stmt, m == "beq" ? OP_BEQ : OP_BNE, reg(0), reg(1), ops[2]);
+    }
+    else if (m == "b")
+    {
+        expect(1);
+        emitBranch(stmt, OP_BEQ, REG_ZERO, REG_ZERO, ops[0]);
+    }
+    else if (m == "j" || m == "jal")
+    {
+        expect(1);
+        emitJump(stmt, m == "j" ? OP_J : OP_JAL, ops[0]);
+    }
+    else if (m == "jr")
+    {
+        expect(1);
+        emitWithDelaySlot(stmt, rType(reg(0), 0, 0, 0, FN_JR));
+    }
+    else if (m == "syscall")
+    {
+        expect(0);
+        emit(FN_SYSCALL);
+    }
+    else if (m == "nop")
+    {
+        expect(0);
+        emit(0);
+    }
+    else
+    {
+        throw std::runtime_error("Unknown instruction " + m);
+    }
+
+    if (static_cast<int>(text.size() - before) != instructionSize(stmt))
+    {
+        throw std::logic_error("MIPS assembler: size mismatch for " + m);
+    }
+}
+
+void MipsAssembler::emitWithDelaySlot(const Statement &stmt, uint32_t word)
+{
+    emit(word);
+    if (stmt.reorder)
+    {
+        emit(0);
+    }
+}
+
+void MipsAssembler::emitBranch(const Statement &stmt, uint32_t opcode, int rs, int rt, const std::string &target)
+{
+    auto it = symbols.find(target);
+    if (it == symbols.end())
+    {
+        throw std::runtime_error("Undefined label " + target);
+    }
+    if (it->second.section != Section::TEXT)
+    {
+        throw std::runtime_error("Branch to data label " + target);
+    }
+    int64_t distance = (static_cast<int64_t>(it->second.offset) - (stmt.offset + 4)) / 4;
+    if (!fitsSigned16(distance))
+    {
+        throw std::runtime_error("Branch out of range to " + target);
+    }
+    emitWithDelaySlot(stmt, iType(opcode, rs, rt, static_cast<int32_t>(distance)));
+}
+
+void MipsAssembler::emitJump(const Statement &stmt, uint32_t opcode, const std::string &target)
+{
+    auto it = symbols.find(target);
+    if (it == symbols.end())
+    {
+        throw std::runtime_error("Undefined label " + target);
+    }
+    if (it->second.section != Section::TEXT)
+    {
+        throw std::runtime_error("Jump to data label " + target);
+    }
+    relocations.push_back({static_cast<uint32_t>(4 * text.size()), R_MIPS_26, target, 0});
+    emitWithDelaySlot(stmt, opcode << 26);
+}
+
+void MipsAssembler::emitLoadImmediate(int rt, int32_t value)
+{
+    if (fitsSigned16(value))
+    {
+        emit(iType(OP_ADDIU, REG_ZERO, rt, value));
+    }
+    else if (fitsUnsigned16(value))
+    {
+        emit(iType(OP_ORI, REG_ZERO, rt, value));
+    }
+    else
+    {
+        uint32_t bits = static_cast<uint32_t>(value);
+        emit(iType(OP_LUI, REG_ZERO, rt, static_cast<int32_t>(bits >> 16)));
+        if ((bits & 0xFFFF) != 0)
+        {
+            emit(iType(OP_ORI, rt, rt, static_cast<int32_t>(bits & 0xFFFF)));
+        }
+    }
+}
+
+// la/lw/sw con operando "k(reg)" o "etiqueta+k". Los desplazamientos que no
+// caben en 16 bits y las etiquetas se resuelven a través de $at.
+void MipsAssembler::emitAddress(int rt, const std::string &operand, uint32_t opcode)
+{
+    int64_t offset = 0;
+    int base = 0;
+    if (parseMemory(operand, offset, base))
+    {
+        if (fitsSigned16(offset))
+        {
+            emit(iType(opcode, base, rt, static_cast<int32_t>(offset)));
+            return;
+        }
+        uint32_t bits = static_cast<uint32_t>(offset);
+        emit(iType(OP_LUI, REG_ZERO, REG_AT, static_cast<int32_t>(high16(bits))));
+        emit(rType(REG_AT, base, REG_AT, 0, FN_ADDU));
+        emit(iType(opcode, REG_AT, rt, static_cast<int32_t>(bits & 0xFFFF)));
+        return;
+    }
+
+    std::string symbol;
+    int32_t addend = 0;
+    parseSymbol(operand, symbol, addend);
+    if (symbols.find(symbol) == symbols.end())
+    {
+        throw std::runtime_error("Undefined label " + symbol);
+    }
+    uint32_t bits = static_cast<uint32_t>(addend);
+    relocations.push_back({static_cast<uint32_t>(4 * text.size()), R_MIPS_HI16, symbol, addend});
+    emit(iType(OP_LUI, REG_ZERO, REG_AT, static_cast<int32_t>(high16(bits))));
+    relocations.push_back({static_cast<uint32_t>(4 * text.size()), R_MIPS_LO16, symbol, addend});
+    emit(iType(opcode, REG_AT, rt, static_cast<int32_t>(bits & 0xFFFF)));
+}
+
+void MipsAssembler::emitImmediate(const Statement &stmt, uint32_t opcode, uint32_t funct, bool signedImm)
+{
+    int rt = parseRegister(stmt.operands[0]);
+    int rs = parseRegister(stmt.operands[1]);
+    int64_t value = 0;
+    if (rt < 0 || rs < 0 || !parseInteger(stmt.operands[2], value))
+    {
+        throw std::runtime_error("Invalid operands for " + stmt.mnemonic);
+    }
+    if (signedImm ? fitsSigned16(value) : fitsUnsigned16(value))
+    {
+        emit(iType(opcode, rs, rt, static_cast<int32_t>(value)));
+        return;
+    }
+    uint32_t bits = static_cast<uint32_t>(value);
+    emit(iType(OP_LUI, REG_ZERO, REG_AT, static_cast<int32_t>(bits >> 16)));
+    emit(iType(OP_ORI, REG_AT, REG_AT, static_cast<int32_t>(bits & 0xFFFF)));
+    emit(rType(rs, REG_AT, rt, 0, funct));
+}
+
+uint32_t MipsAssembler::symbolAddress(const Relocation &reloc) const
+{
+    const Symbol &symbol = symbols.at(reloc.symbol);
+    uint32_t base = symbol.section == Section::TEXT ? TEXT_BASE : DATA_BASE;
+    return base + symbol.offset + static_cast<uint32_t>(reloc.addend);
+}
+
+void MipsAssembler::writeImage(std::ostream &textOut, std::ostream &dataOut) const
+{
+    std::vector<uint32_t> linked = text;
+    for (const Relocation &reloc : relocations)
+    {
+        uint32_t &word = linked[reloc.offset / 4];
+        uint32_t address = symbolAddress(reloc);
+        switch (reloc.type)
+        {
+        case R_MIPS_26:
+            if ((address & 0xF0000000) != ((TEXT_BASE + reloc.offset) & 0xF0000000))
+            {
+                throw std::runtime_error("Jump out of range to " + reloc.symbol);
+            }
+            word = (word & 0xFC000000) | ((address >> 2) & 0x03FFFFFF);
+            break;
+        case R_MIPS_HI16:
+            word = (word & 0xFFFF0000) | high16(address);
+            break;
+        case R_MIPS_LO16:
+            word = (word & 0xFFFF0000) | (address & 0xFFFF);
+            break;
+        }
+    }
+
+    std::vector<uint8_t> bytes;
+    for (uint32_t word : linked)
+    {
+        put32(bytes, word);
+    }
+    writeBytes(textOut, bytes);
+    writeBytes(dataOut, data);
+}
+
+// Objeto ELF32 little-endian para MIPS32 (o32). Las etiquetas son símbolos
+// locales salvo main; los sumandos de las reubicaciones van en la instrucción.
+void MipsAssembler::writeObject(std::ostream &out) const
+{
+    enum
+    {
+        SEC_NULL,
+        SEC_TEXT,
+        SEC_DATA,
+        SEC_REL_TEXT,
+        SEC_SYMTAB,
+        SEC_STRTAB,
+        SEC_SHSTRTAB,
+        SEC_COUNT
+    };
+
+    std::vector<uint8_t> textBytes;
+    for (uint32_t word : text)
+    {
+        put32(textBytes, word);
+    }
+
+    // Locales primero, como exige ELF
+    std::vector<std::string> ordered;
+    for (const std::string &name : symbolOrder)
+    {
+        if (name != "main")
+        {
+            ordered.push_back(name);
+        }
+    }
+    uint32_t firstGlobal = static_cast<uint32_t>(ordered.size() + 1);
+    if (symbols.count("main"))
+    {
+        ordered.push_back("main");
+    }
+
+    std::vector<uint8_t> strtab(1, 0);
+    std::vector<uint8_t> symtab(16, 0);
+    std::unordered_map<std::string, uint32_t> symbolIndex;
+    for (const std::string &name : ordered)
+    {
+        const Symbol &symbol = symbols.at(name);
+        symbolIndex[name] = static_cast<uint32_t>(symtab.size() / 16);
+        put32(symtab, static_cast<uint32_t>(strtab.size()));
+        put32(symtab, symbol.offset);
+        put32(symtab, 0);
+        bool global = name == "main";
+        symtab.push_back(static_cast<uint8_t>((global ? 1 : 0) << 4 | (global ? 2 : 0)));
+        symtab.push_back(0);
+        put16(symtab, symbol.section == Section::TEXT ? SEC_TEXT : SEC_DATA);
+        strtab.insert(strtab.end(), name.begin(), name.end());
+        strtab.push_back(0);
+    }
+
+    std::vector<uint8_t> relText;
+    for (const Relocation &reloc : relocations)
+    {
+        put32(relText, reloc.offset);
+        put32(relText, symbolIndex.at(reloc.symbol) << 8 | reloc.type);
+    }
+
+    const char *names[SEC_COUNT] = {"", ".text", ".data", ".rel.text", ".symtab", ".strtab", ".shstrtab"};
+    std::vector<uint8_t> shstrtab;
+    uint32_t nameOffsets[SEC_COUNT];
+    for (int i = 0; i < SEC_COUNT; ++i)
+    {
+        nameOffsets[i] = static_cast<uint32_t>(shstrtab.size());
+        shstrtab.insert(shstrtab.end(), names[i], names[i] + std::char_traits<char>::length(names[i]));
+        shstrtab.push_back(0);
+    }
+
+    const std::vector<uint8_t> *contents[SEC_COUNT] = {nullptr, &textBytes, &data, &relText, &symtab, &strtab, &shstrtab};
+    const uint32_t ELF_HEADER_SIZE = 52;
+    std::vector<uint8_t> file(ELF_HEADER_SIZE, 0);
+    uint32_t offsets[SEC_COUNT] = {0};
+    for (int i = 1; i < SEC_COUNT; ++i)
+    {
+        while (file.size() % 4 != 0)
+        {
+            file.push_back(0);
+        }
+        offsets[i] = static_cast<uint32_t>(file.size());
+        file.insert(file.end(), contents[i]->begin(), contents[i]->end());
+    }
+    while (file.size() % 4 != 0)
+    {
+        file.push_back(0);
+    }
+    uint32_t sectionHeaders = static_cast<uint32_t>(file.size());
+
+    // Cabecera de sección: name, type, flags, addr, offset, size, link, info, addralign, entsize
+    auto sectionHeader = [&](int index, uint32_t type, uint32_t flags, uint32_t link, uint32_t info,
+                             uint32_t align, uint32_t entsize)
+    {
+        put32(file, index == SEC_NULL ? 0 : nameOffsets[index]);
+        put32(file, type);
+        put32(file, flags);
+        put32(file, 0);
+        put32(file, offsets[index]);
+        put32(file, index == SEC_NULL ? 0 : static_cast<uint32_t>(contents[index]->size()));
+        put32(file, link);
+        put32(file, info);
+        put32(file, align);
+        put32(file, entsize);
+    };
+    const uint32_t SHT_PROGBITS = 1, SHT_SYMTAB = 2, SHT_STRTAB = 3, SHT_REL = 9;
+    const uint32_t SHF_WRITE = 1, SHF_ALLOC = 2, SHF_EXECINSTR = 4, SHF_INFO_LINK = 0x40;
+    sectionHeader(SEC_NULL, 0, 0, 0, 0, 0, 0);
+    sectionHeader(SEC_TEXT, SHT_PROGBITS, SHF_ALLOC | SHF_EXECINSTR, 0, 0, 4, 0);
+    sectionHeader(SEC_DATA, SHT_PROGBITS, SHF_ALLOC | SHF_WRITE, 0, 0, 4, 0);
+    sectionHeader(SEC_REL_TEXT, SHT_REL, SHF_INFO_LINK, SEC_SYMTAB, SEC_TEXT, 4, 8);
+    sectionHeader(SEC_SYMTAB, SHT_SYMTAB, 0, SEC_STRTAB, firstGlobal, 4, 16);
+    sectionHeader(SEC_STRTAB, SHT_STRTAB, 0, 0, 0, 1, 0);
+    sectionHeader(SEC_SHSTRTAB, SHT_STRTAB, 0, 0, 0, 1, 0);
+
+    // Cabecera ELF: ELFCLASS32, ELFDATA2LSB, ET_REL, EM_MIPS, EF_MIPS_ARCH_32 | EF_MIPS_ABI_O32
+    const uint8_t ident[16] = {0x7F, 'E', 'L', 'F', 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    std::vector<uint8_t> header(ident, ident + 16);
+    put16(header, 1);
+    put16(header, 8);
+    put32(header, 1);
+    put32(header, 0);
+    put32(header, 0);
+    put32(header, sectionHeaders);
+    put32(header, 0x50001000);
+    put16(header, ELF_HEADER_SIZE);
+    put16(header, 0);
+    put16(header, 0);
+    put16(header, 40);
+    put16(header, SEC_COUNT);
+    put16(header, SEC_SHSTRTAB);
+    std::copy(header.begin(), header.end(), file.begin());
+
+    writeBytes(out, file);
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Ensambla en memoria el código MIPS que produce el generador, sin volver a
+// escribirlo como texto. La primera pasada asigna direcciones a las etiquetas
+// y la segunda codifica las instrucciones (little-endian, MIPS32). Los saltos
+// llevan un nop en su ranura de retardo para que el código sea válido también
+// fuera de SPIM; después de `.set noreorder` la ranura es la instrucción que
+// sigue al salto, como la deja MipsScheduler.
+class MipsAssembler
+{
+public:
+    // Direcciones de los segmentos en SPIM/MARS para la imagen absoluta
+    static constexpr uint32_t TEXT_BASE = 0x00400000;
+    static constexpr uint32_t DATA_BASE = 0x10010000;
+
+    void assemble(const std::string &source);
+
+    // Objeto reubicable ELF32 con .text, .data, .rel.text y tabla de símbolos
+    void writeObject(std::ostream &out) const;
+
+    // Imagen binaria ya enlazada de cada segmento
+    void writeImage(std::ostream &text, std::ostream &data) const;
+
+    size_t getTextSize() const { return 4 * text.size(); }
+    size_t getDataSize() const { return data.size(); }
+
+private:
+    enum class Section
+    {
+        TEXT,
+        DATA
+    };
+
+    // Tipos de reubicación del ABI de MIPS
+    enum RelocType : uint8_t
+    {
+        R_MIPS_26 = 4,
+        R_MIPS_HI16 = 5,
+        R_MIPS_LO16 = 6
+    };
+
+    struct Symbol
+    {
+        Section section;
+        uint32_t offset;
+    };
+
+    struct Statement
+    {
+        uint32_t offset;
+        std::string mnemonic;
+        std::vector<std::string> operands;
+        int line;
+        bool reorder;
+    };
+
+    struct Relocation
+    {
+        uint32_t offset;
+        RelocType type;
+        std::string symbol;
+        int32_t addend;
+    };
+
+    std::vector<uint32_t> text;
+    std::vector<uint8_t> data;
+    std::unordered_map<std::string, Symbol> symbols;
+    std::vector<std::string> symbolOrder;
+    std::vector<Statement> statements;
+    std::vector<Relocation> relocations;
+
+    void collect(const std::string &source);
+    uint32_t dataDirective(const Statement &stmt);
+    void encode(const Statement &stmt);
+    static int instructionSize(const Statement &stmt);
+
+    void emit(uint32_t word) { text.push_back(word); }
+    void emitWithDelaySlot(const Statement &stmt, uint32_t word);
+    void emitBranch(const Statement &stmt, uint32_t opcode, int rs, int rt, const std::string &target);
+    void emitJump(const Statement &stmt, uint32_t opcode, const std::string &target);
+    void emitLoadImmediate(int rt, int32_t value);
+    void emitAddress(int rt, const std::string &operand, uint32_t opcode);
+    void emitMemory(const Statement &stmt, uint32_t opcode);
+    void emitImmediate(const Statement &stmt, uint32_t opcode, uint32_t funct, bool signedImm);
+
+    uint32_t symbolAddress(const Relocation &reloc) const;
+};
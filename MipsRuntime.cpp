@@ -0,0 +1,191 @@
+#include "MipsRuntime.hpp"
+
+// Las palabras van primero para que queden alineadas sin depender de .align
+std::string MipsRuntime::data()
+{
+    std::string code;
+    code += "__out_len: .word 0\n";
+    code += "__in_pos: .word 0\n";
+    code += "__out_fd: .word 1\n";
+    code += "__out_buf: .space " + std::to_string(OUTPUT_BUFFER_SIZE) + "\n";
+    code += "__in_buf: .space " + std::to_string(INPUT_BUFFER_SIZE + 4) + "\n";
+    code += "__digits: .space 12\n";
+    return code;
+}
+
+std::string MipsRuntime::code()
+{
+    const std::string outputSize = std::to_string(OUTPUT_BUFFER_SIZE);
+    std::string code;
+
+    // Con el búfer lleno se salta a __flush, que regresa al que llamó
+    code += std::string(PRINT_CHAR) + ":\n";
+    code += "lw $v1, __out_len\n";
+    code += "la $a1, __out_buf\n";
+    code += "add $a2, $a1, $v1\n";
+    code += "sb $a0, 0($a2)\n";
+    code += "addi $v1, $v1, 1\n";
+    code += "sw $v1, __out_len\n";
+    code += "slti $a2, $v1, " + outputSize + "\n";
+    code += "beqz $a2, " + std::string(FLUSH) + "\n";
+    code += "jr $ra\n";
+
+    // Los dígitos se generan de derecha a izquierda con el valor en negativo,
+    // para que INT_MIN no se desborde, y se imprimen como cadena
+    code += std::string(PRINT_INT) + ":\n";
+    code += "la $v1, __digits+11\n";
+    code += "move $a1, $a0\n";
+    code += "slt $a2, $a0, $zero\n";
+    code += "bnez $a2, __print_int_loop\n";
+    code += "sub $a1, $zero, $a0\n";
+    code += "__print_int_loop:\n";
+    code += "li $a3, 10\n";
+    code += "div $a1, $a3\n";
+    code += "mflo $a1\n";
+    code += "mfhi $a3\n";
+    code += "li $v0, 48\n";
+    code += "sub $a3, $v0, $a3\n";
+    code += "addi $v1, $v1, -1\n";
+    code += "sb $a3, 0($v1)\n";
+    code += "bnez $a1, __print_int_loop\n";
+    code += "beqz $a2, __print_int_done\n";
+    code += "li $a3, 45\n";
+    code += "addi $v1, $v1, -1\n";
+    code += "sb $a3, 0($v1)\n";
+    code += "__print_int_done:\n";
+    code += "move $a0, $v1\n";
+
+    // Copia la cadena al búfer y lo escribe cada vez que se llena
+    code += std::string(PRINT_STRING) + ":\n";
+    code += "lw $v1, __out_len\n";
+    code += "la $a1, __out_buf\n";
+    code += "__print_string_loop:\n";
+    code += "lbu $a2, 0($a0)\n";
+    code += "beqz $a2, __print_string_end\n";
+    code += "add $a3, $a1, $v1\n";
+    code += "sb $a2, 0($a3)\n";
+    code += "addi $v1, $v1, 1\n";
+    code += "addi $a0, $a0, 1\n";
+    code += "slti $a3, $v1, " + outputSize + "\n";
+    code += "bnez $a3, __print_string_loop\n";
+    code += "move $a3, $a0\n";
+    code += "lw $a0, __out_fd\n";
+    code += "move $a2, $v1\n";
+    code += "li $v0, 15\n";
+    code += "syscall\n";
+    code += "move $a0, $a3\n";
+    code += "li $v1, 0\n";
+    code += "j __print_string_loop\n";
+    code += "__print_string_end:\n";
+    code += "sw $v1, __out_len\n";
+    code += "jr $ra\n";
+
+    code += std::string(FLUSH) + ":\n";
+    code += "lw $a2, __out_len\n";
+    code += "beqz $a2, __flush_end\n";
+    code += "lw $a0, __out_fd\n";
+    code += "la $a1, __out_buf\n";
+    code += "li $v0, 15\n";
+    code += "syscall\n";
+    code += "sw $zero, __out_len\n";
+    code += "__flush_end:\n";
+    code += "jr $ra\n";
+
+    // Salta los blancos; si el búfer se acaba, escribe la salida pendiente
+    // (como cin con cout) y lee otra línea. Los dígitos se acumulan en
+    // negativo por la misma razón que en __print_int
+    code += std::string(READ_INT) + ":\n";
+    code += "lw $v1, __in_pos\n";
+    code += "la $a0, __in_buf\n";
+    code += "add $v1, $a0, $v1\n";
+    code += "__read_int_skip:\n";
+    code += "lbu $a2, 0($v1)\n";
+    code += "bnez $a2, __read_int_blank\n";
+    code += "lw $a2, __out_len\n";
+    code += "beqz $a2, __read_int_fill\n";
+    code += "lw $a0, __out_fd\n";
+    code += "la $a1, __out_buf\n";
+    code += "li $v0, 15\n";
+    code += "syscall\n";
+    code += "sw $zero, __out_len\n";
+    code += "__read_int_fill:\n";
+    code += "la $v1, __in_buf\n";
+    code += "sb $zero, 0($v1)\n";
+    code += "move $a0, $v1\n";
+    code += "li $a1, " + std::to_string(INPUT_BUFFER_SIZE) + "\n";
+    code += "li $v0, 8\n";
+    code += "syscall\n";
+    code += "lbu $a2, 0($v1)\n";
+    code += "beqz $a2, __read_int_end_of_input\n";
+    code += "__read_int_blank:\n";
+    code += "slti $a3, $a2, 33\n";
+    code += "beqz $a3, __read_int_sign\n";
+    code += "addi $v1, $v1, 1\n";
+    code += "j __read_int_skip\n";
+    code += "__read_int_sign:\n";
+    code += "li $a0, 0\n";
+    code += "li $a1, 0\n";
+    code += "li $a3, 45\n";
+    code += "bne $a2, $a3, __read_int_digits\n";
+    code += "li $a1, 1\n";
+    code += "addi $v1, $v1, 1\n";
+    code += "__read_int_digits:\n";
+    code += "lbu $a2, 0($v1)\n";
+    code += "beqz $a2, __read_int_more\n";
+    code += "addi $a2, $a2, -48\n";
+    code += "sltiu $a3, $a2, 10\n";
+    code += "beqz $a3, __read_int_done\n";
+    code += "li $a3, 10\n";
+    code += "mult $a0, $a3\n";
+    code += "mflo $a0\n";
+    code += "sub $a0, $a0, $a2\n";
+    code += "addi $v1, $v1, 1\n";
+    code += "j __read_int_digits\n";
+    code += "__read_int_done:\n";
+    code += "move $v0, $a0\n";
+    code += "bnez $a1, __read_int_store\n";
+    code += "sub $v0, $zero, $a0\n";
+    code += "j __read_int_store\n";
+    // Una línea más larga que el búfer llega en varias lecturas: si el número
+    // llega al final del búfer, sigue con el resto de la línea. La syscall no
+    // toca $a2 ni $a3, donde quedan el valor y el signo mientras tanto
+    code += "__read_int_more:\n";
+    code += "move $a2, $a0\n";
+    code += "move $a3, $a1\n";
+    code += "la $v1, __in_buf\n";
+    code += "sb $zero, 0($v1)\n";
+    code += "move $a0, $v1\n";
+    code += "li $a1, " + std::to_string(INPUT_BUFFER_SIZE) + "\n";
+    code += "li $v0, 8\n";
+    code += "syscall\n";
+    code += "move $a0, $a2\n";
+    code += "move $a1, $a3\n";
+    code += "lbu $a2, 0($v1)\n";
+    code += "bnez $a2, __read_int_digits\n";
+    code += "j __read_int_done\n";
+    code += "__read_int_end_of_input:\n";
+    code += "li $v0, 0\n";
+    code += "__read_int_store:\n";
+    code += "la $a0, __in_buf\n";
+    code += "sub $a0, $v1, $a0\n";
+    code += "sw $a0, __in_pos\n";
+    code += "jr $ra\n";
+    return code;
+}
+
+std::string MipsRuntime::quote(const std::string &text)
+{
+    std::string result = "\"";
+    for (char c : text)
+    {
+        switch (c)
+        {
+        case '\\': result += "\\\\"; break;
+        case '"': result += "\\\""; break;
+        case '\n': result += "\\n"; break;
+        case '\t': result += "\\t"; break;
+        default: result += c; break;
+        }
+    }
+    return result + "\"";
+}
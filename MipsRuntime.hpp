@@ -0,0 +1,31 @@
+#pragma once
+#include <string>
+
+// Rutinas de E/S que se agregan al final del código MIPS cuando el programa
+// usa cout o cin. La salida se acumula en un búfer que se escribe con una sola
+// llamada al sistema (write sobre __out_fd, 1 por omisión) cuando se llena,
+// antes de leer y al terminar el programa; la entrada se lee por líneas y los
+// enteros se toman del búfer.
+// Las rutinas solo usan $a0-$a3, $v0 y $v1, así que los temporales vivos no
+// se guardan alrededor de la llamada.
+struct MipsRuntime
+{
+    static constexpr const char *PRINT_INT = "__print_int";       // $a0 = valor
+    static constexpr const char *PRINT_CHAR = "__print_char";     // $a0 = carácter
+    static constexpr const char *PRINT_STRING = "__print_string"; // $a0 = cadena terminada en 0
+    static constexpr const char *READ_INT = "__read_int";         // $v0 = entero leído, 0 al final
+    static constexpr const char *FLUSH = "__flush";
+    static constexpr const char *OUTPUT_FD = "__out_fd"; // descriptor en el que escribe __flush
+
+    static const int OUTPUT_BUFFER_SIZE = 4096;
+    static const int INPUT_BUFFER_SIZE = 4096;
+
+    // Directivas de .data con los búferes
+    static std::string data();
+
+    // Código de las rutinas, para la sección .text
+    static std::string code();
+
+    // Literal de .asciiz con las comillas y barras de text escapadas
+    static std::string quote(const std::string &text);
+};
@@ -0,0 +1,471 @@
+#include "MipsScheduler.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdlib>
+#include <unordered_map>
+#include <unordered_set>
+
+static const int REG_SP = 29;
+static const int REG_RA = 31;
+// HI y LO se tratan como un registro más
+static const int REG_HILO = 32;
+
+static uint64_t bit(int reg)
+{
+    return reg > 0 ? uint64_t(1) << reg : 0;
+}
+
+static std::string trim(const std::string &text)
+{
+    size_t begin = text.find_first_not_of(" \t\r");
+    if (begin == std::string::npos)
+    {
+        return "";
+    }
+    size_t end = text.find_last_not_of(" \t\r");
+    return text.substr(begin, end - begin + 1);
+}
+
+static bool isIdentifierChar(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.' || c == '$';
+}
+
+static bool parseInteger(const std::string &text, int64_t &value)
+{
+    if (text.empty())
+    {
+        return false;
+    }
+    char *end = nullptr;
+    value = std::strtoll(text.c_str(), &end, 0);
+    return *end == '\0';
+}
+
+static bool fitsSigned16(int64_t value)
+{
+    return value >= -32768 && value <= 32767;
+}
+
+static bool fitsUnsigned16(int64_t value)
+{
+    return value >= 0 && value <= 0xFFFF;
+}
+
+static int registerNumber(const std::string &text)
+{
+    static const std::unordered_map<std::string, int> names = {
+        {"zero", 0}, {"at", 1}, {"v0", 2}, {"v1", 3}, {"a0", 4}, {"a1", 5}, {"a2", 6}, {"a3", 7},
+        {"t0", 8}, {"t1", 9}, {"t2", 10}, {"t3", 11}, {"t4", 12}, {"t5", 13}, {"t6", 14}, {"t7", 15},
+        {"s0", 16}, {"s1", 17}, {"s2", 18}, {"s3", 19}, {"s4", 20}, {"s5", 21}, {"s6", 22}, {"s7", 23},
+        {"t8", 24}, {"t9", 25}, {"k0", 26}, {"k1", 27}, {"gp", 28}, {"sp", 29}, {"fp", 30}, {"ra", 31}};
+
+    if (text.size() < 2 || text[0] != '$')
+    {
+        return -1;
+    }
+    auto it = names.find(text.substr(1));
+    if (it != names.end())
+    {
+        return it->second;
+    }
+    int64_t number = 0;
+    if (parseInteger(text.substr(1), number) && number >= 0 && number < 32)
+    {
+        return static_cast<int>(number);
+    }
+    return -1;
+}
+
+std::string MipsScheduler::schedule(const std::string &source)
+{
+    return (fillDelaySlots ? ".set noreorder\n" : "") + scheduleFragment(source);
+}
+
+std::string MipsScheduler::scheduleFragment(const std::string &source)
+{
+    output.clear();
+    block.clear();
+
+    bool inText = true;
+    size_t position = 0;
+    while (position < source.size())
+    {
+        size_t end = source.find('\n', position);
+        if (end == std::string::npos)
+        {
+            end = source.size();
+        }
+        std::string line = source.substr(position, end - position);
+        position = end + 1;
+        std::string code = trim(line.substr(0, line.find('#')));
+
+        if (!inText)
+        {
+            if (code == ".text")
+            {
+                inText = true;
+            }
+            output += line + "\n";
+            continue;
+        }
+
+        // Cada etiqueta empieza un bloque nuevo
+        size_t length = 0;
+        while (length < code.size() && isIdentifierChar(code[length]))
+        {
+            ++length;
+        }
+        while (length > 0 && length < code.size() && code[length] == ':')
+        {
+            flush();
+            output += code.substr(0, length + 1) + "\n";
+            code = trim(code.substr(length + 1));
+            length = 0;
+            while (length < code.size() && isIdentifierChar(code[length]))
+            {
+                ++length;
+            }
+        }
+        if (code.empty())
+        {
+            continue;
+        }
+
+        if (code[0] == '.')
+        {
+            flush();
+            inText = code != ".data";
+            output += line + "\n";
+            continue;
+        }
+
+        Instruction instr = decode(code);
+        if (instr.barrier)
+        {
+            flush();
+            output += code + "\n";
+            continue;
+        }
+        block.push_back(instr);
+        if (instr.control)
+        {
+            flush();
+        }
+    }
+    flush();
+    return output;
+}
+
+// Lo que no se reconoce (syscall incluida) no se mueve ni deja que nada lo cruce
+MipsScheduler::Instruction MipsScheduler::decode(const std::string &code)
+{
+    Instruction instr;
+    instr.text = code;
+
+    size_t split = code.find_first_of(" \t");
+    std::string m = code.substr(0, split);
+    std::vector<std::string> ops;
+    if (split != std::string::npos)
+    {
+        std::string rest = code.substr(split + 1);
+        size_t start = 0;
+        while (start <= rest.size())
+        {
+            size_t comma = rest.find(',', start);
+            if (comma == std::string::npos)
+            {
+                comma = rest.size();
+            }
+            ops.push_back(trim(rest.substr(start, comma - start)));
+            start = comma + 1;
+        }
+    }
+
+    bool valid = true;
+    auto reg = [&](size_t index)
+    {
+        int number = index < ops.size() ? registerNumber(ops[index]) : -1;
+        valid = valid && number >= 0;
+        return number;
+    };
+    auto address = [&](size_t index)
+    {
+        const std::string operand = index < ops.size() ? ops[index] : "";
+        size_t open = operand.find('(');
+        if (open != std::string::npos && !operand.empty() && operand.back() == ')')
+        {
+            instr.base = registerNumber(trim(operand.substr(open + 1, operand.size() - open - 2)));
+            std::string displacement = trim(operand.substr(0, open));
+            valid = valid && instr.base >= 0 && (displacement.empty() || parseInteger(displacement, instr.offset));
+            instr.uses |= bit(instr.base);
+            instr.singleWord = fitsSigned16(instr.offset);
+            return;
+        }
+        size_t sign = operand.find_first_of("+-", 1);
+        instr.symbol = trim(operand.substr(0, sign));
+        if (sign != std::string::npos)
+        {
+            valid = valid && parseInteger(trim(operand.substr(sign + 1)), instr.offset);
+            instr.offset = operand[sign] == '-' ? -instr.offset : instr.offset;
+        }
+        valid = valid && !instr.symbol.empty();
+        instr.singleWord = false;
+    };
+
+    static const std::unordered_set<std::string> threeRegister = {
+        "add", "addu", "sub", "subu", "and", "or", "xor", "slt", "sltu"};
+    static const std::unordered_set<std::string> immediate = {
+        "addi", "addiu", "slti", "sltiu", "andi", "ori", "xori"};
+
+    if (threeRegister.count(m) && ops.size() == 3)
+    {
+        instr.defs = bit(reg(0));
+        instr.uses = bit(reg(1)) | bit(reg(2));
+    }
+    else if (immediate.count(m) && ops.size() == 3)
+    {
+        instr.defs = bit(reg(0));
+        instr.uses = bit(reg(1));
+        int64_t value = 0;
+        valid = valid && parseInteger(ops[2], value);
+        bool signedImm = m != "andi" && m != "ori" && m != "xori";
+        instr.singleWord = signedImm ? fitsSigned16(value) : fitsUnsigned16(value);
+    }
+    else if ((m == "mult" || m == "div") && ops.size() == 2)
+    {
+        instr.defs = bit(REG_HILO);
+        instr.uses = bit(reg(0)) | bit(reg(1));
+        instr.latency = m == "mult" ? MULTIPLY_LATENCY : DIVIDE_LATENCY;
+    }
+    else if ((m == "mflo" || m == "mfhi") && ops.size() == 1)
+    {
+        instr.defs = bit(reg(0));
+        instr.uses = bit(REG_HILO);
+    }
+    else if (((m == "sll" || m == "sra") && ops.size() == 3) || (m == "move" && ops.size() == 2))
+    {
+        instr.defs = bit(reg(0));
+        instr.uses = bit(reg(1));
+    }
+    else if (m == "li" && ops.size() == 2)
+    {
+        instr.defs = bit(reg(0));
+        int64_t value = 0;
+        valid = valid && parseInteger(ops[1], value);
+        value = static_cast<int32_t>(value);
+        instr.singleWord = fitsSigned16(value) || fitsUnsigned16(value) || (value & 0xFFFF) == 0;
+    }
+    else if ((m == "la" || m == "lw" || m == "sw" || m == "lbu" || m == "sb") && ops.size() == 2)
+    {
+        address(1);
+        if (m == "sw" || m == "sb")
+        {
+            instr.uses |= bit(reg(0));
+            instr.memory = Memory::STORE;
+        }
+        else
+        {
+            instr.defs = bit(reg(0));
+            instr.memory = m == "la" ? Memory::NONE : Memory::LOAD;
+            instr.latency = m == "la" ? 1 : LOAD_LATENCY;
+        }
+    }
+    else if ((m == "beqz" || m == "bnez") && ops.size() == 2)
+    {
+        instr.uses = bit(reg(0));
+        instr.control = true;
+    }
+    else if ((m == "beq" || m == "bne") && ops.size() == 3)
+    {
+        instr.uses = bit(reg(0)) | bit(reg(1));
+        instr.control = true;
+    }
+    else if ((m == "b" || m == "j") && ops.size() == 1)
+    {
+        instr.control = true;
+    }
+    else if (m == "jal" && ops.size() == 1)
+    {
+        instr.defs = bit(REG_RA);
+        instr.control = true;
+    }
+    else if (m == "jr" && ops.size() == 1)
+    {
+        instr.uses = bit(reg(0));
+        instr.control = true;
+    }
+    else if (m != "nop" || !ops.empty())
+    {
+        valid = false;
+    }
+
+    instr.barrier = !valid;
+    return instr;
+}
+
+// Latencia de la arista first -> second, o -1 si pueden intercambiarse
+int MipsScheduler::dependence(const Instruction &first, const Instruction &second)
+{
+    int latency = -1;
+    if (first.defs & second.uses)
+    {
+        latency = first.latency;
+    }
+    if (first.defs & second.defs)
+    {
+        latency = std::max(latency, 1);
+    }
+    if (first.uses & second.defs)
+    {
+        latency = std::max(latency, 0);
+    }
+    bool store = first.memory == Memory::STORE || second.memory == Memory::STORE;
+    if (store && first.memory != Memory::NONE && second.memory != Memory::NONE && mayAlias(first, second))
+    {
+        latency = std::max(latency, 1);
+    }
+    return latency;
+}
+
+// Solo se separan los accesos que seguro no se tocan: misma base sin
+// redefinir entre ambos, etiquetas distintas, o pila contra una global
+bool MipsScheduler::mayAlias(const Instruction &first, const Instruction &second)
+{
+    bool overlap = std::llabs(first.offset - second.offset) < 4;
+    if (first.base >= 0 && second.base >= 0)
+    {
+        return first.base != second.base || first.baseVersion != second.baseVersion || overlap;
+    }
+    if (first.base < 0 && second.base < 0)
+    {
+        return first.symbol == second.symbol && overlap;
+    }
+    return (first.base >= 0 ? first.base : second.base) != REG_SP;
+}
+
+void MipsScheduler::flush()
+{
+    if (block.empty())
+    {
+        return;
+    }
+
+    size_t count = block.size();
+    int versions[REG_HILO + 1] = {0};
+    for (Instruction &instr : block)
+    {
+        if (instr.base >= 0)
+        {
+            instr.baseVersion = versions[instr.base];
+        }
+        for (int reg = 1; reg <= REG_HILO; ++reg)
+        {
+            versions[reg] += (instr.defs & bit(reg)) ? 1 : 0;
+        }
+    }
+
+    std::vector<std::vector<std::pair<size_t, int>>> succs(count);
+    std::vector<int> preds(count, 0);
+    for (size_t j = 1; j < count; ++j)
+    {
+        for (size_t i = 0; i < j; ++i)
+        {
+            int latency = dependence(block[i], block[j]);
+            if (latency >= 0)
+            {
+                succs[i].push_back({j, latency});
+                ++preds[j];
+            }
+        }
+    }
+
+    // Prioridad: ciclos que faltan hasta el final del bloque por el camino crítico
+    std::vector<int> height(count, 1);
+    for (size_t i = count; i-- > 0;)
+    {
+        for (const std::pair<size_t, int> &edge : succs[i])
+        {
+            height[i] = std::max(height[i], edge.second + height[edge.first]);
+        }
+    }
+
+    // El salto que cierra el bloque se queda al final
+    bool control = block.back().control;
+    size_t body = control ? count - 1 : count;
+    std::vector<size_t> order;
+    std::vector<int> earliest(count, 0);
+    std::vector<bool> issued(count, false);
+    int cycle = 0;
+    while (order.size() < body)
+    {
+        size_t best = count;
+        for (size_t i = 0; i < body; ++i)
+        {
+            if (issued[i] || preds[i] > 0)
+            {
+                continue;
+            }
+            if (best == count)
+            {
+                best = i;
+                continue;
+            }
+            bool ready = earliest[i] <= cycle;
+            bool bestReady = earliest[best] <= cycle;
+            if (ready != bestReady)
+            {
+                best = ready ? i : best;
+            }
+            else if (!ready && earliest[i] != earliest[best])
+            {
+                best = earliest[i] < earliest[best] ? i : best;
+            }
+            else if (height[i] > height[best])
+            {
+                best = i;
+            }
+        }
+
+        cycle = std::max(cycle, earliest[best]);
+        issued[best] = true;
+        order.push_back(best);
+        for (const std::pair<size_t, int> &edge : succs[best])
+        {
+            --preds[edge.first];
+            earliest[edge.first] = std::max(earliest[edge.first], cycle + edge.second);
+        }
+        ++cycle;
+    }
+
+    // La ranura de retardo se llena con la última instrucción de la que nada
+    // depende en el bloque, ni siquiera el salto
+    size_t slot = count;
+    if (control && fillDelaySlots)
+    {
+        for (size_t k = order.size(); k-- > 0;)
+        {
+            if (succs[order[k]].empty() && block[order[k]].singleWord)
+            {
+                slot = order[k];
+                order.erase(order.begin() + static_cast<std::ptrdiff_t>(k));
+                break;
+            }
+        }
+    }
+
+    for (size_t index : order)
+    {
+        output += block[index].text + "\n";
+    }
+    if (control)
+    {
+        output += block.back().text + "\n";
+        if (fillDelaySlots)
+        {
+            output += (slot < count ? block[slot].text : std::string("nop")) + "\n";
+        }
+    }
+    block.clear();
+}
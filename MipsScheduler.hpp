@@ -0,0 +1,64 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Ordena el código MIPS ya generado para un procesador segmentado. Dentro de
+// cada bloque básico se construye el grafo de dependencias (registros, HI/LO
+// y memoria) y se planifica por lista dando prioridad al camino crítico, para
+// separar cada lw y cada mult/div de la instrucción que usa su resultado. Con
+// ranuras de retardo, además se mueve después de cada salto una instrucción
+// independiente del bloque (o un nop) y el código se marca con
+// `.set noreorder`, de modo que SPIM debe ejecutarse con -delayed_branches.
+class MipsScheduler
+{
+public:
+    explicit MipsScheduler(bool fillDelaySlots) : fillDelaySlots(fillDelaySlots) {}
+
+    std::string schedule(const std::string &source);
+
+    // Igual que schedule, pero sin `.set noreorder`, para ordenar un programa
+    // por partes (--stream); cada parte debe terminar un bloque básico
+    std::string scheduleFragment(const std::string &source);
+
+private:
+    // Ciclos hasta que el resultado puede usarse sin detener el cauce
+    static const int LOAD_LATENCY = 2;
+    static const int MULTIPLY_LATENCY = 5;
+    static const int DIVIDE_LATENCY = 20;
+
+    enum class Memory
+    {
+        NONE,
+        LOAD,
+        STORE
+    };
+
+    struct Instruction
+    {
+        std::string text;
+        uint64_t defs = 0;
+        uint64_t uses = 0;
+        int latency = 1;
+        bool control = false;
+        bool barrier = false;
+        bool singleWord = true;
+
+        // Dirección de lw/sw: desplazamiento(base) o etiqueta+desplazamiento
+        Memory memory = Memory::NONE;
+        int base = -1;
+        int baseVersion = 0;
+        std::string symbol;
+        int64_t offset = 0;
+    };
+
+    bool fillDelaySlots;
+
+    std::vector<Instruction> block;
+    std::string output;
+
+    void flush();
+    static Instruction decode(const std::string &code);
+    static int dependence(const Instruction &first, const Instruction &second);
+    static bool mayAlias(const Instruction &first, const Instruction &second);
+};
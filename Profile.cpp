@@ -0,0 +1,104 @@
+#include "Profile.hpp"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+void ProfileNumbering::run(ProgramNode *program)
+{
+    profileSites().clear();
+    for (AstNode *node : program->getFunctions())
+    {
+        number(static_cast<FunctionDeclExpr *>(node));
+    }
+}
+
+void ProfileNumbering::number(FunctionDeclExpr *func)
+{
+    functionName = func->getName();
+    ifCount = 0;
+    loopCount = 0;
+    func->setProfileSite(addSite("function " + functionName, 1));
+    for (AstNode *stmt : func->getStatements())
+    {
+        visit(stmt);
+    }
+}
+
+void ProfileNumbering::visit(AstNode *node)
+{
+    if (!node)
+    {
+        return;
+    }
+    if (IfStmt *ifStmt = dynamic_cast<IfStmt *>(node))
+    {
+        ifStmt->setProfileSite(addSite("if " + functionName + " " + std::to_string(ifCount++), 2));
+    }
+    else if (WhileStmt *loop = dynamic_cast<WhileStmt *>(node))
+    {
+        loop->setProfileSite(addSite("while " + functionName + " " + std::to_string(loopCount++), 2));
+    }
+    node->forEachChild([&](AstNode *&child)
+    {
+        visit(child);
+    });
+}
+
+int ProfileNumbering::addSite(const std::string &label, int counters)
+{
+    std::vector<ProfileSite> &sites = profileSites();
+    int first = sites.empty() ? 0 : sites.back().first + sites.back().counters;
+    sites.push_back({label, first, counters, {}});
+    return static_cast<int>(sites.size()) - 1;
+}
+
+void ProfileLoader::read(const std::string &path)
+{
+    std::ifstream in(path);
+    if (!in)
+    {
+        throw std::runtime_error("Cannot open profile file: " + path);
+    }
+
+    // La etiqueta de una función tiene dos palabras; la de if y while, tres
+    counts.clear();
+    std::string line;
+    while (std::getline(in, line))
+    {
+        std::istringstream words(line);
+        std::string kind, name, index;
+        if (!(words >> kind >> name))
+        {
+            continue;
+        }
+        std::string label = kind + " " + name;
+        if (kind != "function")
+        {
+            if (!(words >> index))
+            {
+                continue;
+            }
+            label += " " + index;
+        }
+
+        std::vector<long long> &values = counts[label];
+        long long count;
+        while (words >> count)
+        {
+            values.push_back(count);
+        }
+    }
+}
+
+void ProfileLoader::apply(int first)
+{
+    std::vector<ProfileSite> &sites = profileSites();
+    for (size_t i = first; i < sites.size(); ++i)
+    {
+        auto it = counts.find(sites[i].label);
+        if (it != counts.end() && static_cast<int>(it->second.size()) == sites[i].counters)
+        {
+            sites[i].counts = it->second;
+        }
+    }
+}
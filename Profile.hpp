@@ -0,0 +1,45 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Ast.hpp"
+
+// Numera los sitios que cuenta --instrument (ver ProfileSite): cada función y,
+// dentro de ella, cada if y cada while en orden de aparición. Se ejecuta sobre
+// el árbol recién analizado, antes de cualquier transformación, para que la
+// numeración dependa solo del programa fuente. Los nodos clonados por el
+// inliner conservan su sitio, así que cuentan para la función original.
+class ProfileNumbering
+{
+public:
+    void run(ProgramNode *program);
+
+    // Numera una sola función a continuación de los sitios ya numerados (--stream)
+    void number(FunctionDeclExpr *func);
+
+private:
+    std::string functionName;
+    int ifCount = 0;
+    int loopCount = 0;
+
+    void visit(AstNode *node);
+    static int addSite(const std::string &label, int counters);
+};
+
+// Lee el archivo que escribe un programa instrumentado (una línea
+// "etiqueta contadores..." por sitio) y guarda los contadores en los sitios
+// con la misma etiqueta, para que la generación de código y el inliner los
+// consulten con profileCount. Las líneas que no corresponden a ningún sitio
+// (el programa cambió desde la ejecución) se ignoran.
+class ProfileLoader
+{
+public:
+    // Lanza std::runtime_error si el archivo no se puede abrir
+    void read(const std::string &path);
+
+    // Copia los contadores a los sitios que ProfileNumbering numeró a partir de first
+    void apply(int first = 0);
+
+private:
+    std::unordered_map<std::string, std::vector<long long>> counts; // por etiqueta
+};
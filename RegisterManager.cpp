@@ -31,3 +31,21 @@ void freeTempRegister(const std::string &reg)
         throw std::runtime_error("Trying to free a register that is not temporary");
     }
 }
+
+std::vector<std::string> liveTempRegisters()
+{
+    std::vector<std::string> live;
+    for (size_t i = 0; i < tempRegisters.size(); ++i)
+    {
+        if (tempRegisterUsed[i])
+        {
+            live.push_back(tempRegisters[i]);
+        }
+    }
+    return live;
+}
+
+size_t freeTempRegisterCount()
+{
+    return std::count(tempRegisterUsed.begin(), tempRegisterUsed.end(), false);
+}
@@ -1,5 +1,8 @@
 #pragma once
 #include <string>
+#include <vector>
 
 std::string allocateTempRegister();
 void freeTempRegister(const std::string &reg);
+std::vector<std::string> liveTempRegisters();
+size_t freeTempRegisterCount();
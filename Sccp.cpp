@@ -0,0 +1,326 @@
+#include "Sccp.hpp"
+#include <climits>
+
+void ConstantPropagator::run(ProgramNode *program)
+{
+    for (AstNode *node : program->getFunctions())
+    {
+        FunctionDeclExpr *func = static_cast<FunctionDeclExpr *>(node);
+        SsaFunction function(func);
+        ssa = &function;
+        propagate();
+        for (AstNode *&stmt : func->getStatements())
+        {
+            simplify(stmt);
+        }
+        ssa = nullptr;
+    }
+}
+
+// Dos listas de trabajo: aristas del grafo que se vuelven ejecutables y
+// instrucciones cuyos operandos bajaron en la retícula. Un bloque se evalúa
+// completo la primera vez que se alcanza; después solo se revisan sus phi.
+void ConstantPropagator::propagate()
+{
+    const std::vector<SsaBlock> &blocks = ssa->getBlocks();
+    values.assign(ssa->getValueCount(), Lattice{Lattice::TOP, 0});
+    executableBlocks.assign(blocks.size(), false);
+    executableEdges.assign(blocks.size(), std::vector<bool>());
+    for (size_t i = 0; i < blocks.size(); ++i)
+    {
+        executableEdges[i].assign(blocks[i].succs.size(), false);
+    }
+    flowWork.clear();
+    ssaWork.clear();
+
+    int entered = SsaFunction::ENTRY_BLOCK;
+    while (entered >= 0 || !flowWork.empty() || !ssaWork.empty())
+    {
+        if (entered < 0 && !flowWork.empty())
+        {
+            int from = flowWork.back().first;
+            size_t succ = flowWork.back().second;
+            flowWork.pop_back();
+            if (executableEdges[from][succ])
+            {
+                continue;
+            }
+            executableEdges[from][succ] = true;
+
+            int to = blocks[from].succs[succ];
+            if (executableBlocks[to])
+            {
+                for (int index : blocks[to].instrs)
+                {
+                    if (ssa->getInstrs()[index].kind != SsaInstr::PHI)
+                    {
+                        break;
+                    }
+                    visit(index);
+                }
+                continue;
+            }
+            entered = to;
+        }
+
+        if (entered >= 0)
+        {
+            executableBlocks[entered] = true;
+            for (int index : blocks[entered].instrs)
+            {
+                visit(index);
+            }
+            if (blocks[entered].branch < 0 && blocks[entered].succs.size() == 1)
+            {
+                flowWork.push_back({entered, 0});
+            }
+            entered = -1;
+            continue;
+        }
+
+        int index = ssaWork.back();
+        ssaWork.pop_back();
+        if (executableBlocks[ssa->getInstrs()[index].block])
+        {
+            visit(index);
+        }
+    }
+}
+
+void ConstantPropagator::visit(int index)
+{
+    const SsaInstr &instr = ssa->getInstrs()[index];
+    switch (instr.kind)
+    {
+    case SsaInstr::PHI:
+        visitPhi(instr);
+        break;
+    case SsaInstr::ENTRY:
+    case SsaInstr::READ:
+        update(instr.value, Lattice{Lattice::BOTTOM, 0});
+        break;
+    case SsaInstr::ASSIGN:
+        update(instr.value, evaluate(instr.expr));
+        break;
+    case SsaInstr::BRANCH:
+    {
+        Lattice condition = evaluate(instr.expr);
+        if (condition.state == Lattice::BOTTOM || (condition.state == Lattice::CONSTANT && condition.value != 0))
+        {
+            flowWork.push_back({instr.block, 0});
+        }
+        if (condition.state == Lattice::BOTTOM || (condition.state == Lattice::CONSTANT && condition.value == 0))
+        {
+            flowWork.push_back({instr.block, 1});
+        }
+        break;
+    }
+    case SsaInstr::USE:
+        break;
+    }
+}
+
+// Solo cuentan los valores que llegan por aristas ya ejecutables
+void ConstantPropagator::visitPhi(const SsaInstr &phi)
+{
+    const std::vector<int> &preds = ssa->getBlocks()[phi.block].preds;
+    Lattice result{Lattice::TOP, 0};
+    for (size_t j = 0; j < preds.size(); ++j)
+    {
+        if (phi.args[j] >= 0 && edgeExecutable(preds[j], phi.block))
+        {
+            result = meet(result, values[phi.args[j]]);
+        }
+    }
+    update(phi.value, result);
+}
+
+void ConstantPropagator::update(int value, Lattice lattice)
+{
+    Lattice lowered = meet(values[value], lattice);
+    if (lowered.state == values[value].state && lowered.value == values[value].value)
+    {
+        return;
+    }
+    values[value] = lowered;
+    const std::vector<int> &users = ssa->getUsers(value);
+    ssaWork.insert(ssaWork.end(), users.begin(), users.end());
+}
+
+bool ConstantPropagator::edgeExecutable(int from, int to) const
+{
+    const std::vector<int> &succs = ssa->getBlocks()[from].succs;
+    for (size_t i = 0; i < succs.size(); ++i)
+    {
+        if (succs[i] == to && executableEdges[from][i])
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Las llamadas y los elementos de arreglo nunca son constantes aquí: de eso
+// se ocupa ConstexprEvaluator
+ConstantPropagator::Lattice ConstantPropagator::evaluate(AstNode *expr) const
+{
+    if (ValueExpr *constant = dynamic_cast<ValueExpr *>(expr))
+    {
+        return Lattice{Lattice::CONSTANT, static_cast<int32_t>(constant->getValue())};
+    }
+    if (dynamic_cast<VariableExpr *>(expr))
+    {
+        int value = ssa->useValue(expr);
+        return value >= 0 ? values[value] : Lattice{Lattice::BOTTOM, 0};
+    }
+    BinaryExpr *binary = dynamic_cast<BinaryExpr *>(expr);
+    if (!binary)
+    {
+        return Lattice{Lattice::BOTTOM, 0};
+    }
+
+    Lattice left = evaluate(binary->getLeft());
+    Lattice right = evaluate(binary->getRight());
+    if (left.state == Lattice::BOTTOM || right.state == Lattice::BOTTOM)
+    {
+        return Lattice{Lattice::BOTTOM, 0};
+    }
+    if (left.state == Lattice::TOP || right.state == Lattice::TOP)
+    {
+        return Lattice{Lattice::TOP, 0};
+    }
+    int32_t result;
+    if (!fold(expr, left.value, right.value, result))
+    {
+        return Lattice{Lattice::BOTTOM, 0};
+    }
+    return Lattice{Lattice::CONSTANT, result};
+}
+
+// Reescribe el árbol con el resultado: primero quita las ramas que no se
+// toman, luego sustituye las lecturas constantes y pliega de abajo hacia arriba
+void ConstantPropagator::simplify(AstNode *&node)
+{
+    if (!node)
+    {
+        return;
+    }
+
+    if (IfStmt *ifStmt = dynamic_cast<IfStmt *>(node))
+    {
+        bool thenPath = takesPath(node, true);
+        bool elsePath = takesPath(node, false);
+        if (thenPath != elsePath)
+        {
+            AstNode *kept = thenPath ? ifStmt->releaseIfBody() : ifStmt->releaseElseBody();
+            delete node;
+            node = kept ? kept : new ExprList();
+            simplify(node);
+            return;
+        }
+    }
+    else if (dynamic_cast<WhileStmt *>(node))
+    {
+        if (!takesPath(node, true) && takesPath(node, false))
+        {
+            delete node;
+            node = new ExprList();
+            return;
+        }
+    }
+    else if (dynamic_cast<VariableExpr *>(node))
+    {
+        int value = ssa->useValue(node);
+        if (value >= 0 && values[value].state == Lattice::CONSTANT)
+        {
+            int32_t constant = values[value].value;
+            delete node;
+            node = new ValueExpr(constant);
+        }
+        return;
+    }
+
+    node->forEachChild([&](AstNode *&child)
+    {
+        simplify(child);
+    });
+
+    if (BinaryExpr *binary = dynamic_cast<BinaryExpr *>(node))
+    {
+        ValueExpr *left = dynamic_cast<ValueExpr *>(binary->getLeft());
+        ValueExpr *right = dynamic_cast<ValueExpr *>(binary->getRight());
+        int32_t result;
+        if (left && right &&
+            fold(node, static_cast<int32_t>(left->getValue()), static_cast<int32_t>(right->getValue()), result))
+        {
+            delete node;
+            node = new ValueExpr(result);
+        }
+    }
+}
+
+// Si la arista verdadera (o falsa) del if o while llegó a ser ejecutable. En
+// código inalcanzable se responde que sí, para no tocar nada
+bool ConstantPropagator::takesPath(const AstNode *stmt, bool truePath) const
+{
+    int branch = ssa->branchOf(stmt);
+    if (branch < 0)
+    {
+        return true;
+    }
+    int block = ssa->getInstrs()[branch].block;
+    if (!executableBlocks[block])
+    {
+        return true;
+    }
+    return executableEdges[block][truePath ? 0 : 1];
+}
+
+ConstantPropagator::Lattice ConstantPropagator::meet(Lattice a, Lattice b)
+{
+    if (a.state == Lattice::TOP)
+    {
+        return b;
+    }
+    if (b.state == Lattice::TOP)
+    {
+        return a;
+    }
+    if (a.state == Lattice::CONSTANT && b.state == Lattice::CONSTANT && a.value == b.value)
+    {
+        return a;
+    }
+    return Lattice{Lattice::BOTTOM, 0};
+}
+
+// Misma aritmética de 32 bits que el código MIPS. La división entre cero y
+// el desbordamiento de INT_MIN / -1 se dejan para la ejecución
+bool ConstantPropagator::fold(AstNode *op, int32_t left, int32_t right, int32_t &result)
+{
+    int64_t x = left;
+    int64_t y = right;
+    int64_t value;
+    if (dynamic_cast<AddExpr *>(op)) value = x + y;
+    else if (dynamic_cast<SubExpr *>(op)) value = x - y;
+    else if (dynamic_cast<MulExpr *>(op)) value = x * y;
+    else if (dynamic_cast<DivExpr *>(op) || dynamic_cast<ModExpr *>(op))
+    {
+        if (y == 0 || (x == INT32_MIN && y == -1))
+        {
+            return false;
+        }
+        value = dynamic_cast<DivExpr *>(op) ? x / y : x % y;
+    }
+    else if (dynamic_cast<GreaterExpr *>(op)) value = x > y;
+    else if (dynamic_cast<LessExpr *>(op)) value = x < y;
+    else if (dynamic_cast<GreaterEqualExpr *>(op)) value = x >= y;
+    else if (dynamic_cast<LessEqualExpr *>(op)) value = x <= y;
+    else if (dynamic_cast<NotEqualExpr *>(op)) value = x != y;
+    else if (dynamic_cast<EqualExpr *>(op)) value = x == y;
+    else if (dynamic_cast<AndExpr *>(op)) value = x & y;
+    else if (dynamic_cast<OrExpr *>(op)) value = x | y;
+    else return false;
+
+    result = static_cast<int32_t>(static_cast<uint32_t>(value));
+    return true;
+}
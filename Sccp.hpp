@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Ast.hpp"
+#include "Ssa.hpp"
+
+// Propagación de constantes condicional y dispersa (Wegman y Zadeck) sobre la
+// forma SSA de cada función. Las lecturas de variables que resultan constantes
+// se sustituyen por su valor, las subexpresiones constantes se pliegan y se
+// quitan los if y while cuya condición no puede tomar uno de los caminos.
+class ConstantPropagator
+{
+public:
+    void run(ProgramNode *program);
+
+private:
+    struct Lattice
+    {
+        enum State
+        {
+            TOP,      // todavía sin valor conocido
+            CONSTANT, // siempre vale value
+            BOTTOM    // puede valer distintas cosas
+        };
+
+        State state;
+        int32_t value;
+    };
+
+    const SsaFunction *ssa = nullptr;
+    std::vector<Lattice> values;
+    std::vector<bool> executableBlocks;
+    std::vector<std::vector<bool>> executableEdges; // por bloque, índice en succs
+    std::vector<std::pair<int, size_t>> flowWork;
+    std::vector<int> ssaWork;
+
+    void propagate();
+    void visit(int index);
+    void visitPhi(const SsaInstr &phi);
+    void update(int value, Lattice lattice);
+    bool edgeExecutable(int from, int to) const;
+
+    Lattice evaluate(AstNode *expr) const;
+    void simplify(AstNode *&node);
+    bool takesPath(const AstNode *stmt, bool truePath) const;
+
+    static Lattice meet(Lattice a, Lattice b);
+    static bool fold(AstNode *op, int32_t left, int32_t right, int32_t &result);
+};
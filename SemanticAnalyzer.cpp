@@ -0,0 +1,310 @@
+#include "SemanticAnalyzer.hpp"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <unordered_set>
+
+// Nombres declarados en una lista de declaraciones (int a, b[3];)
+static void declaredNames(AstNode *decls, std::vector<std::string> &names)
+{
+    if (VarDeclExpr *decl = dynamic_cast<VarDeclExpr *>(decls))
+    {
+        names.push_back(decl->getVarName());
+    }
+    else if (ExprList *list = dynamic_cast<ExprList *>(decls))
+    {
+        for (AstNode *expr : list->getExpressions())
+        {
+            declaredNames(expr, names);
+        }
+    }
+}
+
+void SemanticAnalyzer::run(ProgramNode *program)
+{
+    paramArrays.clear();
+    forwardCalls.clear();
+    errors.clear();
+    incremental = false;
+
+    checkGlobals(program);
+    collectFunctions(program);
+    for (AstNode *node : program->getFunctions())
+    {
+        checkBody(static_cast<FunctionDeclExpr *>(node));
+    }
+    report();
+}
+
+void SemanticAnalyzer::checkFunction(FunctionDeclExpr *func)
+{
+    incremental = true;
+    declareFunction(func);
+    checkBody(func);
+    resolveForwardCalls();
+    report();
+}
+
+bool SemanticAnalyzer::hasForwardCalls(const std::string &caller) const
+{
+    return forwardCalls.count(caller) != 0;
+}
+
+void SemanticAnalyzer::finish(ProgramNode *program)
+{
+    for (const auto &pending : forwardCalls)
+    {
+        for (FunctionCallExpr *call : pending.second)
+        {
+            error("Function " + call->getFunctionName() + " is not defined (called from " + pending.first + ")");
+        }
+    }
+    checkGlobals(program);
+    if (!paramArrays.count("main"))
+    {
+        error("Function main is not defined");
+    }
+    report();
+}
+
+void SemanticAnalyzer::checkGlobals(ProgramNode *program)
+{
+    std::vector<std::string> globals;
+    for (AstNode *decl : program->getGlobals())
+    {
+        declaredNames(decl, globals);
+    }
+    checkDeclarations(globals, "global scope");
+}
+
+void SemanticAnalyzer::collectFunctions(ProgramNode *program)
+{
+    for (AstNode *node : program->getFunctions())
+    {
+        declareFunction(static_cast<FunctionDeclExpr *>(node));
+    }
+    if (!paramArrays.count("main"))
+    {
+        error("Function main is not defined");
+    }
+}
+
+void SemanticAnalyzer::declareFunction(FunctionDeclExpr *func)
+{
+    std::vector<int> arrays;
+    for (ParamExpr *param : func->getParams())
+    {
+        arrays.push_back(SymbolTable::getArraySize(param->getVarRef()));
+    }
+    if (!paramArrays.emplace(func->getName(), arrays).second)
+    {
+        error("Function " + func->getName() + " is defined more than once");
+    }
+}
+
+void SemanticAnalyzer::checkBody(FunctionDeclExpr *func)
+{
+    functionName = func->getName();
+
+    std::vector<std::string> locals;
+    for (ParamExpr *param : func->getParams())
+    {
+        locals.push_back(param->getParamName());
+    }
+    for (AstNode *decl : func->getVarDecls())
+    {
+        declaredNames(decl, locals);
+    }
+    checkDeclarations(locals, "function " + functionName);
+
+    for (AstNode *stmt : func->getStatements())
+    {
+        visit(stmt);
+    }
+}
+
+// Revisa las llamadas pendientes cuya función ya se definió
+void SemanticAnalyzer::resolveForwardCalls()
+{
+    std::string current = functionName;
+    for (auto it = forwardCalls.begin(); it != forwardCalls.end();)
+    {
+        std::vector<FunctionCallExpr *> &calls = it->second;
+        functionName = it->first;
+        auto resolved = std::remove_if(calls.begin(), calls.end(), [&](FunctionCallExpr *call)
+        {
+            if (!paramArrays.count(call->getFunctionName()))
+            {
+                return false;
+            }
+            checkCall(call);
+            return true;
+        });
+        calls.erase(resolved, calls.end());
+        it = calls.empty() ? forwardCalls.erase(it) : std::next(it);
+    }
+    functionName = current;
+}
+
+void SemanticAnalyzer::report() const
+{
+    if (!errors.empty())
+    {
+        std::string message = errors[0];
+        for (size_t i = 1; i < errors.size(); ++i)
+        {
+            message += "\n" + errors[i];
+        }
+        throw std::runtime_error(message);
+    }
+}
+
+void SemanticAnalyzer::checkDeclarations(const std::vector<std::string> &names, const std::string &scope)
+{
+    std::unordered_set<std::string> seen;
+    for (const std::string &name : names)
+    {
+        if (!seen.insert(name).second)
+        {
+            error("Variable " + name + " is declared more than once in " + scope);
+        }
+    }
+}
+
+void SemanticAnalyzer::visit(AstNode *node)
+{
+    if (!node)
+    {
+        return;
+    }
+
+    if (VariableExpr *var = dynamic_cast<VariableExpr *>(node))
+    {
+        var->setVarRef(bind(var->getVarRef(), var->getVarName()));
+        checkScalar(var->getVarRef(), var->getVarName());
+    }
+    else if (AssignExpr *assign = dynamic_cast<AssignExpr *>(node))
+    {
+        checkScalar(assign->getVarRef(), assign->getVarName());
+    }
+    else if (CinExpr *cin = dynamic_cast<CinExpr *>(node))
+    {
+        cin->setVarRef(bind(cin->getVarRef(), cin->getVarName()));
+        checkScalar(cin->getVarRef(), cin->getVarName());
+    }
+    else if (ArrayAccess *access = dynamic_cast<ArrayAccess *>(node))
+    {
+        VarRef ref = bind(access->getVarRef(), access->getVarName());
+        access->setVarRef(ref);
+        // Un parámetro por referencia escalar también puede indexarse
+        if (ref.isValid() && SymbolTable::getArraySize(ref) == 0 && !SymbolTable::isReference(ref) &&
+            (SymbolTable::isGlobal(ref) || SymbolTable::variable(ref).offset >= 0))
+        {
+            error("Variable " + access->getVarName() + " is not an array in function " + functionName);
+        }
+    }
+    else if (FunctionCallExpr *call = dynamic_cast<FunctionCallExpr *>(node))
+    {
+        // Un arreglo sin índice puede ser argumento; checkCall revisa que su
+        // parámetro también sea arreglo
+        for (AstNode *arg : call->getArguments())
+        {
+            if (VariableExpr *var = dynamic_cast<VariableExpr *>(arg))
+            {
+                var->setVarRef(bind(var->getVarRef(), var->getVarName()));
+            }
+        }
+        checkCall(call);
+        for (AstNode *arg : call->getArguments())
+        {
+            if (!dynamic_cast<VariableExpr *>(arg))
+            {
+                visit(arg);
+            }
+        }
+        return;
+    }
+
+    node->forEachChild([&](AstNode *&child)
+    {
+        visit(child);
+    });
+}
+
+// Un local sin espacio reservado nunca se declaró ni se asignó; puede ser un
+// global declarado más adelante en el archivo
+VarRef SemanticAnalyzer::bind(VarRef ref, const std::string &varName)
+{
+    if (SymbolTable::isGlobal(ref) || SymbolTable::variable(ref).offset >= 0)
+    {
+        return ref;
+    }
+    VarRef global = SymbolTable::findGlobal(varName);
+    if (global.isValid())
+    {
+        return global;
+    }
+    error("Variable " + varName + " is not declared in function " + functionName);
+    return ref;
+}
+
+void SemanticAnalyzer::checkScalar(VarRef ref, const std::string &varName)
+{
+    if (ref.isValid() && SymbolTable::getArraySize(ref) > 0)
+    {
+        error("Variable " + varName + " is an array in function " + functionName);
+    }
+}
+
+void SemanticAnalyzer::checkCall(FunctionCallExpr *call)
+{
+    const std::string &callee = call->getFunctionName();
+    auto it = paramArrays.find(callee);
+    if (it == paramArrays.end())
+    {
+        if (incremental)
+        {
+            forwardCalls[functionName].push_back(call);
+        }
+        else
+        {
+            error("Function " + callee + " is not defined (called from " + functionName + ")");
+        }
+        return;
+    }
+
+    const std::vector<AstNode *> &args = call->getArguments();
+    const std::vector<int> &arrays = it->second;
+    if (args.size() != arrays.size())
+    {
+        error("Function " + callee + " expects " + std::to_string(arrays.size()) + " arguments, got " +
+              std::to_string(args.size()) + " in function " + functionName);
+        return;
+    }
+
+    for (size_t i = 0; i < args.size(); ++i)
+    {
+        std::string argument = "Argument " + std::to_string(i + 1) + " of " + callee;
+        VariableExpr *var = dynamic_cast<VariableExpr *>(args[i]);
+        if (SymbolTable::isReferenceParam(call->getCalleeId(), i) && !var)
+        {
+            error(argument + " must be a variable (reference parameter) in function " + functionName);
+            continue;
+        }
+
+        bool isArray = var && var->getVarRef().isValid() && SymbolTable::getArraySize(var->getVarRef()) > 0;
+        if (arrays[i] > 0 && var && !isArray)
+        {
+            error(argument + " must be an array in function " + functionName);
+        }
+        else if (arrays[i] == 0 && isArray)
+        {
+            error(argument + " must not be an array in function " + functionName);
+        }
+    }
+}
+
+void SemanticAnalyzer::error(const std::string &message)
+{
+    errors.push_back(message);
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Ast.hpp"
+
+// Revisa el programa completo antes de optimizarlo o generar código. Cada
+// identificador queda ligado a su declaración (una asignación declara un
+// local implícito), los arreglos y escalares se usan como tales y cada
+// llamada se valida contra la función definida: número de argumentos,
+// variables en los parámetros por referencia y arreglos solo en los
+// parámetros arreglo. Los errores se reúnen y se informan juntos.
+class SemanticAnalyzer
+{
+public:
+    // Lanza std::runtime_error con todos los errores encontrados
+    void run(ProgramNode *program);
+
+    // Revisión por partes (--stream): cada función se revisa al terminar de
+    // leerla, así que solo puede usar los globales ya declarados. Las
+    // llamadas a funciones que aún no se definen quedan pendientes y se
+    // revisan cuando la función aparece; hasForwardCalls dice si a una
+    // función todavía le quedan. finish informa las que nunca se definieron
+    // y revisa los globales y que exista main. Lanzan igual que run.
+    void checkFunction(FunctionDeclExpr *func);
+    bool hasForwardCalls(const std::string &caller) const;
+    void finish(ProgramNode *program);
+
+    const std::vector<std::string> &getErrors() const { return errors; }
+
+private:
+    // Tamaño de arreglo de cada parámetro (0 si es escalar), por nombre de función
+    std::unordered_map<std::string, std::vector<int>> paramArrays;
+    // Llamadas a funciones aún no definidas, por función que llama (--stream)
+    std::map<std::string, std::vector<FunctionCallExpr *>> forwardCalls;
+    std::string functionName;
+    std::vector<std::string> errors;
+    bool incremental = false;
+
+    void checkGlobals(ProgramNode *program);
+    void collectFunctions(ProgramNode *program);
+    void declareFunction(FunctionDeclExpr *func);
+    void checkBody(FunctionDeclExpr *func);
+    void resolveForwardCalls();
+    void report() const;
+    void checkDeclarations(const std::vector<std::string> &names, const std::string &scope);
+    void visit(AstNode *node);
+    VarRef bind(VarRef ref, const std::string &varName);
+    void checkScalar(VarRef ref, const std::string &varName);
+    void checkCall(FunctionCallExpr *call);
+
+    void error(const std::string &message);
+};
@@ -0,0 +1,516 @@
+#include "Ssa.hpp"
+#include <algorithm>
+
+// Marca de una variable cuyo seguimiento aún no se decidió
+static const int UNDECIDED = -2;
+
+SsaFunction::SsaFunction(FunctionDeclExpr *func) : functionId(SymbolTable::functionId(func->getName()))
+{
+    for (AstNode *stmt : func->getStatements())
+    {
+        markAddressTaken(stmt);
+    }
+
+    int current = newBlock();
+    for (AstNode *stmt : func->getStatements())
+    {
+        current = buildStatement(stmt, current);
+    }
+
+    // Toda variable seguida tiene un valor de entrada desconocido, así cada
+    // lectura alcanzable tiene una definición que la domina
+    std::vector<int> entry;
+    for (int var = 0; var < varCount; ++var)
+    {
+        SsaInstr instr;
+        instr.kind = SsaInstr::ENTRY;
+        instr.block = ENTRY_BLOCK;
+        instr.var = var;
+        instrs.push_back(instr);
+        entry.push_back(static_cast<int>(instrs.size() - 1));
+    }
+    std::vector<int> &entryInstrs = blocks[ENTRY_BLOCK].instrs;
+    entryInstrs.insert(entryInstrs.begin(), entry.begin(), entry.end());
+
+    std::vector<int> order = reversePostorder();
+    std::vector<int> idom = dominators(order);
+    placePhis(idom, order);
+    rename(idom, order);
+
+    valueUsers.assign(valueDefs.size(), std::vector<int>());
+    for (size_t i = 0; i < instrs.size(); ++i)
+    {
+        for (VariableExpr *use : instrs[i].uses)
+        {
+            int value = useValue(use);
+            if (value >= 0)
+            {
+                valueUsers[value].push_back(static_cast<int>(i));
+            }
+        }
+        for (int value : instrs[i].args)
+        {
+            if (value >= 0)
+            {
+                valueUsers[value].push_back(static_cast<int>(i));
+            }
+        }
+    }
+}
+
+int SsaFunction::useValue(const AstNode *var) const
+{
+    auto it = useValues.find(var);
+    return it == useValues.end() ? -1 : it->second;
+}
+
+int SsaFunction::branchOf(const AstNode *stmt) const
+{
+    auto it = branches.find(stmt);
+    return it == branches.end() ? -1 : it->second;
+}
+
+// Una variable pasada por referencia puede cambiar en cualquier llamada
+void SsaFunction::markAddressTaken(AstNode *node)
+{
+    if (!node)
+    {
+        return;
+    }
+    if (FunctionCallExpr *call = dynamic_cast<FunctionCallExpr *>(node))
+    {
+        const std::vector<AstNode *> &args = call->getArguments();
+        for (size_t i = 0; i < args.size(); ++i)
+        {
+            VariableExpr *var = dynamic_cast<VariableExpr *>(args[i]);
+            if (var && SymbolTable::isReferenceParam(call->getCalleeId(), i) &&
+                var->getVarRef().function == functionId)
+            {
+                size_t slot = static_cast<size_t>(var->getVarRef().slot);
+                if (slot >= addressTaken.size())
+                {
+                    addressTaken.resize(slot + 1, false);
+                }
+                addressTaken[slot] = true;
+            }
+        }
+    }
+    node->forEachChild([&](AstNode *&child)
+    {
+        markAddressTaken(child);
+    });
+}
+
+int SsaFunction::trackedVar(VarRef ref)
+{
+    if (ref.function != functionId || ref.slot < 0)
+    {
+        return -1;
+    }
+    size_t slot = static_cast<size_t>(ref.slot);
+    if (slot >= tracked.size())
+    {
+        tracked.resize(slot + 1, UNDECIDED);
+    }
+    if (tracked[slot] == UNDECIDED)
+    {
+        bool taken = slot < addressTaken.size() && addressTaken[slot];
+        bool scalar = !SymbolTable::isReference(ref) && SymbolTable::getArraySize(ref) == 0;
+        tracked[slot] = scalar && !taken ? varCount++ : -1;
+    }
+    return tracked[slot];
+}
+
+int SsaFunction::newBlock()
+{
+    blocks.push_back(SsaBlock());
+    return static_cast<int>(blocks.size() - 1);
+}
+
+void SsaFunction::addEdge(int from, int to)
+{
+    blocks[from].succs.push_back(to);
+    blocks[to].preds.push_back(from);
+}
+
+int SsaFunction::addInstr(int block, SsaInstr::Kind kind, int var, AstNode *expr)
+{
+    SsaInstr instr;
+    instr.kind = kind;
+    instr.block = block;
+    instr.var = var;
+    instr.expr = expr;
+    collectUses(expr, instr.uses);
+    instrs.push_back(instr);
+
+    int index = static_cast<int>(instrs.size() - 1);
+    blocks[block].instrs.push_back(index);
+    if (kind == SsaInstr::BRANCH)
+    {
+        blocks[block].branch = index;
+    }
+    return index;
+}
+
+void SsaFunction::collectUses(AstNode *node, std::vector<VariableExpr *> &uses)
+{
+    if (!node)
+    {
+        return;
+    }
+    if (VariableExpr *var = dynamic_cast<VariableExpr *>(node))
+    {
+        if (trackedVar(var->getVarRef()) >= 0)
+        {
+            uses.push_back(var);
+        }
+        return;
+    }
+    node->forEachChild([&](AstNode *&child)
+    {
+        collectUses(child, uses);
+    });
+}
+
+// Agrega stmt al final del bloque current y devuelve el bloque donde sigue
+// el flujo, o -1 si la sentencia no continúa (return)
+int SsaFunction::buildStatement(AstNode *stmt, int current)
+{
+    if (!stmt)
+    {
+        return current;
+    }
+    // Lo que sigue a un return queda en un bloque sin predecesores
+    if (current < 0)
+    {
+        current = newBlock();
+    }
+
+    if (ExprList *list = dynamic_cast<ExprList *>(stmt))
+    {
+        for (AstNode *expr : list->getExpressions())
+        {
+            current = buildStatement(expr, current);
+        }
+        return current;
+    }
+    if (AssignExpr *assign = dynamic_cast<AssignExpr *>(stmt))
+    {
+        int var = trackedVar(assign->getVarRef());
+        addInstr(current, var >= 0 ? SsaInstr::ASSIGN : SsaInstr::USE, var, assign->getExpr());
+        return current;
+    }
+    if (CinExpr *cin = dynamic_cast<CinExpr *>(stmt))
+    {
+        int var = trackedVar(cin->getVarRef());
+        if (var >= 0)
+        {
+            addInstr(current, SsaInstr::READ, var, nullptr);
+        }
+        return current;
+    }
+    if (IfStmt *ifStmt = dynamic_cast<IfStmt *>(stmt))
+    {
+        branches[stmt] = addInstr(current, SsaInstr::BRANCH, -1, ifStmt->getCondition());
+        int thenBlock = newBlock();
+        addEdge(current, thenBlock);
+        int elseBlock = -1;
+        if (ifStmt->getElseBody())
+        {
+            elseBlock = newBlock();
+            addEdge(current, elseBlock);
+        }
+
+        int thenEnd = buildStatement(ifStmt->getIfBody(), thenBlock);
+        int elseEnd = elseBlock >= 0 ? buildStatement(ifStmt->getElseBody(), elseBlock) : -1;
+        int join = newBlock();
+        if (elseBlock < 0)
+        {
+            addEdge(current, join);
+        }
+        if (thenEnd >= 0)
+        {
+            addEdge(thenEnd, join);
+        }
+        if (elseEnd >= 0)
+        {
+            addEdge(elseEnd, join);
+        }
+        return join;
+    }
+    if (WhileStmt *whileStmt = dynamic_cast<WhileStmt *>(stmt))
+    {
+        int header = newBlock();
+        addEdge(current, header);
+        branches[stmt] = addInstr(header, SsaInstr::BRANCH, -1, whileStmt->getCondition());
+        int body = newBlock();
+        addEdge(header, body);
+        int bodyEnd = buildStatement(whileStmt->getBody(), body);
+        if (bodyEnd >= 0)
+        {
+            addEdge(bodyEnd, header);
+        }
+        int exit = newBlock();
+        addEdge(header, exit);
+        return exit;
+    }
+    if (ReturnStmt *ret = dynamic_cast<ReturnStmt *>(stmt))
+    {
+        addInstr(current, SsaInstr::USE, -1, ret->getExpr());
+        return -1;
+    }
+    if (dynamic_cast<VarDeclExpr *>(stmt))
+    {
+        return current;
+    }
+
+    addInstr(current, SsaInstr::USE, -1, stmt);
+    return current;
+}
+
+// Los bloques inalcanzables desde la entrada no aparecen en el orden
+std::vector<int> SsaFunction::reversePostorder() const
+{
+    std::vector<int> order;
+    std::vector<bool> visited(blocks.size(), false);
+    std::vector<std::pair<int, size_t>> pending;
+    pending.push_back({ENTRY_BLOCK, 0});
+    visited[ENTRY_BLOCK] = true;
+
+    while (!pending.empty())
+    {
+        int block = pending.back().first;
+        size_t next = pending.back().second;
+        if (next < blocks[block].succs.size())
+        {
+            ++pending.back().second;
+            int succ = blocks[block].succs[next];
+            if (!visited[succ])
+            {
+                visited[succ] = true;
+                pending.push_back({succ, 0});
+            }
+        }
+        else
+        {
+            order.push_back(block);
+            pending.pop_back();
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+// Dominador inmediato de cada bloque (Cooper, Harvey y Kennedy); -1 en los
+// bloques inalcanzables
+std::vector<int> SsaFunction::dominators(const std::vector<int> &order) const
+{
+    std::vector<int> position(blocks.size(), -1);
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        position[order[i]] = static_cast<int>(i);
+    }
+
+    std::vector<int> idom(blocks.size(), -1);
+    idom[ENTRY_BLOCK] = ENTRY_BLOCK;
+    auto intersect = [&](int a, int b)
+    {
+        while (a != b)
+        {
+            while (position[a] > position[b])
+            {
+                a = idom[a];
+            }
+            while (position[b] > position[a])
+            {
+                b = idom[b];
+            }
+        }
+        return a;
+    };
+
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (size_t i = 1; i < order.size(); ++i)
+        {
+            int block = order[i];
+            int newIdom = -1;
+            for (int pred : blocks[block].preds)
+            {
+                if (idom[pred] < 0)
+                {
+                    continue;
+                }
+                newIdom = newIdom < 0 ? pred : intersect(pred, newIdom);
+            }
+            if (newIdom != idom[block])
+            {
+                idom[block] = newIdom;
+                changed = true;
+            }
+        }
+    }
+    return idom;
+}
+
+// Inserta las funciones phi en la frontera de dominancia iterada de las
+// definiciones de cada variable
+void SsaFunction::placePhis(const std::vector<int> &idom, const std::vector<int> &order)
+{
+    std::vector<std::vector<int>> frontier(blocks.size());
+    for (int block : order)
+    {
+        int reachablePreds = 0;
+        for (int pred : blocks[block].preds)
+        {
+            reachablePreds += idom[pred] >= 0 ? 1 : 0;
+        }
+        if (reachablePreds < 2)
+        {
+            continue;
+        }
+        for (int pred : blocks[block].preds)
+        {
+            for (int runner = pred; idom[pred] >= 0 && runner != idom[block]; runner = idom[runner])
+            {
+                std::vector<int> &df = frontier[runner];
+                if (df.empty() || df.back() != block)
+                {
+                    df.push_back(block);
+                }
+            }
+        }
+    }
+
+    std::vector<std::vector<int>> defSites(varCount);
+    for (int block : order)
+    {
+        for (int index : blocks[block].instrs)
+        {
+            const SsaInstr &instr = instrs[index];
+            if (instr.var >= 0 && (defSites[instr.var].empty() || defSites[instr.var].back() != block))
+            {
+                defSites[instr.var].push_back(block);
+            }
+        }
+    }
+
+    std::vector<int> hasPhi(blocks.size(), -1);
+    std::vector<int> queued(blocks.size(), -1);
+    std::vector<std::vector<int>> phis(blocks.size());
+    for (int var = 0; var < varCount; ++var)
+    {
+        std::vector<int> pending = defSites[var];
+        for (int block : pending)
+        {
+            queued[block] = var;
+        }
+        while (!pending.empty())
+        {
+            int block = pending.back();
+            pending.pop_back();
+            for (int join : frontier[block])
+            {
+                if (hasPhi[join] == var)
+                {
+                    continue;
+                }
+                hasPhi[join] = var;
+
+                SsaInstr phi;
+                phi.kind = SsaInstr::PHI;
+                phi.block = join;
+                phi.var = var;
+                phi.args.assign(blocks[join].preds.size(), -1);
+                instrs.push_back(phi);
+                phis[join].push_back(static_cast<int>(instrs.size() - 1));
+
+                if (queued[join] != var)
+                {
+                    queued[join] = var;
+                    pending.push_back(join);
+                }
+            }
+        }
+    }
+
+    for (int block : order)
+    {
+        std::vector<int> &blockInstrs = blocks[block].instrs;
+        blockInstrs.insert(blockInstrs.begin(), phis[block].begin(), phis[block].end());
+    }
+}
+
+// Numera los valores recorriendo el árbol de dominadores con una pila
+// explícita; cada variable tiene la pila de sus definiciones visibles
+void SsaFunction::rename(const std::vector<int> &idom, const std::vector<int> &order)
+{
+    std::vector<std::vector<int>> children(blocks.size());
+    for (int block : order)
+    {
+        if (block != ENTRY_BLOCK)
+        {
+            children[idom[block]].push_back(block);
+        }
+    }
+
+    std::vector<std::vector<int>> stacks(varCount);
+    std::vector<std::vector<int>> pushed(blocks.size());
+    std::vector<std::pair<int, bool>> pending;
+    pending.push_back({ENTRY_BLOCK, false});
+
+    while (!pending.empty())
+    {
+        int block = pending.back().first;
+        bool leaving = pending.back().second;
+        pending.pop_back();
+
+        if (leaving)
+        {
+            for (int var : pushed[block])
+            {
+                stacks[var].pop_back();
+            }
+            continue;
+        }
+
+        for (int index : blocks[block].instrs)
+        {
+            SsaInstr &instr = instrs[index];
+            for (VariableExpr *use : instr.uses)
+            {
+                useValues[use] = stacks[trackedVar(use->getVarRef())].back();
+            }
+            if (instr.var >= 0)
+            {
+                instr.value = static_cast<int>(valueDefs.size());
+                valueDefs.push_back(index);
+                stacks[instr.var].push_back(instr.value);
+                pushed[block].push_back(instr.var);
+            }
+        }
+
+        for (int succ : blocks[block].succs)
+        {
+            const std::vector<int> &preds = blocks[succ].preds;
+            size_t j = std::find(preds.begin(), preds.end(), block) - preds.begin();
+            for (int index : blocks[succ].instrs)
+            {
+                SsaInstr &phi = instrs[index];
+                if (phi.kind != SsaInstr::PHI)
+                {
+                    break;
+                }
+                phi.args[j] = stacks[phi.var].back();
+            }
+        }
+
+        pending.push_back({block, true});
+        for (int child : children[block])
+        {
+            pending.push_back({child, false});
+        }
+    }
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+#include "Ast.hpp"
+
+// Instrucción del grafo en SSA. Solo se representan las variables escalares
+// locales que nadie más puede modificar (sin referencias, arreglos ni
+// variables pasadas por referencia); el resto del cuerpo aparece como USE,
+// que solo registra las lecturas de esas variables.
+struct SsaInstr
+{
+    enum Kind
+    {
+        PHI,    // une el valor de var que llega por cada predecesor
+        ENTRY,  // valor de var al entrar a la función
+        ASSIGN, // var = expr
+        READ,   // std::cin >> var
+        USE,    // sentencia que solo lee variables
+        BRANCH  // condición del if o while que termina el bloque
+    };
+
+    Kind kind;
+    int block;
+    int var = -1;
+    int value = -1;
+    AstNode *expr = nullptr;
+    std::vector<VariableExpr *> uses;
+    std::vector<int> args; // PHI: valor por cada predecesor, en el orden de preds
+};
+
+// Con BRANCH al final, succs[0] es el camino verdadero y succs[1] el falso
+struct SsaBlock
+{
+    std::vector<int> preds;
+    std::vector<int> succs;
+    std::vector<int> instrs;
+    int branch = -1;
+};
+
+// Grafo de flujo de una función en forma SSA, construido a partir de las
+// sentencias estructuradas (if, while, return) con fronteras de dominancia.
+// Los nodos del AST siguen siendo del árbol; aquí solo se apuntan.
+class SsaFunction
+{
+public:
+    explicit SsaFunction(FunctionDeclExpr *func);
+
+    const std::vector<SsaBlock> &getBlocks() const { return blocks; }
+    const std::vector<SsaInstr> &getInstrs() const { return instrs; }
+    int getValueCount() const { return static_cast<int>(valueDefs.size()); }
+    const std::vector<int> &getUsers(int value) const { return valueUsers[value]; }
+
+    // Valor SSA que lee una VariableExpr, o -1 si no es una variable seguida
+    // o está en código inalcanzable
+    int useValue(const AstNode *var) const;
+
+    // Instrucción BRANCH de un IfStmt o WhileStmt, o -1
+    int branchOf(const AstNode *stmt) const;
+
+    static constexpr int ENTRY_BLOCK = 0;
+
+private:
+    int functionId;
+    std::vector<SsaBlock> blocks;
+    std::vector<SsaInstr> instrs;
+    std::vector<int> tracked; // slot de la función -> índice de variable, o -1
+    std::vector<bool> addressTaken;
+    int varCount = 0;
+    std::vector<int> valueDefs;
+    std::vector<std::vector<int>> valueUsers;
+    std::unordered_map<const AstNode *, int> useValues;
+    std::unordered_map<const AstNode *, int> branches;
+
+    void markAddressTaken(AstNode *node);
+    int trackedVar(VarRef ref);
+
+    int newBlock();
+    void addEdge(int from, int to);
+    int addInstr(int block, SsaInstr::Kind kind, int var, AstNode *expr);
+    void collectUses(AstNode *node, std::vector<VariableExpr *> &uses);
+
+    int buildStatement(AstNode *stmt, int current);
+
+    void placePhis(const std::vector<int> &idom, const std::vector<int> &order);
+    void rename(const std::vector<int> &idom, const std::vector<int> &order);
+    std::vector<int> reversePostorder() const;
+    std::vector<int> dominators(const std::vector<int> &order) const;
+};
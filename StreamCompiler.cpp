@@ -0,0 +1,93 @@
+#include "StreamCompiler.hpp"
+#include "BoundsCheck.hpp"
+#include "Sccp.hpp"
+#include "StrengthReduction.hpp"
+
+StreamCompiler::~StreamCompiler()
+{
+    for (FunctionDeclExpr *func : waiting)
+    {
+        delete func;
+    }
+}
+
+void StreamCompiler::run(Parser &parser)
+{
+    runtimeUsage() = RuntimeUsage();
+    profileSites().clear();
+
+    if (fillDelaySlots)
+    {
+        out << ".set noreorder\n";
+    }
+    emit(".text\njal main\nj " + std::string(EXIT_LABEL) + "\n");
+
+    parser.setFunctionHandler([this](FunctionDeclExpr *func)
+    {
+        addFunction(func);
+    });
+    ProgramNode *program = parser.parse();
+    parser.setFunctionHandler(nullptr);
+
+    // Los globales y las cadenas se conocen hasta aquí, así que .data va al final
+    analyzer.finish(program);
+    emit(std::string(EXIT_LABEL) + ":\n" + ProgramNode::exitCode() + ProgramNode::supportCode());
+    out << ProgramNode::dataCode(program->getGlobals());
+    delete program;
+}
+
+// Revisa y numera la función en el orden del archivo, como sin --stream, y
+// compila todas las que ya no esperan a ninguna otra
+void StreamCompiler::addFunction(FunctionDeclExpr *func)
+{
+    waiting.push_back(func);
+    analyzer.checkFunction(func);
+
+    if (codeGenOptions().instrument || profile)
+    {
+        int first = static_cast<int>(profileSites().size());
+        numbering.number(func);
+        if (profile)
+        {
+            profile->apply(first);
+        }
+    }
+
+    for (auto it = waiting.begin(); it != waiting.end();)
+    {
+        if (analyzer.hasForwardCalls((*it)->getName()))
+        {
+            ++it;
+            continue;
+        }
+        FunctionDeclExpr *ready = *it;
+        it = waiting.erase(it);
+        compileFunction(ready);
+    }
+}
+
+void StreamCompiler::compileFunction(FunctionDeclExpr *func)
+{
+    // La unidad es dueña de la función y la libera al salir, también con errores
+    ProgramNode unit;
+    unit.addFunction(func);
+
+    ConstantPropagator propagator;
+    propagator.run(&unit);
+
+    if (codeGenOptions().boundsCheck)
+    {
+        BoundsCheckEliminator eliminator;
+        eliminator.run(&unit);
+    }
+
+    InductionVariableReducer reducer;
+    reducer.run(&unit);
+
+    emit(func->generateCode().code);
+}
+
+void StreamCompiler::emit(const std::string &code)
+{
+    out << (schedule ? scheduler.scheduleFragment(code) : code);
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Ast.hpp"
+#include "MiniCppParser.hpp"
+#include "MipsScheduler.hpp"
+#include "Profile.hpp"
+#include "SemanticAnalyzer.hpp"
+
+// Compila a ensamblador MIPS función por función (--stream). El parser entrega
+// cada función en cuanto termina de leerla; se revisa, pasa por las pasadas
+// que solo miran esa función (propagación de constantes, --bounds-check y
+// reducción de variables de inducción), su código se escribe y el árbol se
+// libera. Así la memoria depende de la función más grande y no del programa:
+// del resto solo quedan los globales, las cadenas, los sitios del perfil y la
+// tabla de símbolos. Una función que llama a otra definida más adelante
+// espera (con su árbol) hasta que esa se lee, porque antes no se sabe qué
+// argumentos van por referencia. El inliner y la evaluación de llamadas
+// constantes necesitan los cuerpos de otras funciones, así que en este modo
+// no se usan.
+class StreamCompiler
+{
+public:
+    // mipsModel como en --mips-model; profile puede ser nulo (sin --profile-use)
+    StreamCompiler(std::ostream &out, const std::string &mipsModel, ProfileLoader *profile)
+        : out(out), scheduler(mipsModel == "delayed"), schedule(mipsModel != "spim"),
+          fillDelaySlots(mipsModel == "delayed"), profile(profile) {}
+    ~StreamCompiler();
+
+    void run(Parser &parser);
+
+private:
+    // main regresa a la salida del programa, que se escribe al final
+    static constexpr const char *EXIT_LABEL = "__program_exit";
+
+    std::ostream &out;
+    MipsScheduler scheduler;
+    bool schedule;
+    bool fillDelaySlots;
+    ProfileLoader *profile;
+    SemanticAnalyzer analyzer;
+    ProfileNumbering numbering;
+    std::vector<FunctionDeclExpr *> waiting; // revisadas, con llamadas a funciones aún no definidas
+
+    void addFunction(FunctionDeclExpr *func);
+    void compileFunction(FunctionDeclExpr *func);
+    void emit(const std::string &code);
+};
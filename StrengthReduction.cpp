@@ -0,0 +1,242 @@
+#include "StrengthReduction.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+void InductionVariableReducer::run(ProgramNode *program)
+{
+    for (AstNode *node : program->getFunctions())
+    {
+        FunctionDeclExpr *func = static_cast<FunctionDeclExpr *>(node);
+        for (AstNode *stmt : func->getStatements())
+        {
+            visit(stmt);
+        }
+    }
+}
+
+void InductionVariableReducer::visit(AstNode *node)
+{
+    if (!node)
+    {
+        return;
+    }
+    if (WhileStmt *loop = dynamic_cast<WhileStmt *>(node))
+    {
+        analyzeLoop(loop);
+    }
+    node->forEachChild([&](AstNode *&child)
+    {
+        visit(child);
+    });
+}
+
+// El contador es el primer `i = i + c` del cuerpo (no anidado en un if o
+// while) cuya variable no se escribe en ningún otro lugar del ciclo
+void InductionVariableReducer::analyzeLoop(WhileStmt *loop)
+{
+    ExprList *body = dynamic_cast<ExprList *>(loop->getBody());
+    if (!body)
+    {
+        return;
+    }
+
+    for (AstNode *stmt : body->getExpressions())
+    {
+        AssignExpr *assign = dynamic_cast<AssignExpr *>(stmt);
+        InductionPlan plan;
+        if (!assign || !isScalarLocal(assign->getVarRef()) || !isStep(assign, plan.step))
+        {
+            continue;
+        }
+        plan.counter = assign->getVarRef();
+        plan.increment = stmt;
+        if (writes(body, plan.counter) != 1)
+        {
+            continue;
+        }
+
+        std::vector<ArrayAccess *> accesses;
+        collectAccesses(loop->getCondition(), plan.counter, accesses);
+        collectAccesses(body, plan.counter, accesses);
+        int reduced = 0;
+        for (ArrayAccess *access : accesses)
+        {
+            bool known = std::find(plan.arrays.begin(), plan.arrays.end(), access->getVarRef()) != plan.arrays.end();
+            if (!known && plan.arrays.size() < MAX_POINTERS)
+            {
+                plan.arrays.push_back(access->getVarRef());
+                known = true;
+            }
+            reduced += known ? 1 : 0;
+        }
+        if (plan.arrays.empty())
+        {
+            continue;
+        }
+
+        // Las únicas lecturas del contador deben ser el incremento, los
+        // accesos reducidos y la condición
+        int expected = 1 + reduced;
+        if (isBound(loop->getCondition(), plan.counter, plan.bound, plan.inclusive))
+        {
+            VariableExpr *var = dynamic_cast<VariableExpr *>(plan.bound);
+            bool invariant = dynamic_cast<ValueExpr *>(plan.bound) ||
+                             (var && isScalarLocal(var->getVarRef()) && writes(body, var->getVarRef()) == 0);
+            if (invariant)
+            {
+                expected += 1;
+            }
+            else
+            {
+                plan.bound = nullptr;
+            }
+        }
+        int uses = reads(loop->getCondition(), plan.counter) + reads(body, plan.counter);
+        plan.eliminateCounter = plan.bound && uses == expected;
+
+        loop->setInduction(plan);
+        return;
+    }
+}
+
+// i = i + c, i = c + i o i = i - c. El paso en bytes debe caber en un addi
+bool InductionVariableReducer::isStep(AssignExpr *assign, int &step) const
+{
+    BinaryExpr *binary = dynamic_cast<BinaryExpr *>(assign->getExpr());
+    bool add = dynamic_cast<AddExpr *>(binary) != nullptr;
+    if (!binary || (!add && !dynamic_cast<SubExpr *>(binary)))
+    {
+        return false;
+    }
+
+    VariableExpr *var = dynamic_cast<VariableExpr *>(binary->getLeft());
+    ValueExpr *constant = dynamic_cast<ValueExpr *>(binary->getRight());
+    if (add && !var)
+    {
+        var = dynamic_cast<VariableExpr *>(binary->getRight());
+        constant = dynamic_cast<ValueExpr *>(binary->getLeft());
+    }
+    if (!var || !constant || !(var->getVarRef() == assign->getVarRef()))
+    {
+        return false;
+    }
+
+    step = static_cast<int>(constant->getValue());
+    if (!add)
+    {
+        step = -step;
+    }
+    return step != 0 && std::abs(step) <= 8191;
+}
+
+// i < n, i <= n, n > i o n >= i
+bool InductionVariableReducer::isBound(AstNode *condition, VarRef counter, AstNode *&bound, bool &inclusive) const
+{
+    BinaryExpr *compare = dynamic_cast<BinaryExpr *>(condition);
+    if (!compare)
+    {
+        return false;
+    }
+    AstNode *counterSide;
+    if (dynamic_cast<LessExpr *>(compare) || dynamic_cast<LessEqualExpr *>(compare))
+    {
+        counterSide = compare->getLeft();
+        bound = compare->getRight();
+        inclusive = dynamic_cast<LessEqualExpr *>(compare) != nullptr;
+    }
+    else if (dynamic_cast<GreaterExpr *>(compare) || dynamic_cast<GreaterEqualExpr *>(compare))
+    {
+        counterSide = compare->getRight();
+        bound = compare->getLeft();
+        inclusive = dynamic_cast<GreaterEqualExpr *>(compare) != nullptr;
+    }
+    else
+    {
+        return false;
+    }
+
+    VariableExpr *var = dynamic_cast<VariableExpr *>(counterSide);
+    if (!var || !(var->getVarRef() == counter))
+    {
+        bound = nullptr;
+        return false;
+    }
+    return true;
+}
+
+// a[counter] sin comprobación de rango en tiempo de ejecución
+void InductionVariableReducer::collectAccesses(AstNode *node, VarRef counter, std::vector<ArrayAccess *> &accesses) const
+{
+    if (!node)
+    {
+        return;
+    }
+    if (ArrayAccess *access = dynamic_cast<ArrayAccess *>(node))
+    {
+        VariableExpr *index = dynamic_cast<VariableExpr *>(access->getIndex());
+        if (index && index->getVarRef() == counter && !access->needsBoundsCheck())
+        {
+            accesses.push_back(access);
+        }
+    }
+    node->forEachChild([&](AstNode *&child)
+    {
+        collectAccesses(child, counter, accesses);
+    });
+}
+
+bool InductionVariableReducer::isScalarLocal(VarRef ref)
+{
+    return ref.isValid() && !SymbolTable::isGlobal(ref) && !SymbolTable::isReference(ref) &&
+           SymbolTable::getArraySize(ref) == 0;
+}
+
+// Asignaciones, lecturas con cin y pasos por referencia a una llamada
+int InductionVariableReducer::writes(AstNode *node, VarRef var)
+{
+    if (!node)
+    {
+        return 0;
+    }
+    int count = 0;
+    if (AssignExpr *assign = dynamic_cast<AssignExpr *>(node))
+    {
+        count += assign->getVarRef() == var ? 1 : 0;
+    }
+    else if (CinExpr *cin = dynamic_cast<CinExpr *>(node))
+    {
+        count += cin->getVarRef() == var ? 1 : 0;
+    }
+    else if (FunctionCallExpr *call = dynamic_cast<FunctionCallExpr *>(node))
+    {
+        const std::vector<AstNode *> &args = call->getArguments();
+        for (size_t i = 0; i < args.size(); ++i)
+        {
+            VariableExpr *arg = dynamic_cast<VariableExpr *>(args[i]);
+            if (arg && arg->getVarRef() == var && SymbolTable::isReferenceParam(call->getCalleeId(), i))
+            {
+                ++count;
+            }
+        }
+    }
+    node->forEachChild([&](AstNode *&child)
+    {
+        count += writes(child, var);
+    });
+    return count;
+}
+
+int InductionVariableReducer::reads(AstNode *node, VarRef var)
+{
+    if (!node)
+    {
+        return 0;
+    }
+    VariableExpr *read = dynamic_cast<VariableExpr *>(node);
+    int count = read && read->getVarRef() == var ? 1 : 0;
+    node->forEachChild([&](AstNode *&child)
+    {
+        count += reads(child, var);
+    });
+    return count;
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include <vector>
+#include "Ast.hpp"
+
+// Reducción de fuerza de variables de inducción para el backend MIPS. En un
+// while cuyo cuerpo incrementa un contador local con `i = i + c` y accede a
+// a[i], el acceso deja de calcular i * 4 + base en cada iteración: se recorre
+// con un puntero que avanza junto con i. Si i solo se usa para esos accesos,
+// el incremento y la condición i < n, el contador deja de actualizarse dentro
+// del ciclo. La pasada solo deja el plan en cada WhileStmt; el código lo
+// genera WhileStmt::generateCode.
+class InductionVariableReducer
+{
+public:
+    void run(ProgramNode *program);
+
+private:
+    // Hasta cuántos arreglos se recorren con punteros en un mismo ciclo
+    static const int MAX_POINTERS = 3;
+
+    void visit(AstNode *node);
+    void analyzeLoop(WhileStmt *loop);
+
+    bool isStep(AssignExpr *assign, int &step) const;
+    bool isBound(AstNode *condition, VarRef counter, AstNode *&bound, bool &inclusive) const;
+    void collectAccesses(AstNode *node, VarRef counter, std::vector<ArrayAccess *> &accesses) const;
+
+    static bool isScalarLocal(VarRef ref);
+    static int writes(AstNode *node, VarRef var);
+    static int reads(AstNode *node, VarRef var);
+};
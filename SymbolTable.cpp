@@ -1,62 +1,273 @@
 #include "SymbolTable.hpp"
+#include <algorithm>
 #include <stdexcept>
 
-std::unordered_map<std::string, std::unordered_map<std::string, int>> SymbolTable::symbolTable;
-std::unordered_map<std::string, std::unordered_map<std::string, double>> SymbolTable::variableValues;
-int SymbolTable::currentOffset = 0;
+std::unordered_map<std::string, int> SymbolTable::nameIds;
+std::unordered_map<std::string, int> SymbolTable::functionIds = {{"", SymbolTable::GLOBAL_SCOPE}};
+std::vector<SymbolTable::FunctionInfo> SymbolTable::functions(1);
 
-void SymbolTable::setVarOffset(const std::string &functionName, const std::string &varName)
+void IdMap::insert(int key, int value)
 {
-    if (symbolTable[functionName].find(varName) == symbolTable[functionName].end())
+    if (2 * (count + 1) > keys.size())
+    {
+        grow();
+    }
+    size_t mask = keys.size() - 1;
+    for (size_t i = hash(key) & mask;; i = (i + 1) & mask)
     {
-        symbolTable[functionName][varName] = currentOffset;
-        currentOffset += 4;
+        if (keys[i] == key)
+        {
+            values[i] = value;
+            return;
+        }
+        if (keys[i] < 0)
+        {
+            keys[i] = key;
+            values[i] = value;
+            ++count;
+            return;
+        }
     }
 }
 
-int SymbolTable::getVarOffset(const std::string &functionName, const std::string &varName)
+void IdMap::grow()
 {
-    auto funcIt = symbolTable.find(functionName);
-    if (funcIt != symbolTable.end())
+    std::vector<int> oldKeys;
+    std::vector<int> oldValues;
+    oldKeys.swap(keys);
+    oldValues.swap(values);
+
+    size_t capacity = std::max<size_t>(16, 2 * oldKeys.size());
+    keys.assign(capacity, -1);
+    values.assign(capacity, -1);
+    count = 0;
+    for (size_t i = 0; i < oldKeys.size(); ++i)
     {
-        auto varIt = funcIt->second.find(varName);
-        if (varIt != funcIt->second.end())
-        {
-            return varIt->second;
-        }
-        else
+        if (oldKeys[i] >= 0)
         {
-            throw std::runtime_error("Variable not found: " + varName);
+            insert(oldKeys[i], oldValues[i]);
         }
     }
-    else
+}
+
+int SymbolTable::internName(const std::string &name)
+{
+    auto it = nameIds.emplace(name, static_cast<int>(nameIds.size())).first;
+    return it->second;
+}
+
+int SymbolTable::functionId(const std::string &functionName)
+{
+    auto it = functionIds.find(functionName);
+    if (it != functionIds.end())
     {
-        throw std::runtime_error("Function not found: " + functionName);
+        return it->second;
     }
+    int id = static_cast<int>(functions.size());
+    functions.emplace_back();
+    functions.back().name = functionName;
+    functionIds.emplace(functionName, id);
+    return id;
+}
+
+int SymbolTable::addVar(FunctionInfo &function, int nameId, const std::string &varName)
+{
+    int slot = static_cast<int>(function.vars.size());
+    function.vars.emplace_back();
+    function.vars.back().name = varName;
+    function.scopeOf.push_back(static_cast<int>(function.scopes.size()));
+    function.names.insert(nameId, slot);
+    return slot;
 }
 
-double SymbolTable::getVarValue(const std::string &functionName, const std::string &varName)
+VarRef SymbolTable::resolve(const std::string &functionName, const std::string &varName)
 {
-    auto funcIt = variableValues.find(functionName);
-    if (funcIt != variableValues.end())
+    int id = functionId(functionName);
+    int nameId = internName(varName);
+
+    int slot = functions[id].names.find(nameId);
+    if (slot >= 0)
     {
-        auto varIt = funcIt->second.find(varName);
-        if (varIt != funcIt->second.end())
-        {
-            return varIt->second;
-        }
-        else
-        {
-            throw std::runtime_error("Variable value not found: " + varName);
-        }
+        return {id, slot};
+    }
+    int global = functions[GLOBAL_SCOPE].names.find(nameId);
+    if (global >= 0)
+    {
+        return {GLOBAL_SCOPE, global};
     }
-    else
+    return {id, addVar(functions[id], nameId, varName)};
+}
+
+VarRef SymbolTable::declare(const std::string &functionName, const std::string &varName)
+{
+    int id = functionId(functionName);
+    int nameId = internName(varName);
+    FunctionInfo &function = functions[id];
+
+    int slot = function.names.find(nameId);
+    int depth = static_cast<int>(function.scopes.size());
+    if (slot >= 0 && function.scopeOf[slot] == depth)
+    {
+        return {id, slot};
+    }
+
+    // Una declaración en un bloque oculta la del ámbito exterior hasta su cierre
+    if (depth > 0)
+    {
+        function.scopes.back().emplace_back(nameId, slot);
+    }
+    return {id, addVar(function, nameId, varName)};
+}
+
+VarRef SymbolTable::findGlobal(const std::string &varName)
+{
+    int slot = lookup("", varName);
+    return slot >= 0 ? VarRef{GLOBAL_SCOPE, slot} : VarRef{};
+}
+
+void SymbolTable::enterScope(const std::string &functionName)
+{
+    functions[functionId(functionName)].scopes.emplace_back();
+}
+
+void SymbolTable::exitScope(const std::string &functionName)
+{
+    FunctionInfo &function = functions[functionId(functionName)];
+    if (function.scopes.empty())
+    {
+        throw std::runtime_error("Unbalanced scope in function " + functionName);
+    }
+    for (const auto &hidden : function.scopes.back())
+    {
+        function.names.insert(hidden.first, hidden.second);
+    }
+    function.scopes.pop_back();
+}
+
+void SymbolTable::allocate(VarRef ref, int arraySize)
+{
+    FunctionInfo &function = functions[ref.function];
+    VarInfo &info = function.vars[ref.slot];
+    if (ref.function != GLOBAL_SCOPE && info.offset < 0)
+    {
+        info.offset = function.localsSize;
+        function.localsSize += 4 * std::max(arraySize, 1);
+    }
+    if (arraySize > 0)
+    {
+        info.arraySize = arraySize;
+    }
+}
+
+int SymbolTable::getVarOffset(VarRef ref)
+{
+    const VarInfo &info = variable(ref);
+    if (info.offset < 0)
+    {
+        throw std::runtime_error("Variable not found: " + info.name);
+    }
+    return functions[ref.function].frameBase + info.offset;
+}
+
+void SymbolTable::declareFunction(const std::string &functionName, const std::vector<bool> &params)
+{
+    functions[functionId(functionName)].referenceParams = params;
+}
+
+bool SymbolTable::isReferenceParam(int functionId, size_t index)
+{
+    const std::vector<bool> &params = functions[functionId].referenceParams;
+    return index < params.size() && params[index];
+}
+
+// Variable con ese nombre visible en la función (sin mirar los globales)
+int SymbolTable::lookup(const std::string &functionName, const std::string &varName)
+{
+    auto funcIt = functionIds.find(functionName);
+    auto nameIt = nameIds.find(varName);
+    if (funcIt == functionIds.end() || nameIt == nameIds.end())
+    {
+        return -1;
+    }
+    return functions[funcIt->second].names.find(nameIt->second);
+}
+
+void SymbolTable::setVarOffset(const std::string &functionName, const std::string &varName)
+{
+    allocate(declare(functionName, varName));
+}
+
+int SymbolTable::getVarOffset(const std::string &functionName, const std::string &varName)
+{
+    auto funcIt = functionIds.find(functionName);
+    if (funcIt == functionIds.end())
     {
         throw std::runtime_error("Function not found: " + functionName);
     }
+    int slot = lookup(functionName, varName);
+    if (slot < 0)
+    {
+        throw std::runtime_error("Variable not found: " + varName);
+    }
+    return getVarOffset(VarRef{funcIt->second, slot});
 }
 
-void SymbolTable::setVarValue(const std::string &functionName, const std::string &varName, double value)
+void SymbolTable::setVarReference(const std::string &functionName, const std::string &varName)
 {
-    variableValues[functionName][varName] = value;
+    VarRef ref = declare(functionName, varName);
+    functions[ref.function].vars[ref.slot].reference = true;
+}
+
+bool SymbolTable::isReference(const std::string &functionName, const std::string &varName)
+{
+    int slot = lookup(functionName, varName);
+    return slot >= 0 && functions[functionIds.at(functionName)].vars[slot].reference;
+}
+
+bool SymbolTable::isReferenceParam(const std::string &functionName, size_t index)
+{
+    auto funcIt = functionIds.find(functionName);
+    return funcIt != functionIds.end() && isReferenceParam(funcIt->second, index);
+}
+
+int SymbolTable::getLocalsSize(const std::string &functionName)
+{
+    auto funcIt = functionIds.find(functionName);
+    return funcIt != functionIds.end() ? functions[funcIt->second].localsSize : 0;
+}
+
+void SymbolTable::declareArray(const std::string &functionName, const std::string &varName, int size)
+{
+    allocate(declare(functionName, varName), size);
+}
+
+void SymbolTable::declareGlobal(const std::string &varName, int size)
+{
+    allocate(declare("", varName), size);
+}
+
+// Un local solo cuenta si tiene espacio reservado en el marco
+bool SymbolTable::isLocal(const std::string &functionName, const std::string &varName)
+{
+    if (functionName.empty())
+    {
+        return false;
+    }
+    int slot = lookup(functionName, varName);
+    return slot >= 0 && functions[functionIds.at(functionName)].vars[slot].offset >= 0;
+}
+
+bool SymbolTable::isGlobal(const std::string &functionName, const std::string &varName)
+{
+    return !isLocal(functionName, varName) && lookup("", varName) >= 0;
+}
+
+int SymbolTable::getArraySize(const std::string &functionName, const std::string &varName)
+{
+    if (isLocal(functionName, varName))
+    {
+        return functions[functionIds.at(functionName)].vars[lookup(functionName, varName)].arraySize;
+    }
+    int global = lookup("", varName);
+    return global >= 0 ? functions[GLOBAL_SCOPE].vars[global].arraySize : 0;
 }
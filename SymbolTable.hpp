@@ -1,22 +1,145 @@
 #pragma once
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
+// Tabla hash de direccionamiento abierto (sondeo lineal) de enteros no
+// negativos a enteros. Un valor -1 equivale a una clave ausente.
+class IdMap
+{
+public:
+    int find(int key) const
+    {
+        if (keys.empty())
+        {
+            return -1;
+        }
+        size_t mask = keys.size() - 1;
+        for (size_t i = hash(key) & mask;; i = (i + 1) & mask)
+        {
+            if (keys[i] == key)
+            {
+                return values[i];
+            }
+            if (keys[i] < 0)
+            {
+                return -1;
+            }
+        }
+    }
+
+    void insert(int key, int value);
+
+private:
+    std::vector<int> keys;
+    std::vector<int> values;
+    size_t count = 0;
+
+    static size_t hash(int key) { return static_cast<size_t>(key) * 0x9E3779B1u; }
+    void grow();
+};
+
+// Variable ya resuelta: función dueña (GLOBAL_SCOPE para los globales) y su
+// posición dentro de ella
+struct VarRef
+{
+    int function = -1;
+    int slot = -1;
+
+    bool isValid() const { return slot >= 0; }
+    bool operator==(const VarRef &other) const { return function == other.function && slot == other.slot; }
+};
+
+struct VarInfo
+{
+    std::string name;
+    int offset = -1;    // bytes desde la base de los locales; -1 sin espacio reservado
+    int arraySize = 0;
+    bool reference = false;
+};
+
+// Los nombres se resuelven una vez, al construir los nodos, a un VarRef; la
+// generación de código consulta después por índice sin calcular hashes de
+// cadenas. Cada función guarda sus variables en un vector denso y las asocia
+// a su nombre internado con un IdMap. Los ámbitos de bloque anidados ocultan
+// temporalmente las variables de los ámbitos exteriores de la misma función.
 class SymbolTable
 {
 public:
+    static constexpr int GLOBAL_SCOPE = 0;
+
+    static int internName(const std::string &name);
+    static int functionId(const std::string &functionName);
+    static const std::string &functionName(int functionId) { return functions[functionId].name; }
+
+    // Busca en la función y luego entre los globales; si el nombre no existe
+    // crea un local sin espacio, que un error informa si nunca se declara
+    static VarRef resolve(const std::string &functionName, const std::string &varName);
+    // Local del ámbito actual de la función (o global si functionName es "")
+    static VarRef declare(const std::string &functionName, const std::string &varName);
+    // Global con ese nombre, o un VarRef no válido si no existe
+    static VarRef findGlobal(const std::string &varName);
+
+    static void enterScope(const std::string &functionName);
+    static void exitScope(const std::string &functionName);
+
+    static const VarInfo &variable(VarRef ref) { return functions[ref.function].vars[ref.slot]; }
+    static bool isGlobal(VarRef ref) { return ref.function == GLOBAL_SCOPE; }
+    static bool isReference(VarRef ref) { return variable(ref).reference; }
+    static int getArraySize(VarRef ref) { return variable(ref).arraySize; }
+    static void allocate(VarRef ref, int arraySize = 0);
+    static int getVarOffset(VarRef ref);
+    static std::string getGlobalLabel(VarRef ref) { return getGlobalLabel(variable(ref).name); }
+
+    static void declareFunction(const std::string &functionName, const std::vector<bool> &referenceParams);
+    static bool isReferenceParam(int functionId, size_t index);
+
+    // Consultas por nombre para las pasadas de análisis
     static void setVarOffset(const std::string &functionName, const std::string &varName);
 
     static int getVarOffset(const std::string &functionName, const std::string &varName);
 
-    static double getVarValue(const std::string &functionName, const std::string &varName);
+    static void setVarReference(const std::string &functionName, const std::string &varName);
+
+    static bool isReference(const std::string &functionName, const std::string &varName);
+
+    static bool isReferenceParam(const std::string &functionName, size_t index);
+
+    static int getLocalsSize(const std::string &functionName);
 
-    static void setVarValue(const std::string &functionName, const std::string &varName, double value);
+    static void setFrameBase(const std::string &functionName, int base) { functions[functionId(functionName)].frameBase = base; }
 
-    static int getCurrentOffset() { return currentOffset; }
+    static void declareArray(const std::string &functionName, const std::string &varName, int size);
+
+    static void declareGlobal(const std::string &varName, int size);
+
+    static bool isLocal(const std::string &functionName, const std::string &varName);
+
+    static bool isGlobal(const std::string &functionName, const std::string &varName);
+
+    static int getArraySize(const std::string &functionName, const std::string &varName);
+
+    static std::string getGlobalLabel(const std::string &varName) { return "_g_" + varName; }
 
 private:
-    static std::unordered_map<std::string, std::unordered_map<std::string, int>> symbolTable;
-    static std::unordered_map<std::string, std::unordered_map<std::string, double>> variableValues;
-    static int currentOffset;
+    struct FunctionInfo
+    {
+        std::string name;
+        std::vector<VarInfo> vars;
+        IdMap names;
+        int localsSize = 0;
+        int frameBase = 0;
+        std::vector<bool> referenceParams;
+        // Por ámbito de bloque abierto: nombre y variable que ocultó (-1 si ninguna)
+        std::vector<std::vector<std::pair<int, int>>> scopes;
+        std::vector<int> scopeOf;
+    };
+
+    static std::unordered_map<std::string, int> nameIds;
+    static std::unordered_map<std::string, int> functionIds;
+    static std::vector<FunctionInfo> functions;
+
+    static int lookup(const std::string &functionName, const std::string &varName);
+    static int addVar(FunctionInfo &function, int nameId, const std::string &varName);
 };
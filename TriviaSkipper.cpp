@@ -0,0 +1,135 @@
+#include "TriviaSkipper.hpp"
+#include <cstdint>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define MINICPP_TRIVIA_SIMD 1
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define MINICPP_TRIVIA_SIMD 1
+#endif
+
+#ifdef MINICPP_TRIVIA_SIMD
+
+// Bit i de cada máscara corresponde al byte p[i] del bloque
+struct ChunkMasks
+{
+    uint32_t blank;
+    uint32_t newline;
+    uint32_t star;
+};
+
+#if defined(__AVX2__)
+static const int CHUNK = 32;
+static const uint32_t FULL_MASK = 0xFFFFFFFFu;
+
+static inline ChunkMasks scanChunk(const char *p)
+{
+    __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+    __m256i newline = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\n'));
+    __m256i blank = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, _mm256_set1_epi8(' ')),
+                                                    _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\t'))),
+                                    newline);
+    __m256i star = _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('*'));
+    return {static_cast<uint32_t>(_mm256_movemask_epi8(blank)), static_cast<uint32_t>(_mm256_movemask_epi8(newline)),
+            static_cast<uint32_t>(_mm256_movemask_epi8(star))};
+}
+#else
+static const int CHUNK = 16;
+static const uint32_t FULL_MASK = 0xFFFFu;
+
+static inline ChunkMasks scanChunk(const char *p)
+{
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    __m128i newline = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n'));
+    __m128i blank = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')),
+                                              _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))),
+                                 newline);
+    __m128i star = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('*'));
+    return {static_cast<uint32_t>(_mm_movemask_epi8(blank)), static_cast<uint32_t>(_mm_movemask_epi8(newline)),
+            static_cast<uint32_t>(_mm_movemask_epi8(star))};
+}
+#endif
+
+// Suma los saltos de línea marcados en mask y recuerda el último
+static inline void countNewlines(const char *base, uint32_t mask, int &newlines, const char *&lastNewline)
+{
+    if (mask != 0)
+    {
+        newlines += __builtin_popcount(mask);
+        lastNewline = base + 31 - __builtin_clz(mask);
+    }
+}
+
+// Bits de las posiciones anteriores a i (i < 32)
+static inline uint32_t below(int i)
+{
+    return (1u << i) - 1;
+}
+
+#endif
+
+const char *TriviaSkipper::skipBlanks(const char *p, const char *end, int &newlines, const char *&lastNewline)
+{
+#ifdef MINICPP_TRIVIA_SIMD
+    while (end - p >= CHUNK)
+    {
+        ChunkMasks masks = scanChunk(p);
+        if (masks.blank != FULL_MASK)
+        {
+            int stop = __builtin_ctz(~masks.blank);
+            countNewlines(p, masks.newline & below(stop), newlines, lastNewline);
+            return p + stop;
+        }
+        countNewlines(p, masks.newline, newlines, lastNewline);
+        p += CHUNK;
+    }
+#endif
+    for (; p < end; ++p)
+    {
+        if (*p == '\n')
+        {
+            ++newlines;
+            lastNewline = p;
+        }
+        else if (*p != ' ' && *p != '\t')
+        {
+            break;
+        }
+    }
+    return p;
+}
+
+const char *TriviaSkipper::findBlockEnd(const char *p, const char *end, int &newlines, const char *&lastNewline)
+{
+#ifdef MINICPP_TRIVIA_SIMD
+    while (end - p >= CHUNK)
+    {
+        ChunkMasks masks = scanChunk(p);
+        for (uint32_t stars = masks.star; stars != 0; stars &= stars - 1)
+        {
+            int i = __builtin_ctz(stars);
+            if (p + i + 1 == end || p[i + 1] == '/')
+            {
+                countNewlines(p, masks.newline & below(i), newlines, lastNewline);
+                return p + i;
+            }
+        }
+        countNewlines(p, masks.newline, newlines, lastNewline);
+        p += CHUNK;
+    }
+#endif
+    for (; p < end; ++p)
+    {
+        if (*p == '*' && (p + 1 == end || p[1] == '/'))
+        {
+            return p;
+        }
+        if (*p == '\n')
+        {
+            ++newlines;
+            lastNewline = p;
+        }
+    }
+    return end;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+// Búsquedas vectorizadas (AVX2 o SSE2, con versión escalar) que usa el lexer
+// para saltar blancos y comentarios antes de entrar al autómata de re2c. Ambas
+// cuentan los saltos de línea recorridos y dejan en lastNewline el último.
+class TriviaSkipper
+{
+public:
+    // Primer carácter de [p, end) que no es espacio, tabulador ni salto de línea
+    static const char *skipBlanks(const char *p, const char *end, int &newlines, const char *&lastNewline);
+
+    // Posición del "*/" que cierra un comentario de bloque. Si no está en
+    // [p, end) devuelve end, o end - 1 cuando el último carácter es un '*'
+    // que podría empezar el cierre
+    static const char *findBlockEnd(const char *p, const char *end, int &newlines, const char *&lastNewline);
+};
@@ -0,0 +1,468 @@
+#include "X86Backend.hpp"
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+static const X86Reg ARG_REGS[] = {X86Reg::RDI, X86Reg::RSI, X86Reg::RDX, X86Reg::RCX, X86Reg::R8, X86Reg::R9};
+static const int REG_ARGS = 6;
+static const char *const BOUNDS_FAIL_LABEL = ".Lbounds_fail";
+
+void X86Backend::generate(ProgramNode *program)
+{
+    std::function<void(AstNode *)> declareGlobals = [&](AstNode *node)
+    {
+        if (VarDeclExpr *decl = dynamic_cast<VarDeclExpr *>(node))
+        {
+            out.dataSpace(SymbolTable::getGlobalLabel(decl->getVarName()), 4 * std::max(decl->getArraySize(), 1));
+            return;
+        }
+        node->forEachChild([&](AstNode *&child)
+        {
+            declareGlobals(child);
+        });
+    };
+    for (AstNode *global : program->getGlobals())
+    {
+        declareGlobals(global);
+    }
+
+    for (AstNode *node : program->getFunctions())
+    {
+        generateFunction(static_cast<FunctionDeclExpr *>(node));
+    }
+
+    if (boundsFailUsed)
+    {
+        out.label(BOUNDS_FAIL_LABEL);
+        out.alignStack();
+        out.call(BOUNDS_FAIL);
+    }
+}
+
+void X86Backend::generateFunction(FunctionDeclExpr *func)
+{
+    functionName = func->getName();
+    exitLabel = ".L" + functionName + "_exit";
+    layoutFrame(func);
+
+    out.beginFunction(functionSymbol(functionName));
+    out.enter(frameSize);
+    depth = 0;
+
+    
+    std::vector<ParamExpr *> params = func->getParams();
+    for (size_t i = 0; i < params.size(); ++i)
+    {
+        X86Mem slot = X86Mem::frame(slots.at(params[i]->getParamName()));
+        if (i < REG_ARGS)
+        {
+            out.store64(slot, ARG_REGS[i]);
+        }
+        else
+        {
+            out.load64(X86Reg::RAX, X86Mem::at(X86Reg::RBP, 16 + 8 * static_cast<int>(i - REG_ARGS)));
+            out.store64(slot, X86Reg::RAX);
+        }
+    }
+
+    for (AstNode *stmt : func->getStatements())
+    {
+        generateStatement(stmt);
+    }
+
+    
+    out.loadImm(X86Reg::RAX, 0);
+    out.label(exitLabel);
+    out.leaveAndReturn();
+}
+
+// Todas las variables ocupan 8 bytes para poder guardar direcciones; los
+// arreglos locales ocupan 4 bytes por elemento, crecientes hacia %rbp
+void X86Backend::layoutFrame(FunctionDeclExpr *func)
+{
+    slots.clear();
+    frameSize = 0;
+
+    for (ParamExpr *param : func->getParams())
+    {
+        reserveSlot(param->getParamName(), 8);
+    }
+
+    std::function<void(AstNode *)> collect = [&](AstNode *node)
+    {
+        std::string name;
+        if (VarDeclExpr *decl = dynamic_cast<VarDeclExpr *>(node))
+        {
+            name = decl->getVarName();
+        }
+        else if (VariableExpr *var = dynamic_cast<VariableExpr *>(node))
+        {
+            name = var->getVarName();
+        }
+        else if (AssignExpr *assign = dynamic_cast<AssignExpr *>(node))
+        {
+            name = assign->getVarName();
+        }
+        else if (CinExpr *cin = dynamic_cast<CinExpr *>(node))
+        {
+            name = cin->getVarName();
+        }
+        else if (ArrayAccess *access = dynamic_cast<ArrayAccess *>(node))
+        {
+            name = access->getVarName();
+        }
+
+        if (!name.empty() && SymbolTable::isLocal(functionName, name))
+        {
+            int size = SymbolTable::getArraySize(functionName, name);
+            bool array = size > 0 && !SymbolTable::isReference(functionName, name);
+            reserveSlot(name, array ? (4 * size + 7) / 8 * 8 : 8);
+        }
+        node->forEachChild([&](AstNode *&child)
+        {
+            if (child)
+            {
+                collect(child);
+            }
+        });
+    };
+    collect(func);
+
+    frameSize = (frameSize + 15) / 16 * 16;
+}
+
+void X86Backend::reserveSlot(const std::string &name, int bytes)
+{
+    if (slots.count(name) == 0)
+    {
+        frameSize += bytes;
+        slots[name] = -frameSize;
+    }
+}
+
+void X86Backend::generateStatement(AstNode *node)
+{
+    if (!node || dynamic_cast<VarDeclExpr *>(node))
+    {
+        return;
+    }
+    if (ExprList *list = dynamic_cast<ExprList *>(node))
+    {
+        for (AstNode *expr : list->getExpressions())
+        {
+            generateStatement(expr);
+        }
+    }
+    else if (AssignExpr *assign = dynamic_cast<AssignExpr *>(node))
+    {
+        generateExpr(assign->getExpr());
+        out.store32(scalarMem(assign->getVarName()), X86Reg::RAX);
+    }
+    else if (ArrayAssignExpr *assign = dynamic_cast<ArrayAssignExpr *>(node))
+    {
+        generateExpr(assign->getExpr());
+        pushValue();
+        X86Mem element = elementMem(assign);
+        popValue(X86Reg::RDX);
+        out.store32(element, X86Reg::RDX);
+    }
+    else if (CinExpr *cin = dynamic_cast<CinExpr *>(node))
+    {
+        callRuntime(READ_INT);
+        out.store32(scalarMem(cin->getVarName()), X86Reg::RAX);
+    }
+    else if (ArrayCinExpr *cin = dynamic_cast<ArrayCinExpr *>(node))
+    {
+        out.lea(X86Reg::RAX, elementMem(cin));
+        pushValue();
+        callRuntime(READ_INT);
+        popValue(X86Reg::RCX);
+        out.store32(X86Mem::at(X86Reg::RCX), X86Reg::RAX);
+    }
+    else if (PrintStmt *print = dynamic_cast<PrintStmt *>(node))
+    {
+        generateExpr(print->getExpr());
+        out.move(X86Reg::RDI, X86Reg::RAX);
+        callRuntime(PRINT_INT);
+    }
+    else if (StringLiteralExpr *literal = dynamic_cast<StringLiteralExpr *>(node))
+    {
+        std::string label = ".LS" + std::to_string(stringCount++);
+        out.dataString(label, literal->getText());
+        out.lea(X86Reg::RDI, X86Mem::global(label));
+        callRuntime(PRINT_STRING);
+    }
+    else if (dynamic_cast<EndlExpr *>(node))
+    {
+        callRuntime(PRINT_ENDL);
+    }
+    else if (IfStmt *ifStmt = dynamic_cast<IfStmt *>(node))
+    {
+        std::string elseLabel = newLabel();
+        std::string endLabel = newLabel();
+        generateExpr(ifStmt->getCondition());
+        out.jumpIfZero(X86Reg::RAX, elseLabel);
+        generateStatement(ifStmt->getIfBody());
+        out.jump(endLabel);
+        out.label(elseLabel);
+        generateStatement(ifStmt->getElseBody());
+        out.label(endLabel);
+    }
+    else if (WhileStmt *loop = dynamic_cast<WhileStmt *>(node))
+    {
+        std::string startLabel = newLabel();
+        std::string endLabel = newLabel();
+        out.label(startLabel);
+        generateExpr(loop->getCondition());
+        out.jumpIfZero(X86Reg::RAX, endLabel);
+        generateStatement(loop->getBody());
+        out.jump(startLabel);
+        out.label(endLabel);
+    }
+    else if (ReturnStmt *ret = dynamic_cast<ReturnStmt *>(node))
+    {
+        generateExpr(ret->getExpr());
+        out.jump(exitLabel);
+    }
+    else
+    {
+        generateExpr(node);
+    }
+}
+
+void X86Backend::generateExpr(AstNode *node)
+{
+    if (ValueExpr *value = dynamic_cast<ValueExpr *>(node))
+    {
+        out.loadImm(X86Reg::RAX, static_cast<int>(value->getValue()));
+    }
+    else if (VariableExpr *var = dynamic_cast<VariableExpr *>(node))
+    {
+        out.load32(X86Reg::RAX, scalarMem(var->getVarName()));
+    }
+    else if (ArrayElementExpr *element = dynamic_cast<ArrayElementExpr *>(node))
+    {
+        out.load32(X86Reg::RAX, elementMem(element));
+    }
+    else if (FunctionCallExpr *call = dynamic_cast<FunctionCallExpr *>(node))
+    {
+        generateCall(call);
+    }
+    else if (BinaryExpr *binary = dynamic_cast<BinaryExpr *>(node))
+    {
+        generateBinary(binary);
+    }
+    else
+    {
+        throw std::runtime_error("Unsupported expression for the x86-64 target");
+    }
+}
+
+void X86Backend::generateBinary(BinaryExpr *expr)
+{
+    generateExpr(expr->getLeft());
+    pushValue();
+    generateExpr(expr->getRight());
+    out.move(X86Reg::RCX, X86Reg::RAX);
+    popValue(X86Reg::RAX);
+
+    if (dynamic_cast<AddExpr *>(expr)) out.binary(X86Op::ADD, X86Reg::RAX, X86Reg::RCX);
+    else if (dynamic_cast<SubExpr *>(expr)) out.binary(X86Op::SUB, X86Reg::RAX, X86Reg::RCX);
+    else if (dynamic_cast<MulExpr *>(expr)) out.binary(X86Op::IMUL, X86Reg::RAX, X86Reg::RCX);
+    else if (dynamic_cast<AndExpr *>(expr)) out.binary(X86Op::AND, X86Reg::RAX, X86Reg::RCX);
+    else if (dynamic_cast<OrExpr *>(expr)) out.binary(X86Op::OR, X86Reg::RAX, X86Reg::RCX);
+    else if (dynamic_cast<DivExpr *>(expr)) out.divide();
+    else if (dynamic_cast<ModExpr *>(expr))
+    {
+        out.divide();
+        out.move(X86Reg::RAX, X86Reg::RDX);
+    }
+    else if (dynamic_cast<LessExpr *>(expr)) out.compare(X86Cond::LT);
+    else if (dynamic_cast<GreaterExpr *>(expr)) out.compare(X86Cond::GT);
+    else if (dynamic_cast<LessEqualExpr *>(expr)) out.compare(X86Cond::LE);
+    else if (dynamic_cast<GreaterEqualExpr *>(expr)) out.compare(X86Cond::GE);
+    else if (dynamic_cast<EqualExpr *>(expr)) out.compare(X86Cond::EQ);
+    else if (dynamic_cast<NotEqualExpr *>(expr)) out.compare(X86Cond::NE);
+    else throw std::runtime_error("Unsupported operator for the x86-64 target");
+}
+
+// Los argumentos se evalúan de izquierda a derecha en la pila; los seis
+// primeros pasan a registros y el resto se vuelve a apilar en orden inverso
+void X86Backend::generateCall(FunctionCallExpr *call)
+{
+    const std::string &callee = call->getFunctionName();
+    const std::vector<AstNode *> &args = call->getArguments();
+    int count = static_cast<int>(args.size());
+    int stackArgs = std::max(0, count - REG_ARGS);
+
+    // %rsp debe quedar alineado a 16 bytes en el call; con seis argumentos o
+    // menos todos se sacan de la pila antes, así que solo cuenta lo que ya había
+    int atCall = stackArgs == 0 ? depth : depth + count + stackArgs;
+    int pad = atCall % 2 != 0 ? 8 : 0;
+    if (pad)
+    {
+        out.adjustStack(-pad);
+        depth++;
+    }
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (SymbolTable::isReferenceParam(callee, i))
+        {
+            VariableExpr *var = dynamic_cast<VariableExpr *>(args[i]);
+            if (!var)
+            {
+                throw std::runtime_error("Argument " + std::to_string(i + 1) + " of call to " + callee +
+                                         " must be a variable");
+            }
+            generateAddress(var->getVarName());
+        }
+        else
+        {
+            generateExpr(args[i]);
+        }
+        pushValue();
+    }
+
+    int cleanup = pad;
+    if (stackArgs == 0)
+    {
+        for (int i = count - 1; i >= 0; --i)
+        {
+            popValue(ARG_REGS[i]);
+        }
+    }
+    else
+    {
+        for (int i = 0; i < REG_ARGS; ++i)
+        {
+            out.load64(ARG_REGS[i], X86Mem::at(X86Reg::RSP, 8 * (count - 1 - i)));
+        }
+        for (int k = count - 1, pushed = 0; k >= REG_ARGS; --k, ++pushed)
+        {
+            out.pushMem(X86Mem::at(X86Reg::RSP, 8 * (count - 1 - k) + 8 * pushed));
+            depth++;
+        }
+        cleanup += 8 * (count + stackArgs);
+    }
+
+    out.call(functionSymbol(callee));
+    out.adjustStack(cleanup);
+    depth -= cleanup / 8;
+}
+
+void X86Backend::callRuntime(const char *symbol)
+{
+    if (depth % 2 != 0)
+    {
+        out.adjustStack(-8);
+        out.call(symbol);
+        out.adjustStack(8);
+    }
+    else
+    {
+        out.call(symbol);
+    }
+}
+
+X86Mem X86Backend::scalarMem(const std::string &varName)
+{
+    if (SymbolTable::isGlobal(functionName, varName))
+    {
+        return X86Mem::global(SymbolTable::getGlobalLabel(varName));
+    }
+    auto it = slots.find(varName);
+    if (it == slots.end())
+    {
+        throw std::runtime_error("Unknown variable " + varName + " in function " + functionName);
+    }
+    if (SymbolTable::isReference(functionName, varName))
+    {
+        out.load64(X86Reg::RCX, X86Mem::frame(it->second));
+        return X86Mem::at(X86Reg::RCX);
+    }
+    return X86Mem::frame(it->second);
+}
+
+// Deja el índice en %rax y la base, si hace falta, en %rcx
+X86Mem X86Backend::elementMem(ArrayAccess *access)
+{
+    const std::string &varName = access->getVarName();
+    bool global = SymbolTable::isGlobal(functionName, varName);
+    bool pointer = !global && SymbolTable::isReference(functionName, varName);
+    int size = SymbolTable::getArraySize(functionName, varName);
+    bool check = codeGenOptions().boundsCheck && access->isBoundsChecked() && size > 0;
+    int slot = global ? 0 : slots.at(varName);
+
+    if (ValueExpr *constant = dynamic_cast<ValueExpr *>(access->getIndex()))
+    {
+        int index = static_cast<int>(constant->getValue());
+        if (check && (index < 0 || index >= size))
+        {
+            throw std::runtime_error("Array index out of bounds: " + varName + "[" + std::to_string(index) + "]");
+        }
+        if (global)
+        {
+            return X86Mem::global(SymbolTable::getGlobalLabel(varName), 4 * index);
+        }
+        if (pointer)
+        {
+            out.load64(X86Reg::RCX, X86Mem::frame(slot));
+            return X86Mem::at(X86Reg::RCX, 4 * index);
+        }
+        return X86Mem::frame(slot + 4 * index);
+    }
+
+    generateExpr(access->getIndex());
+    if (check)
+    {
+        out.jumpIfAboveOrEqual(X86Reg::RAX, size, BOUNDS_FAIL_LABEL);
+        boundsFailUsed = true;
+    }
+    out.signExtend(X86Reg::RAX);
+
+    if (global)
+    {
+        out.lea(X86Reg::RCX, X86Mem::global(SymbolTable::getGlobalLabel(varName)));
+        return X86Mem::element(X86Reg::RCX, X86Reg::RAX);
+    }
+    if (pointer)
+    {
+        out.load64(X86Reg::RCX, X86Mem::frame(slot));
+        return X86Mem::element(X86Reg::RCX, X86Reg::RAX);
+    }
+    return X86Mem::element(X86Reg::RBP, X86Reg::RAX, slot);
+}
+
+void X86Backend::generateAddress(const std::string &varName)
+{
+    if (SymbolTable::isGlobal(functionName, varName))
+    {
+        out.lea(X86Reg::RAX, X86Mem::global(SymbolTable::getGlobalLabel(varName)));
+    }
+    else if (SymbolTable::isReference(functionName, varName))
+    {
+        out.load64(X86Reg::RAX, X86Mem::frame(slots.at(varName)));
+    }
+    else
+    {
+        out.lea(X86Reg::RAX, X86Mem::frame(slots.at(varName)));
+    }
+}
+
+void X86Backend::pushValue()
+{
+    out.push(X86Reg::RAX);
+    depth++;
+}
+
+void X86Backend::popValue(X86Reg reg)
+{
+    out.pop(reg);
+    depth--;
+}
+
+std::string X86Backend::newLabel()
+{
+    return ".L" + std::to_string(labelCount++);
+}
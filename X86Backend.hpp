@@ -0,0 +1,52 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+#include "Ast.hpp"
+#include "X86Emitter.hpp"
+
+// Genera código x86-64 (System V) recorriendo el AST. Las expresiones se
+// evalúan en %eax y los operandos intermedios se apilan.
+class X86Backend
+{
+public:
+    explicit X86Backend(X86Emitter &out) : out(out) {}
+
+    void generate(ProgramNode *program);
+
+    // Nombres de las funciones del runtime y de las funciones de MiniCpp
+    static std::string functionSymbol(const std::string &name) { return "mc_" + name; }
+    static constexpr const char *PRINT_INT = "minicpp_print_int";
+    static constexpr const char *PRINT_STRING = "minicpp_print_string";
+    static constexpr const char *PRINT_ENDL = "minicpp_print_endl";
+    static constexpr const char *READ_INT = "minicpp_read_int";
+    static constexpr const char *BOUNDS_FAIL = "minicpp_bounds_fail";
+
+private:
+    X86Emitter &out;
+    std::string functionName;
+    std::string exitLabel;
+    std::unordered_map<std::string, int> slots;
+    int frameSize = 0;
+    int depth = 0;
+    int labelCount = 0;
+    int stringCount = 0;
+    bool boundsFailUsed = false;
+
+    void generateFunction(FunctionDeclExpr *func);
+    void layoutFrame(FunctionDeclExpr *func);
+    void reserveSlot(const std::string &name, int bytes);
+
+    void generateStatement(AstNode *node);
+    void generateExpr(AstNode *node);
+    void generateBinary(BinaryExpr *expr);
+    void generateCall(FunctionCallExpr *call);
+    void callRuntime(const char *symbol);
+
+    X86Mem scalarMem(const std::string &varName);
+    X86Mem elementMem(ArrayAccess *access);
+    void generateAddress(const std::string &varName);
+
+    void pushValue();
+    void popValue(X86Reg reg);
+    std::string newLabel();
+};
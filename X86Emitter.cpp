@@ -0,0 +1,238 @@
+#include "X86Emitter.hpp"
+#include <stdexcept>
+
+void GasEmitter::emit(const std::string &instruction)
+{
+    text += "\t" + instruction + "\n";
+}
+
+std::string GasEmitter::reg64(X86Reg reg)
+{
+    switch (reg)
+    {
+    case X86Reg::RAX: return "%rax";
+    case X86Reg::RCX: return "%rcx";
+    case X86Reg::RDX: return "%rdx";
+    case X86Reg::RSI: return "%rsi";
+    case X86Reg::RDI: return "%rdi";
+    case X86Reg::R8: return "%r8";
+    case X86Reg::R9: return "%r9";
+    case X86Reg::RSP: return "%rsp";
+    case X86Reg::RBP: return "%rbp";
+    }
+    throw std::runtime_error("Unknown x86-64 register");
+}
+
+std::string GasEmitter::reg32(X86Reg reg)
+{
+    switch (reg)
+    {
+    case X86Reg::RAX: return "%eax";
+    case X86Reg::RCX: return "%ecx";
+    case X86Reg::RDX: return "%edx";
+    case X86Reg::RSI: return "%esi";
+    case X86Reg::RDI: return "%edi";
+    case X86Reg::R8: return "%r8d";
+    case X86Reg::R9: return "%r9d";
+    case X86Reg::RSP: return "%esp";
+    case X86Reg::RBP: return "%ebp";
+    }
+    throw std::runtime_error("Unknown x86-64 register");
+}
+
+std::string GasEmitter::mem(const X86Mem &mem)
+{
+    std::string disp = mem.disp != 0 ? std::to_string(mem.disp) : "";
+    if (!mem.symbol.empty())
+    {
+        if (mem.disp > 0)
+        {
+            disp = "+" + disp;
+        }
+        return mem.symbol + disp + "(%rip)";
+    }
+    if (mem.indexed)
+    {
+        return disp + "(" + reg64(mem.base) + "," + reg64(mem.index) + ",4)";
+    }
+    return disp + "(" + reg64(mem.base) + ")";
+}
+
+void GasEmitter::beginFunction(const std::string &symbol)
+{
+    text += "\t.globl " + symbol + "\n";
+    text += "\t.type " + symbol + ", @function\n";
+    text += symbol + ":\n";
+}
+
+void GasEmitter::label(const std::string &name)
+{
+    text += name + ":\n";
+}
+
+void GasEmitter::jump(const std::string &target)
+{
+    emit("jmp " + target);
+}
+
+void GasEmitter::jumpIfZero(X86Reg reg, const std::string &target)
+{
+    emit("testl " + reg32(reg) + ", " + reg32(reg));
+    emit("je " + target);
+}
+
+void GasEmitter::jumpIfAboveOrEqual(X86Reg reg, int imm, const std::string &target)
+{
+    emit("cmpl $" + std::to_string(imm) + ", " + reg32(reg));
+    emit("jae " + target);
+}
+
+void GasEmitter::call(const std::string &symbol)
+{
+    emit("call " + symbol);
+}
+
+void GasEmitter::enter(int frameSize)
+{
+    emit("pushq %rbp");
+    emit("movq %rsp, %rbp");
+    if (frameSize > 0)
+    {
+        emit("subq $" + std::to_string(frameSize) + ", %rsp");
+    }
+}
+
+void GasEmitter::leaveAndReturn()
+{
+    emit("leave");
+    emit("ret");
+}
+
+void GasEmitter::adjustStack(int bytes)
+{
+    if (bytes > 0)
+    {
+        emit("addq $" + std::to_string(bytes) + ", %rsp");
+    }
+    else if (bytes < 0)
+    {
+        emit("subq $" + std::to_string(-bytes) + ", %rsp");
+    }
+}
+
+void GasEmitter::alignStack()
+{
+    emit("andq $-16, %rsp");
+}
+
+void GasEmitter::push(X86Reg reg)
+{
+    emit("pushq " + reg64(reg));
+}
+
+void GasEmitter::pop(X86Reg reg)
+{
+    emit("popq " + reg64(reg));
+}
+
+void GasEmitter::pushMem(const X86Mem &m)
+{
+    emit("pushq " + mem(m));
+}
+
+void GasEmitter::move(X86Reg dst, X86Reg src)
+{
+    emit("movq " + reg64(src) + ", " + reg64(dst));
+}
+
+void GasEmitter::loadImm(X86Reg dst, int imm)
+{
+    emit("movl $" + std::to_string(imm) + ", " + reg32(dst));
+}
+
+void GasEmitter::load32(X86Reg dst, const X86Mem &m)
+{
+    emit("movl " + mem(m) + ", " + reg32(dst));
+}
+
+void GasEmitter::store32(const X86Mem &m, X86Reg src)
+{
+    emit("movl " + reg32(src) + ", " + mem(m));
+}
+
+void GasEmitter::load64(X86Reg dst, const X86Mem &m)
+{
+    emit("movq " + mem(m) + ", " + reg64(dst));
+}
+
+void GasEmitter::store64(const X86Mem &m, X86Reg src)
+{
+    emit("movq " + reg64(src) + ", " + mem(m));
+}
+
+void GasEmitter::lea(X86Reg dst, const X86Mem &m)
+{
+    emit("leaq " + mem(m) + ", " + reg64(dst));
+}
+
+void GasEmitter::signExtend(X86Reg reg)
+{
+    emit("movslq " + reg32(reg) + ", " + reg64(reg));
+}
+
+void GasEmitter::binary(X86Op op, X86Reg dst, X86Reg src)
+{
+    static const char *const names[] = {"addl", "subl", "imull", "andl", "orl"};
+    emit(std::string(names[static_cast<int>(op)]) + " " + reg32(src) + ", " + reg32(dst));
+}
+
+void GasEmitter::divide()
+{
+    emit("cltd");
+    emit("idivl %ecx");
+}
+
+void GasEmitter::compare(X86Cond cond)
+{
+    static const char *const names[] = {"setl", "setg", "setle", "setge", "sete", "setne"};
+    emit("cmpl %ecx, %eax");
+    emit(std::string(names[static_cast<int>(cond)]) + " %al");
+    emit("movzbl %al, %eax");
+}
+
+void GasEmitter::dataSpace(const std::string &symbol, int bytes)
+{
+    data += "\t.align 8\n";
+    data += symbol + ":\n";
+    data += "\t.zero " + std::to_string(bytes) + "\n";
+}
+
+void GasEmitter::dataString(const std::string &symbol, const std::string &text)
+{
+    std::string escaped;
+    for (char c : text)
+    {
+        if (c == '\\' || c == '"')
+        {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    rodata += symbol + ":\n";
+    rodata += "\t.asciz \"" + escaped + "\"\n";
+}
+
+std::string GasEmitter::getAssembly() const
+{
+    std::string result = "\t.text\n" + text;
+    if (!data.empty())
+    {
+        result += "\t.data\n" + data;
+    }
+    if (!rodata.empty())
+    {
+        result += "\t.section .rodata\n" + rodata;
+    }
+    result += "\t.section .note.GNU-stack,\"\",@progbits\n";
+    return result;
+}
@@ -0,0 +1,167 @@
+#pragma once
+#include <string>
+
+// Registros x86-64 que usa el generador; las operaciones aritméticas son de
+// 32 bits (int de MiniCpp) y las de direcciones de 64 bits
+enum class X86Reg
+{
+    RAX,
+    RCX,
+    RDX,
+    RSI,
+    RDI,
+    R8,
+    R9,
+    RSP,
+    RBP
+};
+
+// Operando de memoria: disp(base), disp(base, index, 4) o symbol(%rip)
+struct X86Mem
+{
+    X86Reg base = X86Reg::RBP;
+    int disp = 0;
+    bool indexed = false;
+    X86Reg index = X86Reg::RAX;
+    std::string symbol;
+
+    static X86Mem frame(int disp)
+    {
+        X86Mem mem;
+        mem.disp = disp;
+        return mem;
+    }
+
+    static X86Mem at(X86Reg base, int disp = 0)
+    {
+        X86Mem mem;
+        mem.base = base;
+        mem.disp = disp;
+        return mem;
+    }
+
+    static X86Mem element(X86Reg base, X86Reg index, int disp = 0)
+    {
+        X86Mem mem = at(base, disp);
+        mem.indexed = true;
+        mem.index = index;
+        return mem;
+    }
+
+    static X86Mem global(const std::string &symbol, int disp = 0)
+    {
+        X86Mem mem;
+        mem.symbol = symbol;
+        mem.disp = disp;
+        return mem;
+    }
+};
+
+enum class X86Op
+{
+    ADD,
+    SUB,
+    IMUL,
+    AND,
+    OR
+};
+
+enum class X86Cond
+{
+    LT,
+    GT,
+    LE,
+    GE,
+    EQ,
+    NE
+};
+
+// Destino de las instrucciones que produce X86Backend. Cada método es una
+// forma concreta de instrucción para que la salida pueda ser texto o bytes.
+class X86Emitter
+{
+public:
+    virtual ~X86Emitter() = default;
+
+    virtual void beginFunction(const std::string &symbol) = 0;
+    virtual void label(const std::string &name) = 0;
+    virtual void jump(const std::string &target) = 0;
+    virtual void jumpIfZero(X86Reg reg, const std::string &target) = 0;
+    virtual void jumpIfAboveOrEqual(X86Reg reg, int imm, const std::string &target) = 0;
+    virtual void call(const std::string &symbol) = 0;
+
+    virtual void enter(int frameSize) = 0;
+    virtual void leaveAndReturn() = 0;
+    virtual void adjustStack(int bytes) = 0;
+    virtual void alignStack() = 0;
+    virtual void push(X86Reg reg) = 0;
+    virtual void pop(X86Reg reg) = 0;
+    virtual void pushMem(const X86Mem &mem) = 0;
+
+    virtual void move(X86Reg dst, X86Reg src) = 0;
+    virtual void loadImm(X86Reg dst, int imm) = 0;
+    virtual void load32(X86Reg dst, const X86Mem &mem) = 0;
+    virtual void store32(const X86Mem &mem, X86Reg src) = 0;
+    virtual void load64(X86Reg dst, const X86Mem &mem) = 0;
+    virtual void store64(const X86Mem &mem, X86Reg src) = 0;
+    virtual void lea(X86Reg dst, const X86Mem &mem) = 0;
+    virtual void signExtend(X86Reg reg) = 0;
+
+    virtual void binary(X86Op op, X86Reg dst, X86Reg src) = 0;
+    // %eax / %ecx: cociente en %eax y residuo en %edx
+    virtual void divide() = 0;
+    // %eax = (%eax cond %ecx) ? 1 : 0
+    virtual void compare(X86Cond cond) = 0;
+
+    virtual void dataSpace(const std::string &symbol, int bytes) = 0;
+    virtual void dataString(const std::string &symbol, const std::string &text) = 0;
+};
+
+// Ensamblador AT&T para GNU as
+class GasEmitter : public X86Emitter
+{
+public:
+    void beginFunction(const std::string &symbol) override;
+    void label(const std::string &name) override;
+    void jump(const std::string &target) override;
+    void jumpIfZero(X86Reg reg, const std::string &target) override;
+    void jumpIfAboveOrEqual(X86Reg reg, int imm, const std::string &target) override;
+    void call(const std::string &symbol) override;
+
+    void enter(int frameSize) override;
+    void leaveAndReturn() override;
+    void adjustStack(int bytes) override;
+    void alignStack() override;
+    void push(X86Reg reg) override;
+    void pop(X86Reg reg) override;
+    void pushMem(const X86Mem &mem) override;
+
+    void move(X86Reg dst, X86Reg src) override;
+    void loadImm(X86Reg dst, int imm) override;
+    void load32(X86Reg dst, const X86Mem &mem) override;
+    void store32(const X86Mem &mem, X86Reg src) override;
+    void load64(X86Reg dst, const X86Mem &mem) override;
+    void store64(const X86Mem &mem, X86Reg src) override;
+    void lea(X86Reg dst, const X86Mem &mem) override;
+    void signExtend(X86Reg reg) override;
+
+    void binary(X86Op op, X86Reg dst, X86Reg src) override;
+    void divide() override;
+    void compare(X86Cond cond) override;
+
+    void dataSpace(const std::string &symbol, int bytes) override;
+    void dataString(const std::string &symbol, const std::string &text) override;
+
+    std::string getAssembly() const;
+
+private:
+    std::string text;
+    std::string data;
+    std::string rodata;
+
+    void emit(const std::string &instruction);
+
+    static std::string reg64(X86Reg reg);
+    static std::string reg32(X86Reg reg);
+    static std::string mem(const X86Mem &mem);
+};
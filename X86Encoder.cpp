@@ -0,0 +1,357 @@
+#include "X86Encoder.hpp"
+#include <cstring>
+#include <stdexcept>
+
+int X86Encoder::regCode(X86Reg reg)
+{
+    switch (reg)
+    {
+    case X86Reg::RAX: return 0;
+    case X86Reg::RCX: return 1;
+    case X86Reg::RDX: return 2;
+    case X86Reg::RSP: return 4;
+    case X86Reg::RBP: return 5;
+    case X86Reg::RSI: return 6;
+    case X86Reg::RDI: return 7;
+    case X86Reg::R8: return 8;
+    case X86Reg::R9: return 9;
+    }
+    throw std::runtime_error("Unknown x86-64 register");
+}
+
+void X86Encoder::byte(uint8_t value)
+{
+    code.push_back(value);
+}
+
+void X86Encoder::imm32(int32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        byte(static_cast<uint8_t>(static_cast<uint32_t>(value) >> (8 * i)));
+    }
+}
+
+void X86Encoder::rel32(const std::string &target)
+{
+    fixups.push_back({code.size(), target, 0, FixupKind::CODE});
+    imm32(0);
+}
+
+void X86Encoder::rex(bool wide, int reg, int index, int base)
+{
+    uint8_t value = 0x40 | (wide ? 8 : 0) | ((reg >> 3) << 2) | ((index >> 3) << 1) | (base >> 3);
+    if (value != 0x40)
+    {
+        byte(value);
+    }
+}
+
+// ModRM (y SIB si hace falta) de un operando de memoria
+void X86Encoder::modrm(int reg, const X86Mem &mem)
+{
+    if (!mem.symbol.empty())
+    {
+        byte(static_cast<uint8_t>(((reg & 7) << 3) | 5));
+        fixups.push_back({code.size(), mem.symbol, mem.disp, FixupKind::DATA});
+        imm32(0);
+        return;
+    }
+
+    int base = regCode(mem.base);
+    int mod = 2;
+    if (mem.disp == 0 && (base & 7) != 5)
+    {
+        mod = 0;
+    }
+    else if (mem.disp >= -128 && mem.disp <= 127)
+    {
+        mod = 1;
+    }
+
+    if (mem.indexed)
+    {
+        byte(static_cast<uint8_t>((mod << 6) | ((reg & 7) << 3) | 4));
+        byte(static_cast<uint8_t>((2 << 6) | ((regCode(mem.index) & 7) << 3) | (base & 7)));
+    }
+    else
+    {
+        byte(static_cast<uint8_t>((mod << 6) | ((reg & 7) << 3) | (base & 7)));
+        if ((base & 7) == 4)
+        {
+            byte(0x24);
+        }
+    }
+
+    if (mod == 1)
+    {
+        byte(static_cast<uint8_t>(mem.disp));
+    }
+    else if (mod == 2)
+    {
+        imm32(mem.disp);
+    }
+}
+
+void X86Encoder::memInstruction(bool wide, std::initializer_list<uint8_t> opcode, int reg, const X86Mem &mem)
+{
+    int index = mem.indexed ? regCode(mem.index) : 0;
+    int base = mem.symbol.empty() ? regCode(mem.base) : 0;
+    rex(wide, reg, index, base);
+    for (uint8_t op : opcode)
+    {
+        byte(op);
+    }
+    modrm(reg, mem);
+}
+
+void X86Encoder::regInstruction(bool wide, std::initializer_list<uint8_t> opcode, int reg, int rm)
+{
+    rex(wide, reg, 0, rm);
+    for (uint8_t op : opcode)
+    {
+        byte(op);
+    }
+    byte(static_cast<uint8_t>(0xC0 | ((reg & 7) << 3) | (rm & 7)));
+}
+
+void X86Encoder::beginFunction(const std::string &symbol)
+{
+    label(symbol);
+}
+
+void X86Encoder::label(const std::string &name)
+{
+    if (!labels.emplace(name, code.size()).second)
+    {
+        throw std::runtime_error("Duplicate label " + name);
+    }
+}
+
+void X86Encoder::jump(const std::string &target)
+{
+    byte(0xE9);
+    rel32(target);
+}
+
+void X86Encoder::jumpIfZero(X86Reg reg, const std::string &target)
+{
+    regInstruction(false, {0x85}, regCode(reg), regCode(reg));
+    byte(0x0F);
+    byte(0x84);
+    rel32(target);
+}
+
+void X86Encoder::jumpIfAboveOrEqual(X86Reg reg, int imm, const std::string &target)
+{
+    regInstruction(false, {0x81}, 7, regCode(reg));
+    imm32(imm);
+    byte(0x0F);
+    byte(0x83);
+    rel32(target);
+}
+
+void X86Encoder::call(const std::string &symbol)
+{
+    auto external = externals.find(symbol);
+    if (external == externals.end())
+    {
+        byte(0xE8);
+        rel32(symbol);
+        return;
+    }
+
+    // movabs $address, %r11; call *%r11
+    uint64_t address = reinterpret_cast<uint64_t>(external->second);
+    byte(0x49);
+    byte(0xBB);
+    for (int i = 0; i < 8; ++i)
+    {
+        byte(static_cast<uint8_t>(address >> (8 * i)));
+    }
+    byte(0x41);
+    byte(0xFF);
+    byte(0xD3);
+}
+
+void X86Encoder::enter(int frameSize)
+{
+    push(X86Reg::RBP);
+    move(X86Reg::RBP, X86Reg::RSP);
+    adjustStack(-frameSize);
+}
+
+void X86Encoder::leaveAndReturn()
+{
+    byte(0xC9);
+    byte(0xC3);
+}
+
+void X86Encoder::adjustStack(int bytes)
+{
+    if (bytes == 0)
+    {
+        return;
+    }
+    regInstruction(true, {0x81}, bytes > 0 ? 0 : 5, regCode(X86Reg::RSP));
+    imm32(bytes > 0 ? bytes : -bytes);
+}
+
+void X86Encoder::alignStack()
+{
+    regInstruction(true, {0x83}, 4, regCode(X86Reg::RSP));
+    byte(0xF0);
+}
+
+void X86Encoder::push(X86Reg reg)
+{
+    rex(false, 0, 0, regCode(reg));
+    byte(static_cast<uint8_t>(0x50 + (regCode(reg) & 7)));
+}
+
+void X86Encoder::pop(X86Reg reg)
+{
+    rex(false, 0, 0, regCode(reg));
+    byte(static_cast<uint8_t>(0x58 + (regCode(reg) & 7)));
+}
+
+void X86Encoder::pushMem(const X86Mem &mem)
+{
+    memInstruction(false, {0xFF}, 6, mem);
+}
+
+void X86Encoder::move(X86Reg dst, X86Reg src)
+{
+    regInstruction(true, {0x89}, regCode(src), regCode(dst));
+}
+
+void X86Encoder::loadImm(X86Reg dst, int imm)
+{
+    rex(false, 0, 0, regCode(dst));
+    byte(static_cast<uint8_t>(0xB8 + (regCode(dst) & 7)));
+    imm32(imm);
+}
+
+void X86Encoder::load32(X86Reg dst, const X86Mem &mem)
+{
+    memInstruction(false, {0x8B}, regCode(dst), mem);
+}
+
+void X86Encoder::store32(const X86Mem &mem, X86Reg src)
+{
+    memInstruction(false, {0x89}, regCode(src), mem);
+}
+
+void X86Encoder::load64(X86Reg dst, const X86Mem &mem)
+{
+    memInstruction(true, {0x8B}, regCode(dst), mem);
+}
+
+void X86Encoder::store64(const X86Mem &mem, X86Reg src)
+{
+    memInstruction(true, {0x89}, regCode(src), mem);
+}
+
+void X86Encoder::lea(X86Reg dst, const X86Mem &mem)
+{
+    memInstruction(true, {0x8D}, regCode(dst), mem);
+}
+
+void X86Encoder::signExtend(X86Reg reg)
+{
+    regInstruction(true, {0x63}, regCode(reg), regCode(reg));
+}
+
+void X86Encoder::binary(X86Op op, X86Reg dst, X86Reg src)
+{
+    switch (op)
+    {
+    case X86Op::ADD: regInstruction(false, {0x01}, regCode(src), regCode(dst)); break;
+    case X86Op::SUB: regInstruction(false, {0x29}, regCode(src), regCode(dst)); break;
+    case X86Op::AND: regInstruction(false, {0x21}, regCode(src), regCode(dst)); break;
+    case X86Op::OR: regInstruction(false, {0x09}, regCode(src), regCode(dst)); break;
+    case X86Op::IMUL: regInstruction(false, {0x0F, 0xAF}, regCode(dst), regCode(src)); break;
+    }
+}
+
+void X86Encoder::divide()
+{
+    byte(0x99);
+    regInstruction(false, {0xF7}, 7, regCode(X86Reg::RCX));
+}
+
+void X86Encoder::compare(X86Cond cond)
+{
+    static const uint8_t setcc[] = {0x9C, 0x9F, 0x9E, 0x9D, 0x94, 0x95};
+    regInstruction(false, {0x39}, regCode(X86Reg::RCX), regCode(X86Reg::RAX));
+    byte(0x0F);
+    byte(setcc[static_cast<int>(cond)]);
+    byte(0xC0);
+    regInstruction(false, {0x0F, 0xB6}, regCode(X86Reg::RAX), regCode(X86Reg::RAX));
+}
+
+void X86Encoder::dataSpace(const std::string &symbol, int bytes)
+{
+    data.resize((data.size() + 7) / 8 * 8);
+    dataLabels[symbol] = data.size();
+    data.resize(data.size() + bytes);
+}
+
+void X86Encoder::dataString(const std::string &symbol, const std::string &text)
+{
+    dataLabels[symbol] = data.size();
+    data.insert(data.end(), text.begin(), text.end());
+    data.push_back(0);
+}
+
+void X86Encoder::defineExternal(const std::string &symbol, const void *address)
+{
+    externals[symbol] = address;
+}
+
+size_t X86Encoder::getSymbolOffset(const std::string &symbol) const
+{
+    auto it = labels.find(symbol);
+    if (it == labels.end())
+    {
+        throw std::runtime_error("Undefined symbol " + symbol);
+    }
+    return it->second;
+}
+
+void X86Encoder::link(uint8_t *codeBase, uint8_t *dataBase) const
+{
+    std::memcpy(codeBase, code.data(), code.size());
+    if (!data.empty())
+    {
+        std::memcpy(dataBase, data.data(), data.size());
+    }
+
+    for (const Fixup &fixup : fixups)
+    {
+        // Los desplazamientos son relativos al final del campo de 32 bits
+        const uint8_t *next = codeBase + fixup.position + 4;
+        const uint8_t *target;
+        if (fixup.kind == FixupKind::CODE)
+        {
+            target = codeBase + getSymbolOffset(fixup.symbol);
+        }
+        else
+        {
+            auto it = dataLabels.find(fixup.symbol);
+            if (it == dataLabels.end())
+            {
+                throw std::runtime_error("Undefined data symbol " + fixup.symbol);
+            }
+            target = dataBase + it->second + fixup.addend;
+        }
+
+        int64_t displacement = target - next;
+        if (displacement < INT32_MIN || displacement > INT32_MAX)
+        {
+            throw std::runtime_error("Displacement out of range for " + fixup.symbol);
+        }
+        int32_t value = static_cast<int32_t>(displacement);
+        std::memcpy(codeBase + fixup.position, &value, sizeof(value));
+    }
+}
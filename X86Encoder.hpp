@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "X86Emitter.hpp"
+
+// Codifica las instrucciones directamente a código máquina para el modo JIT.
+// Los saltos y los accesos %rip a datos se resuelven en link(), cuando se
+// conoce la dirección final del código y de los datos.
+class X86Encoder : public X86Emitter
+{
+public:
+    void beginFunction(const std::string &symbol) override;
+    void label(const std::string &name) override;
+    void jump(const std::string &target) override;
+    void jumpIfZero(X86Reg reg, const std::string &target) override;
+    void jumpIfAboveOrEqual(X86Reg reg, int imm, const std::string &target) override;
+    void call(const std::string &symbol) override;
+
+    void enter(int frameSize) override;
+    void leaveAndReturn() override;
+    void adjustStack(int bytes) override;
+    void alignStack() override;
+    void push(X86Reg reg) override;
+    void pop(X86Reg reg) override;
+    void pushMem(const X86Mem &mem) override;
+
+    void move(X86Reg dst, X86Reg src) override;
+    void loadImm(X86Reg dst, int imm) override;
+    void load32(X86Reg dst, const X86Mem &mem) override;
+    void store32(const X86Mem &mem, X86Reg src) override;
+    void load64(X86Reg dst, const X86Mem &mem) override;
+    void store64(const X86Mem &mem, X86Reg src) override;
+    void lea(X86Reg dst, const X86Mem &mem) override;
+    void signExtend(X86Reg reg) override;
+
+    void binary(X86Op op, X86Reg dst, X86Reg src) override;
+    void divide() override;
+    void compare(X86Cond cond) override;
+
+    void dataSpace(const std::string &symbol, int bytes) override;
+    void dataString(const std::string &symbol, const std::string &text) override;
+
+    // Funciones del proceso que el código llama por dirección absoluta
+    void defineExternal(const std::string &symbol, const void *address);
+
+    size_t getCodeSize() const { return code.size(); }
+    size_t getDataSize() const { return data.size(); }
+
+    // Copia código y datos a sus destinos y resuelve las referencias
+    void link(uint8_t *codeBase, uint8_t *dataBase) const;
+    size_t getSymbolOffset(const std::string &symbol) const;
+
+private:
+    enum class FixupKind
+    {
+        CODE,
+        DATA
+    };
+
+    struct Fixup
+    {
+        size_t position;
+        std::string symbol;
+        int addend;
+        FixupKind kind;
+    };
+
+    std::vector<uint8_t> code;
+    std::vector<uint8_t> data;
+    std::unordered_map<std::string, size_t> labels;
+    std::unordered_map<std::string, size_t> dataLabels;
+    std::unordered_map<std::string, const void *> externals;
+    std::vector<Fixup> fixups;
+
+    void byte(uint8_t value);
+    void imm32(int32_t value);
+    void rel32(const std::string &target);
+    void rex(bool wide, int reg, int index, int base);
+    void modrm(int reg, const X86Mem &mem);
+    void memInstruction(bool wide, std::initializer_list<uint8_t> opcode, int reg, const X86Mem &mem);
+    void regInstruction(bool wide, std::initializer_list<uint8_t> opcode, int reg, int rm);
+
+    static int regCode(X86Reg reg);
+};
@@ -1,16 +1,140 @@
 #include <iostream>
 #include <fstream>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
 #include "MiniCppLexer.hpp"
 #include "MiniCppParser.hpp"
+#include "SemanticAnalyzer.hpp"
+#include "Inliner.hpp"
+#include "Sccp.hpp"
+#include "ConstexprEvaluator.hpp"
+#include "BoundsCheck.hpp"
+#include "StrengthReduction.hpp"
+#include "Profile.hpp"
+#include "X86Backend.hpp"
+#include "Jit.hpp"
+#include "BytecodeCompiler.hpp"
+#include "BytecodeVm.hpp"
+#include "MipsAssembler.hpp"
+#include "MipsScheduler.hpp"
+#include "StreamCompiler.hpp"
+#include "Interpreter.hpp"
 
 int main(int argc, char **argv)
 {
-    if (argc != 3) {
-        std::cerr << "Usage: " << argv[0] << " <input_filename> <output_filename>\n";
+    int inlineBudget = 0;
+    long long constexprBudget = 1000000;
+    std::string target = "mips";
+    std::string format = "asm";
+    std::string mipsModel = "spim";
+    bool run = false;
+    bool exec = false;
+    bool interpret = false;
+    bool stream = false;
+    std::string profileUse;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        std::string option = argv[i];
+        if (option.rfind("--", 0) != 0) {
+            files.push_back(option);
+        } else if (option == "--run") {
+            run = true;
+        } else if (option == "--exec") {
+            exec = true;
+        } else if (option == "--interpret") {
+            interpret = true;
+        } else if (option == "--stream") {
+            stream = true;
+        } else if (option.rfind("--inline-budget=", 0) == 0) {
+            inlineBudget = std::atoi(option.c_str() + 16);
+        } else if (option.rfind("--constexpr-budget=", 0) == 0) {
+            constexprBudget = std::atoll(option.c_str() + 19);
+        } else if (option.rfind("--target=", 0) == 0) {
+            target = option.substr(9);
+            if (target != "mips" && target != "x86-64" && target != "bytecode") {
+                std::cerr << "Unknown target: " << target << "\n";
+                return -1;
+            }
+        } else if (option.rfind("--format=", 0) == 0) {
+            format = option.substr(9);
+            if (format != "asm" && format != "elf" && format != "bin") {
+                std::cerr << "Unknown format: " << format << "\n";
+                return -1;
+            }
+        } else if (option.rfind("--mips-model=", 0) == 0) {
+            mipsModel = option.substr(13);
+            if (mipsModel != "spim" && mipsModel != "pipelined" && mipsModel != "delayed") {
+                std::cerr << "Unknown MIPS model: " << mipsModel << "\n";
+                return -1;
+            }
+        } else if (option == "--bounds-check") {
+            codeGenOptions().boundsCheck = true;
+        } else if (option == "--instrument") {
+            codeGenOptions().instrument = true;
+        } else if (option.rfind("--instrument=", 0) == 0) {
+            codeGenOptions().instrument = true;
+            codeGenOptions().profileFile = option.substr(13);
+        } else if (option.rfind("--profile-use=", 0) == 0) {
+            profileUse = option.substr(14);
+        } else {
+            std::cerr << "Unknown option: " << option << "\n";
+            return -1;
+        }
+    }
+
+    if (format != "asm" && target != "mips") {
+        std::cerr << "--format=" << format << " requires --target=mips\n";
+        return -1;
+    }
+
+    if (codeGenOptions().instrument && (target != "mips" || run || interpret)) {
+        std::cerr << "--instrument requires --target=mips\n";
+        return -1;
+    }
+
+    if (!profileUse.empty() && (target != "mips" || run || interpret)) {
+        std::cerr << "--profile-use requires --target=mips\n";
         return -1;
     }
 
-    std::ifstream in(argv[1]);
+    if (stream && (target != "mips" || format != "asm" || run || interpret)) {
+        std::cerr << "--stream requires --target=mips and --format=asm\n";
+        return -1;
+    }
+
+    if (mipsModel != "spim" && target != "mips") {
+        std::cerr << "--mips-model=" << mipsModel << " requires --target=mips\n";
+        return -1;
+    }
+
+    if (files.size() != (run || exec || interpret ? 1u : 2u)) {
+        std::cerr << "Usage: " << argv[0] << " <input_filename> <output_filename> [--target=mips|x86-64|bytecode] [--format=asm|elf|bin] [--mips-model=spim|pipelined|delayed] [--inline-budget=N] [--constexpr-budget=N] [--bounds-check] [--instrument[=counts_file]] [--profile-use=counts_file] [--stream]\n"
+                  << "       " << argv[0] << " <input_filename> --run|--interpret [--inline-budget=N] [--constexpr-budget=N] [--bounds-check]\n"
+                  << "       " << argv[0] << " <bytecode_filename> --exec\n";
+        return -1;
+    }
+
+    // Un archivo de bytecode se ejecuta sin volver a analizar el programa
+    if (exec) {
+        std::ifstream bytecodeFile(files[0], std::ios::binary);
+        if (!bytecodeFile.is_open()) {
+            std::cerr << "Cannot open input file\n";
+            return -1;
+        }
+        try {
+            BytecodeProgram bytecode = BytecodeProgram::read(bytecodeFile);
+            BytecodeVm vm(bytecode);
+            vm.run();
+            return 0;
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << "\n";
+            return -1;
+        }
+    }
+
+    std::ifstream in(files[0]);
 
     if (!in.is_open()) {
         std::cerr << "Cannot open input file\n";
@@ -26,16 +150,139 @@ int main(int argc, char **argv)
     Parser parser(lex);
 
     try {
-        AstNode* result = parser.parse();
+        // Cada función se compila y se escribe en cuanto se termina de leer
+        if (stream) {
+            ProfileLoader loader;
+            if (!profileUse.empty()) {
+                loader.read(profileUse);
+            }
+            std::ofstream outFile(files[1]);
+            if (!outFile.is_open()) {
+                std::cerr << "Cannot open output file for writing\n";
+                return -1;
+            }
+            std::cout << "Generating code...\n";
+            try {
+                StreamCompiler compiler(outFile, mipsModel, profileUse.empty() ? nullptr : &loader);
+                compiler.run(parser);
+            } catch (...) {
+                // No se deja un archivo de salida a medias
+                outFile.close();
+                std::remove(files[1].c_str());
+                throw;
+            }
+            std::cout << "Code successfully saved to " << files[1] << "\n";
+            return 1;
+        }
+
+        ProgramNode* result = parser.parse();
+
+        // Los errores de nombres y llamadas se informan antes de cualquier otra pasada
+        SemanticAnalyzer analyzer;
+        analyzer.run(result);
+
+        // Los sitios del perfil se numeran sobre el árbol tal como se escribió,
+        // igual al instrumentar y al leer los contadores
+        if (codeGenOptions().instrument || !profileUse.empty()) {
+            ProfileNumbering numbering;
+            numbering.run(result);
+        }
+        if (!profileUse.empty()) {
+            ProfileLoader loader;
+            loader.read(profileUse);
+            loader.apply();
+        }
+
+        ConstexprEvaluator evaluator(constexprBudget);
+        evaluator.run(result);
+
+        Inliner inliner(inlineBudget);
+        inliner.run(result);
+
+        // Después del inlining, para propagar también a través de los cuerpos expandidos
+        ConstantPropagator propagator;
+        propagator.run(result);
+
+        if (codeGenOptions().boundsCheck) {
+            BoundsCheckEliminator eliminator;
+            eliminator.run(result);
+        }
+
+        // Ejecuta el programa directamente sin generar un archivo de salida
+        if (run) {
+            Jit jit;
+            jit.run(result);
+            return 0;
+        }
+
+        // Evalúa el árbol directamente, sin ningún backend
+        if (interpret) {
+            Interpreter interpreter;
+            interpreter.run(result);
+            return 0;
+        }
         
         std::cout << "Generating code...\n";
-        std::string generatedCode = result->generateCode().code;
+        if (target == "bytecode") {
+            BytecodeCompiler compiler;
+            BytecodeProgram bytecode = compiler.compile(result);
+            std::ofstream bytecodeFile(files[1], std::ios::binary);
+            if (!bytecodeFile.is_open()) {
+                std::cerr << "Cannot open output file for writing\n";
+                return -1;
+            }
+            bytecode.write(bytecodeFile);
+            std::cout << "Code successfully saved to " << files[1] << "\n";
+            return 1;
+        }
+
+        std::string generatedCode;
+        if (target == "x86-64") {
+            GasEmitter emitter;
+            X86Backend backend(emitter);
+            backend.generate(result);
+            generatedCode = emitter.getAssembly();
+        } else {
+            // Los planes de inducción solo los usa el generador MIPS
+            InductionVariableReducer reducer;
+            reducer.run(result);
+            generatedCode = result->generateCode().code;
+
+            // Sin retardos (SPIM) el orden del generador ya es el mejor posible
+            if (mipsModel != "spim") {
+                MipsScheduler scheduler(mipsModel == "delayed");
+                generatedCode = scheduler.schedule(generatedCode);
+            }
+        }
+
+        // El código MIPS se codifica en memoria sin pasar por un ensamblador
+        if (format != "asm") {
+            MipsAssembler assembler;
+            assembler.assemble(generatedCode);
+            std::ofstream objectFile(files[1], std::ios::binary);
+            if (!objectFile.is_open()) {
+                std::cerr << "Cannot open output file for writing\n";
+                return -1;
+            }
+            if (format == "elf") {
+                assembler.writeObject(objectFile);
+            } else {
+                std::ofstream dataFile(files[1] + ".data", std::ios::binary);
+                if (!dataFile.is_open()) {
+                    std::cerr << "Cannot open output file for writing\n";
+                    return -1;
+                }
+                assembler.writeImage(objectFile, dataFile);
+            }
+            std::cout << "Code successfully saved to " << files[1] << "\n";
+            return 1;
+        }
 
-        std::ofstream outFile(argv[2]);
+        std::ofstream outFile(files[1]);
         if (outFile.is_open()) {
             outFile << generatedCode;
             outFile.close();
-            std::cout << "Code successfully saved to " << argv[2] << "\n";
+            std::cout << "Code successfully saved to " << files[1] << "\n";
             return 1;  
         } else {
             std::cerr << "Cannot open output file for writing\n";
@@ -0,0 +1,174 @@
+// Recorre con blancos y comentarios todas las posiciones de los primeros
+// buffers del lexer, de modo que "/*", "*/" y "//" queden partidos por algún
+// relleno (los rellenos ocurren al empezar un token, así que el límite no es
+// un múltiplo fijo de Lexer::SIZE), y compara los tokens, líneas y columnas
+// con un recorrido directo del texto. También revisa que un comentario de
+// bloque sin cerrar se informe como error.
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "MiniCppLexer.hpp"
+
+static const char *TEMP_FILE = "lexer_refill_test.tmp";
+
+struct Expected
+{
+    Token kind;
+    std::string text;
+    int line;
+    int column;
+};
+
+// Solo hace falta reconocer lo que generan los casos: identificadores, int y ';'
+static std::vector<Expected> referenceTokens(const std::string &text)
+{
+    std::vector<Expected> tokens;
+    int line = 1;
+    int column = 1;
+    size_t i = 0;
+    auto skip = [&](size_t to)
+    {
+        for (; i < to; ++i)
+        {
+            if (text[i] == '\n')
+            {
+                ++line;
+                column = 1;
+            }
+            else
+            {
+                ++column;
+            }
+        }
+    };
+
+    while (i < text.size())
+    {
+        char c = text[i];
+        if (c == ' ' || c == '\t' || c == '\n')
+        {
+            skip(i + 1);
+        }
+        else if (text.compare(i, 2, "//") == 0)
+        {
+            skip(std::min(text.find('\n', i), text.size()));
+        }
+        else if (text.compare(i, 2, "/*") == 0)
+        {
+            skip(text.find("*/", i + 2) + 2);
+        }
+        else
+        {
+            size_t end = i + 1;
+            while (c != ';' && end < text.size() && (std::isalnum(static_cast<unsigned char>(text[end])) || text[end] == '_'))
+            {
+                ++end;
+            }
+            std::string word = text.substr(i, end - i);
+            Token kind = word == ";" ? Token::SEMICOLON : word == "int" ? Token::KW_INT : Token::IDENT;
+            skip(end);
+            tokens.push_back({kind, word, line, column});
+        }
+    }
+    tokens.push_back({Token::Eof, "", line, column});
+    return tokens;
+}
+
+static void writeFile(const std::string &text)
+{
+    std::ofstream out(TEMP_FILE, std::ios::binary);
+    out << text;
+}
+
+static int failures = 0;
+
+static void fail(const std::string &name, const std::string &message)
+{
+    if (++failures <= 10)
+    {
+        std::printf("%s: %s\n", name.c_str(), message.c_str());
+    }
+}
+
+static void compare(const std::string &name, const std::string &text)
+{
+    std::vector<Expected> expected = referenceTokens(text);
+    writeFile(text);
+    std::ifstream in(TEMP_FILE, std::ios::binary);
+    Lexer lexer(in);
+
+    for (const Expected &token : expected)
+    {
+        Token kind = lexer.nextToken();
+        if (kind != token.kind || (kind != Token::Eof && lexer.tokenText() != token.text) ||
+            lexer.getLine() != token.line || lexer.getColumn() != token.column)
+        {
+            fail(name, "expected '" + token.text + "' at " + std::to_string(token.line) + ":" +
+                           std::to_string(token.column) + ", got '" + lexer.tokenText() + "' (kind " +
+                           std::to_string(kind) + ") at " + std::to_string(lexer.getLine()) + ":" +
+                           std::to_string(lexer.getColumn()));
+            return;
+        }
+    }
+}
+
+// Identificadores cortos hasta dejar el siguiente carácter en la posición offset
+static std::string padding(size_t offset)
+{
+    std::string text;
+    while (text.size() < offset)
+    {
+        text += offset - text.size() >= 2 ? "a " : " ";
+    }
+    return text;
+}
+
+int main()
+{
+    const std::vector<std::string> trivia = {
+        "/* comentario */",
+        "/* con\nvarias\n\nlíneas */",
+        "/** estrellas ***/",
+        "// de línea\n",
+        "//\n",
+        "   \t\n\n  \t ",
+        "/* largo " + std::string(3 * Lexer::SIZE, '*') + "\n" + std::string(Lexer::SIZE, ' ') + " */",
+    };
+
+    for (size_t t = 0; t < trivia.size(); ++t)
+    {
+        for (size_t start = 0; start < 2 * Lexer::SIZE + 16; ++start)
+        {
+            compare("trivia " + std::to_string(t) + " at " + std::to_string(start),
+                    padding(start) + trivia[t] + "int y;\nb;");
+        }
+    }
+
+    // Sin "*/" el comentario llega al fin del archivo, aun cruzando rellenos
+    for (size_t start = Lexer::SIZE - 24; start < Lexer::SIZE + 8; ++start)
+    {
+        writeFile(padding(start) + "/* sin cerrar *" + std::string(Lexer::SIZE, 'x') + "*");
+        std::ifstream in(TEMP_FILE, std::ios::binary);
+        Lexer lexer(in);
+        Token kind;
+        do
+        {
+            kind = lexer.nextToken();
+        } while (kind == Token::IDENT);
+        if (kind != Token::Error)
+        {
+            fail("unterminated at " + std::to_string(start), "expected an error token, got kind " + std::to_string(kind));
+        }
+    }
+
+    std::remove(TEMP_FILE);
+    if (failures > 0)
+    {
+        std::printf("%d mismatches\n", failures);
+        return 1;
+    }
+    return 0;
+}
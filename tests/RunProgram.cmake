@@ -0,0 +1,63 @@
+# Compila un programa de tests/programs con MiniCpp, lo ejecuta con su archivo
+# .in como entrada y compara la salida con su archivo .out (cmake -P).
+#   COMPILER: ejecutable de MiniCpp
+#   PROGRAM:  ruta del programa sin extensión
+#   MODE:     x86-64 (ensambla y enlaza con RUNTIME usando CC), run (--run),
+#             mips (ensamblador MIPS que se ejecuta con el simulador SPIM),
+#             stream (igual que mips, compilado con --stream) o errors (el
+#             programa no compila y .out tiene los errores que se informan)
+#   WORK_DIR: directorio para los archivos intermedios
+
+get_filename_component(name ${PROGRAM} NAME)
+set(input ${PROGRAM}.in)
+file(READ ${PROGRAM}.out expected)
+
+if(MODE STREQUAL "x86-64")
+  set(assembly ${WORK_DIR}/${name}.s)
+  set(executable ${WORK_DIR}/${name})
+  file(REMOVE ${assembly})
+  execute_process(COMMAND ${COMPILER} ${PROGRAM}.cpp ${assembly} --target=x86-64 OUTPUT_QUIET)
+  if(NOT EXISTS ${assembly})
+    message(FATAL_ERROR "${name}: MiniCpp did not generate ${assembly}")
+  endif()
+  execute_process(COMMAND ${CC} -no-pie ${assembly} ${RUNTIME} -o ${executable} RESULT_VARIABLE status)
+  if(NOT status EQUAL 0)
+    message(FATAL_ERROR "${name}: linking failed")
+  endif()
+  execute_process(COMMAND ${executable} INPUT_FILE ${input} OUTPUT_VARIABLE output RESULT_VARIABLE status)
+elseif(MODE STREQUAL "mips" OR MODE STREQUAL "stream")
+  set(assembly ${WORK_DIR}/${name}_${MODE}.s)
+  set(options)
+  if(MODE STREQUAL "stream")
+    set(options --stream)
+  endif()
+  file(REMOVE ${assembly})
+  execute_process(COMMAND ${COMPILER} ${PROGRAM}.cpp ${assembly} ${options} OUTPUT_QUIET)
+  if(NOT EXISTS ${assembly})
+    message(FATAL_ERROR "${name}: MiniCpp did not generate ${assembly}")
+  endif()
+  execute_process(COMMAND ${SPIM} -quiet -file ${assembly} INPUT_FILE ${input} OUTPUT_VARIABLE output
+                  RESULT_VARIABLE status)
+  # SPIM anuncia el manejador de excepciones que cargó antes de la salida del programa
+  string(REGEX REPLACE "^Loaded: [^\n]*\n" "" output "${output}")
+elseif(MODE STREQUAL "errors")
+  set(assembly ${WORK_DIR}/${name}_errors.s)
+  file(REMOVE ${assembly})
+  execute_process(COMMAND ${COMPILER} ${PROGRAM}.cpp ${assembly} OUTPUT_QUIET ERROR_VARIABLE output)
+  if(EXISTS ${assembly})
+    message(FATAL_ERROR "${name}: expected compile errors, but ${assembly} was generated")
+  endif()
+  set(status 0)
+elseif(MODE STREQUAL "run")
+  execute_process(COMMAND ${COMPILER} ${PROGRAM}.cpp --run INPUT_FILE ${input} OUTPUT_VARIABLE output
+                  RESULT_VARIABLE status)
+else()
+  message(FATAL_ERROR "Unknown MODE '${MODE}'")
+endif()
+
+if(NOT status EQUAL 0)
+  message(FATAL_ERROR "${name}: the program exited with '${status}'\n${output}")
+endif()
+if(NOT output STREQUAL expected)
+  message(FATAL_ERROR "${name}: expected\n${expected}got\n${output}")
+endif()
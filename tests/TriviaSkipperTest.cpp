@@ -0,0 +1,135 @@
+// Compara las búsquedas de TriviaSkipper (AVX2, SSE2 o escalar, según cómo se
+// compile) con una versión escalar directa, sobre entradas aleatorias y sobre
+// los casos de borde: "*/" partido entre bloques de 16 o 32 bytes y un '*'
+// como último carácter del buffer.
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <string>
+#include "TriviaSkipper.hpp"
+
+struct ScanResult
+{
+    const char *stop;
+    int newlines;
+    const char *lastNewline;
+};
+
+static ScanResult referenceBlanks(const char *p, const char *end)
+{
+    ScanResult result{end, 0, nullptr};
+    for (; p < end; ++p)
+    {
+        if (*p == '\n')
+        {
+            ++result.newlines;
+            result.lastNewline = p;
+        }
+        else if (*p != ' ' && *p != '\t')
+        {
+            result.stop = p;
+            return result;
+        }
+    }
+    return result;
+}
+
+static ScanResult referenceBlockEnd(const char *p, const char *end)
+{
+    ScanResult result{end, 0, nullptr};
+    for (; p < end; ++p)
+    {
+        if (*p == '*' && (p + 1 == end || p[1] == '/'))
+        {
+            result.stop = p;
+            return result;
+        }
+        if (*p == '\n')
+        {
+            ++result.newlines;
+            result.lastNewline = p;
+        }
+    }
+    return result;
+}
+
+static int failures = 0;
+
+static void check(const char *name, const std::string &text, size_t from, const ScanResult &expected,
+                  const ScanResult &actual)
+{
+    if (expected.stop == actual.stop && expected.newlines == actual.newlines &&
+        expected.lastNewline == actual.lastNewline)
+    {
+        return;
+    }
+    if (++failures <= 10)
+    {
+        std::printf("%s: from %zu in %zu bytes, expected stop %td with %d newlines, "
+                    "got %td with %d newlines\n",
+                    name, from, text.size(), expected.stop - text.data(), expected.newlines,
+                    actual.stop - text.data(), actual.newlines);
+    }
+}
+
+static void compare(const std::string &text)
+{
+    const char *end = text.data() + text.size();
+    for (size_t from = 0; from <= text.size(); ++from)
+    {
+        const char *p = text.data() + from;
+        ScanResult actual{nullptr, 0, nullptr};
+
+        actual.stop = TriviaSkipper::skipBlanks(p, end, actual.newlines, actual.lastNewline);
+        check("skipBlanks", text, from, referenceBlanks(p, end), actual);
+
+        actual = ScanResult{nullptr, 0, nullptr};
+        actual.stop = TriviaSkipper::findBlockEnd(p, end, actual.newlines, actual.lastNewline);
+        check("findBlockEnd", text, from, referenceBlockEnd(p, end), actual);
+    }
+}
+
+int main()
+{
+    // Bloques de blancos largos para que las búsquedas crucen varios bloques
+    std::mt19937 random(12345);
+    const char alphabet[] = {' ', ' ', ' ', '\t', '\n', '*', '/', 'a'};
+    for (int round = 0; round < 2000; ++round)
+    {
+        size_t length = random() % 100;
+        std::string text;
+        for (size_t i = 0; i < length; ++i)
+        {
+            text += alphabet[random() % sizeof(alphabet)];
+        }
+        compare(text);
+    }
+
+    // El cierre partido en cada posición alrededor de los límites de bloque
+    for (size_t star = 0; star < 70; ++star)
+    {
+        std::string text(star, 'x');
+        text += "*/";
+        text += std::string(8, 'y');
+        compare(text);
+        compare(text.substr(0, star + 1));
+    }
+
+    // Un '*' al final puede empezar el cierre: findBlockEnd devuelve end - 1
+    const std::string tail = "comentario\n*";
+    int newlines = 0;
+    const char *lastNewline = nullptr;
+    const char *stop = TriviaSkipper::findBlockEnd(tail.data(), tail.data() + tail.size(), newlines, lastNewline);
+    if (stop != tail.data() + tail.size() - 1 || newlines != 1)
+    {
+        std::printf("findBlockEnd: a trailing '*' must stay pending\n");
+        ++failures;
+    }
+
+    if (failures > 0)
+    {
+        std::printf("%d mismatches\n", failures);
+        return 1;
+    }
+    return 0;
+}
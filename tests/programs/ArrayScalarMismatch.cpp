@@ -0,0 +1,26 @@
+int g[2];
+
+int take(int v)
+{
+    return v;
+}
+
+int sum(int v[3])
+{
+    return v[0] + v[1];
+}
+
+int main()
+{
+    int a[3];
+    int x;
+    int y;
+    x = a + 1;
+    a = 3;
+    std::cin >> a;
+    y = take(a);
+    y = sum(x);
+    y = sum(a) + take(x) + sum(g) + g;
+    g = 1;
+    return 0;
+}
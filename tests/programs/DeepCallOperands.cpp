@@ -0,0 +1,23 @@
+int y;
+
+int f(int a, int b)
+{
+    y = y + 1;
+    return a * 2 + b;
+}
+
+int g(int a)
+{
+    return a + y;
+}
+
+int main()
+{
+    int x;
+    x = 3;
+    y = 1;
+    std::cout << x + (x + (x + (x + (x + (x + (x + (x + (x + (x + (f(x, f(x, f(x, x))))))))))))) << std::endl;
+    std::cout << y + (y + (y + (y + (y + (y + (y + (y + (y + (y + (y + (y + (g(x) - f(y, f(y, f(y, y))))))))))))))) << std::endl;
+    std::cout << y << std::endl;
+    return 0;
+}
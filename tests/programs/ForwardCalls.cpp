@@ -0,0 +1,44 @@
+int main()
+{
+    int x;
+    int a[3];
+    x = 4;
+    a[1] = 7;
+    bump(x);
+    std::cout << x << " " << twice(x) << " " << second(a) << std::endl;
+    std::cout << isEven(10) << " " << isEven(7) << std::endl;
+    return 0;
+}
+
+int bump(int &r)
+{
+    r = r + twice(r);
+}
+
+int isEven(int n)
+{
+    if (n == 0)
+    {
+        return 1;
+    }
+    return isOdd(n - 1);
+}
+
+int isOdd(int n)
+{
+    if (n == 0)
+    {
+        return 0;
+    }
+    return isEven(n - 1);
+}
+
+int twice(int v)
+{
+    return v * 2;
+}
+
+int second(int v[3])
+{
+    return v[1];
+}
@@ -0,0 +1,20 @@
+int main()
+{
+    int n;
+    int i;
+    int x;
+    int sum;
+    std::cin >> n;
+    sum = 0;
+    i = 0;
+    while (i < n)
+    {
+        std::cin >> x;
+        sum = sum + x;
+        i = i + 1;
+    }
+    std::cout << sum << std::endl;
+    std::cin >> x;
+    std::cout << x << std::endl;
+    return 0;
+}
@@ -0,0 +1,29 @@
+int f(int a, int b, int c, int d, int e)
+{
+    return a + b - c + d - e + 3;
+}
+
+int many(int a, int b, int c, int d, int e, int f2, int g, int h, int i, int j, int k, int l)
+{
+    return a - b + c - d + e - f2 + g - h + i - j + k - l;
+}
+
+int tail(int n, int a, int b, int c, int d, int e)
+{
+    if (n == 0)
+    {
+        return a + b + c + d + e;
+    }
+    return tail(n - 1, a + 1, f(a, b, c, d, f(e, e, e, e, f(a, a, a, a, a))), c, d + b, e);
+}
+
+int main()
+{
+    int x;
+    x = 3;
+    std::cout << f(x, x + 1, f(x, x, f(x, x, x, x, f(x, x, x, x, x)), x, x), x, x) << std::endl;
+    std::cout << many(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12) << std::endl;
+    std::cout << many(x, f(x, x, x, x, x), 3, 4, 5, 6, 7, 8, 9, 10, 11, f(1, 2, 3, 4, many(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, x))) << std::endl;
+    std::cout << tail(5, 1, 2, 3, 4, 5) << std::endl;
+    return 0;
+}
@@ -0,0 +1,21 @@
+int one(int a)
+{
+    int x;
+    std::cin >> x;
+    return x + a;
+}
+
+int three(int a, int b, int c)
+{
+    int x;
+    std::cin >> x;
+    return x * a + b - c;
+}
+
+int main()
+{
+    std::cout << one(1) << std::endl;
+    std::cout << three(2, 5, 3) << std::endl;
+    std::cout << one(three(1, 1, 1)) << std::endl;
+    return 0;
+}